@@ -25,3 +25,77 @@ func prepare():
 ## Must not be called before completion of prepare() call.
 func read_domain(coords: Vector2i) -> WFCBitSet:
 	return null
+
+## Returns a native counterpart of this precondition ([code]WFC2DPreconditionNative[/code]) that
+## evaluates domains of a whole rect at once, or null if there is none and [method read_domain]
+## should be used.
+## [br]
+## Must not be called before completion of prepare() call.
+func create_native_precondition() -> RefCounted:
+	return null
+
+## Returns one byte per cell of [param border_rect] (row-major), 1 where [method read_domain]
+## constrains a cell outside of [param inner_rect]. Edge conditions of native problems are not
+## applied next to such cells ([code]WFC2DProblemNative.set_precondition_border_mask()[/code]).
+## [br]
+## Must not be called before completion of prepare() call.
+func read_border_mask(border_rect: Rect2i, inner_rect: Rect2i) -> PackedByteArray:
+	var mask := PackedByteArray()
+	mask.resize(border_rect.get_area())
+
+	var index := 0
+	for y in range(border_rect.position.y, border_rect.end.y):
+		for x in range(border_rect.position.x, border_rect.end.x):
+			var pos := Vector2i(x, y)
+			if not inner_rect.has_point(pos) and read_domain(pos) != null:
+				mask[index] = 1
+			index += 1
+
+	return mask
+
+## Returns the palette class of [param domain], appending its bitset words to
+## [param palette_words] when no equal domain was added before. Used to pass domains in bulk to
+## [code]set_precondition_domains()[/code] of native problems.
+static func get_domain_class(domain: WFCBitSet, classes_by_words: Dictionary, palette_words: PackedInt64Array) -> int:
+	var words := PackedInt64Array()
+	@warning_ignore("integer_division")
+	for i in range((domain.size + WFCBitSet.BITS_PER_INT - 1) / WFCBitSet.BITS_PER_INT):
+		words.append(domain.get_elem(i))
+
+	if not classes_by_words.has(words):
+		classes_by_words[words] = classes_by_words.size()
+		palette_words.append_array(words)
+
+	return classes_by_words[words]
+
+## Copies [param domain] into a new [code]WFCBitSetNative[/code].
+static func _to_native_domain(domain: WFCBitSet) -> RefCounted:
+	if domain == null:
+		return null
+
+	var native_domain = ClassDB.instantiate("WFCBitSetNative")
+	native_domain.initialize(domain.size, false)
+	for bit in domain.iterator():
+		native_domain.set_bit(bit, true)
+
+	return native_domain
+
+## Reads the tiles of [param node] into a [code]WFC2DPreconditionReadExistingNative[/code].
+static func _read_native_cells(native: RefCounted, node: Node, mapper: WFCMapper2D):
+	native.tile_count = mapper.size()
+
+	if mapper is WFCTilemapLayerMapper2D:
+		native.read_tile_map_layer(node, mapper.attrs_to_id)
+		return
+
+	var rect := mapper.get_used_rect(node)
+	var cells := PackedInt32Array()
+	cells.resize(rect.get_area())
+
+	var index := 0
+	for y in range(rect.position.y, rect.end.y):
+		for x in range(rect.position.x, rect.end.x):
+			cells[index] = mapper.read_cell(node, Vector2i(x, y))
+			index += 1
+
+	native.set_cells(rect, cells)
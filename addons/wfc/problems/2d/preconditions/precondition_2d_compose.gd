@@ -23,3 +23,18 @@ func read_domain(coords: Vector2i) -> WFCBitSet:
 				result = partial_result
 
 	return result
+
+func create_native_precondition() -> RefCounted:
+	if not ClassDB.class_exists("WFC2DPreconditionComposeNative"):
+		return null
+
+	var native_preconditions := []
+	for pc in _preconditions:
+		var native_pc := pc.create_native_precondition()
+		if native_pc == null:
+			return null
+		native_preconditions.append(native_pc)
+
+	var native = ClassDB.instantiate("WFC2DPreconditionComposeNative")
+	native.preconditions = native_preconditions
+	return native
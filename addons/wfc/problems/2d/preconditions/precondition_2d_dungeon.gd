@@ -24,9 +24,19 @@ var passable_area_ratio: float = 0.1
 
 var iterations_limit: int = 1000
 
+## Seed of the layout. Negative value draws a seed from the global RNG.
+var layout_seed: int = -1
+
+## Generate the layout with [code]WFC2DPreconditionDungeonNative[/code] when it's available.
+## Both produce the same layout for the same seed.
+var use_native: bool = true
+
 var rect: Rect2i
 var state: PackedByteArray
 
+var _rng: RandomNumberGenerator
+var _native: RefCounted = null
+
 const STATE_WALL = 0
 const STATE_FREE = 1
 const STATE_PASSAGE = 2
@@ -167,12 +177,12 @@ func _free_space_around(r: Rect2i):
 
 func _generate_room(center: Vector2i) -> int:
 	var mins: Vector2i = center - room_half_size_base - Vector2i(
-		randi_range(-room_half_size_variation.x, room_half_size_variation.x),
-		randi_range(-room_half_size_variation.y, room_half_size_variation.y),
+		_rng.randi_range(-room_half_size_variation.x, room_half_size_variation.x),
+		_rng.randi_range(-room_half_size_variation.y, room_half_size_variation.y),
 	)
 	var maxs: Vector2i = center + room_half_size_base + Vector2i(
-		randi_range(-room_half_size_variation.x, room_half_size_variation.x),
-		randi_range(-room_half_size_variation.y, room_half_size_variation.y),
+		_rng.randi_range(-room_half_size_variation.x, room_half_size_variation.x),
+		_rng.randi_range(-room_half_size_variation.y, room_half_size_variation.y),
 	)
 	var r: Rect2i = Rect2i(mins, Vector2i.ZERO).expand(maxs).intersection(_get_safe_passable_rect())
 
@@ -206,7 +216,7 @@ func _generate(start_point: Vector2i, start_directions: Array[Vector2i]):
 		var gp: _GrowthPoint = growth_points.pop_front()
 		var initial_position: Vector2i = gp.position
 
-		var road_length: int = road_len_base + randi_range(-road_len_variation, road_len_variation)
+		var road_length: int = road_len_base + _rng.randi_range(-road_len_variation, road_len_variation)
 
 		for i in range(road_length):
 			var next_pos: Vector2i = gp.position + gp.direction
@@ -221,23 +231,52 @@ func _generate(start_point: Vector2i, start_directions: Array[Vector2i]):
 		remaining_area -= _replace_rect(road_rect, STATE_WALL, STATE_PASSAGE)
 		remaining_area -= _replace_rect(road_rect, STATE_FREE, STATE_PASSAGE)
 
-		if room_probability > randf():
+		if room_probability > _rng.randf():
 			remaining_area -= _generate_room(gp.position)
 
 		_free_space_around(road_rect)
 
-		if randf() < fork_probability:
+		if _rng.randf() < fork_probability:
 			growth_points.push_back(gp.rotated(true))
 			growth_points.push_back(gp.rotated(false))
-			if randf() < full_fork_probability:
+			if _rng.randf() < full_fork_probability:
 				growth_points.push_back(gp)
 		else:
-			gp.rotate(randf() > 0.5)
+			gp.rotate(_rng.randf() > 0.5)
 			growth_points.push_back(gp)
 
+func _create_native() -> RefCounted:
+	var native = ClassDB.instantiate("WFC2DPreconditionDungeonNative")
+
+	native.tile_count = walls_domain.size
+	native.walls_domain = _to_native_domain(walls_domain)
+	native.passable_domain = _to_native_domain(passable_domain)
+	native.wall_border_size = wall_border_size
+	native.free_gap = free_gap
+	native.room_half_size_base = room_half_size_base
+	native.room_half_size_variation = room_half_size_variation
+	native.room_probability = room_probability
+	native.road_len_base = road_len_base
+	native.road_len_variation = road_len_variation
+	native.fork_probability = fork_probability
+	native.full_fork_probability = full_fork_probability
+	native.passable_area_ratio = passable_area_ratio
+	native.iterations_limit = iterations_limit
+	native.seed = layout_seed if layout_seed >= 0 else randi()
+
+	return native
+
 func prepare():
 	assert(rect.has_area())
 
+	if use_native and ClassDB.class_exists("WFC2DPreconditionDungeonNative"):
+		_native = _create_native()
+		state = _native.generate(rect)
+		return
+
+	_rng = RandomNumberGenerator.new()
+	_rng.seed = layout_seed if layout_seed >= 0 else randi()
+
 	state.resize(rect.get_area())
 
 	_generate(_get_start_point(), [Vector2i.DOWN, Vector2i.UP])
@@ -256,3 +295,6 @@ func read_domain(coords: Vector2i) -> WFCBitSet:
 			return passable_domain
 		_:
 			return null
+
+func create_native_precondition() -> RefCounted:
+	return _native
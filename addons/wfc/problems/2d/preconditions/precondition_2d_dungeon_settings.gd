@@ -62,6 +62,12 @@ var passable_area_ratio: float = 0.1
 @export
 var iterations_limit: int = 1000
 
+## Seed of the generated layout.
+## [br]
+## Negative value draws a new seed from the global RNG on each generation.
+@export
+var layout_seed: int = -1
+
 @export_group("Tile classes")
 ## Name of meta attribute/custom data layer that marks passable tiles.
 @export
@@ -122,5 +128,6 @@ func create_precondition(parameters: WFC2DPrecondition2DNullSettings.CreationPar
 
 	assert(iterations_limit > 0)
 	res.iterations_limit = iterations_limit
+	res.layout_seed = layout_seed
 
 	return res
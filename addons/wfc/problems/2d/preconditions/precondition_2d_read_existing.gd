@@ -24,3 +24,11 @@ func read_domain(coords: Vector2i) -> WFCBitSet:
 	_domain_cache[read] = domain
 
 	return domain
+
+func create_native_precondition() -> RefCounted:
+	if not ClassDB.class_exists("WFC2DPreconditionReadExistingNative"):
+		return null
+
+	var native = ClassDB.instantiate("WFC2DPreconditionReadExistingNative")
+	_read_native_cells(native, _node, _mapper)
+	return native
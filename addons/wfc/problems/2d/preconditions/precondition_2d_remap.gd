@@ -23,3 +23,18 @@ func read_domain(coords: Vector2i) -> WFCBitSet:
 		return _default_domain
 
 	return _domains_map[read]
+
+func create_native_precondition() -> RefCounted:
+	if not ClassDB.class_exists("WFC2DPreconditionRemapNative"):
+		return null
+
+	var native = ClassDB.instantiate("WFC2DPreconditionRemapNative")
+	_read_native_cells(native, _node, _mapper)
+
+	var native_domains := []
+	for domain in _domains_map:
+		native_domains.append(_to_native_domain(domain))
+	native.domains_map = native_domains
+	native.default_domain = _to_native_domain(_default_domain)
+
+	return native
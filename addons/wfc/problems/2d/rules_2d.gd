@@ -73,6 +73,10 @@ var edge_condition_meta_name: String = "wfc_edge"
 func _learn_from(map: Node, positive: bool):
 	var learning_rect: Rect2i = mapper.get_used_rect(map)
 
+	if ClassDB.class_exists("WFCRules2DNative"):
+		_learn_from_native(map, learning_rect, positive)
+		return
+
 	for x in range(learning_rect.position.x, learning_rect.end.x):
 		for y in range(learning_rect.position.y, learning_rect.end.y):
 			var cell_coords: Vector2i = Vector2i(x, y)
@@ -92,6 +96,39 @@ func _learn_from(map: Node, positive: bool):
 
 				axis_matrices[a].set_bit(cell, other_cell, positive)
 
+## Same as [method _learn_from], but reads each cell once and lets
+## [code]WFCRules2DNative.learn_from_grid()[/code] collect the adjacent pairs.
+func _learn_from_native(map: Node, learning_rect: Rect2i, positive: bool):
+	var tiles := PackedInt32Array()
+	tiles.resize(learning_rect.get_area())
+
+	var index := 0
+	for y in range(learning_rect.position.y, learning_rect.end.y):
+		for x in range(learning_rect.position.x, learning_rect.end.x):
+			tiles[index] = mapper.read_cell(map, Vector2i(x, y))
+			index += 1
+
+	var learned = ClassDB.instantiate("WFCRules2DNative")
+	learned.initialize(mapper.size(), axes)
+	learned.learn_from_grid(tiles, learning_rect.size, true)
+
+	@warning_ignore("integer_division")
+	var words_per_row: int = (mapper.size() + WFCBitSet.BITS_PER_INT - 1) / WFCBitSet.BITS_PER_INT
+
+	for a in range(axes.size()):
+		var words: PackedInt64Array = learned.get_axis_matrix_words(a)
+
+		for i in range(words.size()):
+			var word := words[i]
+			if word == 0:
+				continue
+
+			@warning_ignore("integer_division")
+			var other_cell: int = i / words_per_row
+			for b in range(WFCBitSet.BITS_PER_INT):
+				if word & (1 << b):
+					axis_matrices[a].set_bit((i % words_per_row) * WFCBitSet.BITS_PER_INT + b, other_cell, positive)
+
 func _learn_probabilities():
 	var size := mapper.size()
 	probabilities.resize(size)
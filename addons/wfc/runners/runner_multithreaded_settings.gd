@@ -13,6 +13,14 @@ class_name WFCMultithreadedRunnerSettings
 @export
 var max_threads: int = -1
 
+## Scheduling priority of generated sub-problems, higher runs first.
+## [br]
+## Only used by the native runner, where all generators share one pool of worker threads.
+## Can be changed on the running runner via [code]WFCMultithreadedRunnerNative.priority[/code],
+## e.g. to favor the chunk nearest to the player.
+@export
+var priority: int = 0
+
 ## Calculates actual number of allowed threads.
 func get_max_threads() -> int:
 	if max_threads < 1:
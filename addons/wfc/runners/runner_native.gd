@@ -7,11 +7,26 @@ extends WFCSolverRunner
 ## Settings for runner timing.
 var runner_settings: WFCMainThreadRunnerSettings = WFCMainThreadRunnerSettings.new()
 
+## Solve over classes of interchangeable tiles ([code]WFCRulesCompilation2DNative[/code]).
+## Rendered tiles are drawn among members of the solved classes by their probabilities.
+var compile_rules: bool = false
+
+## Also drop tiles without a compatible neighbour in some direction when [member compile_rules]
+## is enabled. Such tiles could still fit on the border of the generated area. Tiles read from
+## the target map are kept.
+var prune_dead_tiles: bool = true
+
 var _native_problem = null  # WFC2DProblemNative
 var _native_solver = null   # WFCSolverNative
 var _gd_problem: WFC2DProblem = null  # Keep for rendering via mapper
 var _interrupted: bool = false
 
+# Set when rules are compiled: tile-space preconditions, used when rendering
+var _compilation = null  # WFCRulesCompilation2DNative
+var _precondition_solutions := PackedInt32Array()
+var _precondition_palette_words := PackedInt64Array()
+var _precondition_domain_classes := PackedInt32Array()
+
 ## See [member WFCSolverRunner.start].
 func start(problem_: WFCProblem):
   assert(not is_started())
@@ -90,51 +105,129 @@ func _convert_problem_to_native(gd_problem: WFC2DProblem):
     axes.append(axis)
   native_rules.initialize(gd_rules.mapper.size(), axes)
 
+  # Matrices are imported whole: native rows hold the same bits as WFCBitMatrix rows
   for axis_idx in range(gd_rules.axis_matrices.size()):
     var matrix = gd_rules.axis_matrices[axis_idx]
+    @warning_ignore("integer_division")
+    var words_per_row: int = (matrix.width + WFCBitSet.BITS_PER_INT - 1) / WFCBitSet.BITS_PER_INT
+    var words := PackedInt64Array()
+    words.resize(matrix.height * words_per_row)
     for i in range(matrix.height):
-      for j in matrix.rows[i].iterator():
-        # Note: matrix.rows[i] contains column indices (j) where bit is set
-        # set_rule(axis, tile1, tile2) stores rows[tile2].set_bit(tile1)
-        # Matrix stores rows[y].bit(x) meaning "x can follow y"
-        # So we need set_rule(axis_idx, j, i, true) - j (column) can follow i (row)
-        native_rules.set_rule(axis_idx, j, i, true)
+      for w in range(words_per_row):
+        words[i * words_per_row + w] = matrix.rows[i].get_elem(w)
+    native_rules.set_axis_matrix_words(axis_idx, words)
 
   # Copy probabilities for weighted selection
   native_rules.set_probabilities_enabled(gd_rules.probabilities_enabled)
   if gd_rules.probabilities_enabled:
     native_rules.set_probabilities(gd_rules.probabilities)
 
+  # Copy edge conditions (applied natively in populate_initial_state)
+  if gd_rules.edge_domain != null:
+    var native_edge_domain = WFCBitSetNative.new()
+    native_edge_domain.initialize(gd_rules.edge_domain.size, false)
+    for bit in gd_rules.edge_domain.iterator():
+      native_edge_domain.set_bit(bit, true)
+    native_rules.set_edge_domain(native_edge_domain)
+
+  _compilation = null
+  _precondition_solutions = PackedInt32Array()
+  _precondition_palette_words = PackedInt64Array()
+  _precondition_domain_classes = PackedInt32Array()
+  if compile_rules:
+    var compilation = WFCRulesCompilation2DNative.new()
+    # Tiles already on the target map stay placeable, or pruning would unfix their cells
+    var fixed_tiles := _collect_fixed_tiles(gd_problem) if prune_dead_tiles else PackedInt32Array()
+    if compilation.compile(native_rules, prune_dead_tiles, fixed_tiles):
+      _compilation = compilation
+      native_rules = compilation.get_rules()
+
   var native_problem = WFC2DProblemNative.new()
   native_problem.initialize(native_rules, gd_problem.rect)
+  native_problem.set_edges_rect(gd_problem.edges_rect)
+  # Drop-in for the GDScript runner: same seed, same map
+  native_problem.set_gdscript_parity(true)
   return native_problem
 
+## Returns the distinct tiles read from the target map within the problem rect.
+func _collect_fixed_tiles(gd_problem: WFC2DProblem) -> PackedInt32Array:
+  var rect = gd_problem.rect
+  var seen := {}
+  for y in range(rect.size.y):
+    for x in range(rect.size.x):
+      var from_map = gd_problem._read_from_target(rect.position + Vector2i(x, y))
+      if from_map >= 0:
+        seen[from_map] = true
+  return PackedInt32Array(seen.keys())
+
 func _setup_preconditions(native_problem, gd_problem: WFC2DProblem):
   # Setup preconditions on native problem BEFORE solver init
-  # The solver's initialize() will call populate_initial_state() which applies these
+  # The solver's initialize() will call populate_initial_state() which applies these.
+  # Cells are collected row-major and passed in bulk, domains as a palette of distinct bitsets.
   var rect = gd_problem.rect
+  var border_rect: Rect2i = native_problem.get_precondition_border_rect()
   var precondition = gd_problem.precondition
 
-  for x in range(rect.size.x):
-    for y in range(rect.size.y):
-      var pos = Vector2i(x, y)
-      var abs_pos = rect.position + pos
-      var cell_id = rect.size.x * y + x
+  var solutions := PackedInt32Array()
+  solutions.resize(rect.get_area())
+  solutions.fill(-1)
+  var domain_classes := PackedInt32Array()
+  domain_classes.resize(rect.get_area())
+  domain_classes.fill(-1)
+  var palette_words := PackedInt64Array()
+  var classes_by_words := {}
+  var has_solutions := false
+
+  # Preconditions with a native counterpart are evaluated over the whole rect at once
+  var native_precondition = precondition.create_native_precondition()
+
+  var index := 0
+  for y in range(rect.size.y):
+    for x in range(rect.size.x):
+      var abs_pos = rect.position + Vector2i(x, y)
 
       # Check for existing tiles from init_read_rects
       var from_map = gd_problem._read_from_target(abs_pos)
       if from_map >= 0:
-        native_problem.set_precondition_solution(cell_id, from_map)
-      else:
+        solutions[index] = from_map
+        has_solutions = true
+      # Domains of fixed cells are kept too, edge conditions are not applied next to them
+      if native_precondition == null:
         # Apply precondition domain
         var domain = precondition.read_domain(abs_pos)
         if domain != null:
-          # Convert WFCBitSet to native format
-          var native_domain = WFCBitSetNative.new()
-          native_domain.initialize(domain.size, false)
-          for bit in domain.iterator():
-            native_domain.set_bit(bit, true)
-          native_problem.set_precondition_domain(cell_id, native_domain)
+          domain_classes[index] = WFC2DPrecondition.get_domain_class(domain, classes_by_words, palette_words)
+      index += 1
+
+  if has_solutions:
+    if _compilation != null:
+      _precondition_solutions = solutions
+      solutions = _compilation.reduce_solutions(solutions)
+    native_problem.set_precondition_solutions(solutions)
+
+  var class_count: int = classes_by_words.size()
+  if native_precondition != null:
+    # Evaluated one ring past the rect, edge conditions are not applied next to constrained cells
+    var precondition_map = native_precondition.evaluate(border_rect)
+    if _compilation == null:
+      precondition_map.apply_to(native_problem)
+      return
+    native_problem.set_precondition_border_mask(precondition_map.get_constrained_mask(border_rect))
+    class_count = precondition_map.get_class_count()
+    @warning_ignore("integer_division")
+    palette_words = precondition_map.get_palette_words((gd_problem.rules.mapper.size() + WFCBitSet.BITS_PER_INT - 1) / WFCBitSet.BITS_PER_INT)
+    domain_classes = precondition_map.get_domain_classes_over(rect)
+  elif gd_problem.rules.edge_domain != null:
+    native_problem.set_precondition_border_mask(precondition.read_border_mask(border_rect, rect))
+
+  if class_count == 0:
+    return
+
+  if _compilation != null:
+    _precondition_palette_words = palette_words
+    _precondition_domain_classes = domain_classes
+    palette_words = _compilation.reduce_palette_words(palette_words, class_count)
+  native_problem.set_precondition_domains(palette_words, domain_classes, class_count)
 
 func _render_to_map():
   var state = _native_solver.get_current_state()
@@ -142,10 +235,24 @@ func _render_to_map():
   var mapper = _gd_problem.rules.mapper
   var rect = _gd_problem.rect
 
+  if _compilation != null:
+    # Expanded in row-major order, the order of the tile-space preconditions
+    solutions = _compilation.expand_solutions(
+      _native_problem.to_row_major(solutions), randi(),
+      _precondition_palette_words, _precondition_domain_classes)
+    for cell_id in range(solutions.size()):
+      var solution = solutions[cell_id]
+      if cell_id < _precondition_solutions.size() and _precondition_solutions[cell_id] >= 0:
+        solution = _precondition_solutions[cell_id]
+      if solution >= 0:
+        @warning_ignore("integer_division")
+        var coord = Vector2i(cell_id % rect.size.x, cell_id / rect.size.x)
+        mapper.write_cell(_gd_problem.map, rect.position + coord, solution)
+    return
+
   for cell_id in range(solutions.size()):
     var solution = solutions[cell_id]
     if solution >= 0:
-      @warning_ignore("integer_division")
-      var coord = Vector2i(cell_id % rect.size.x, cell_id / rect.size.x)
+      var coord = _native_problem.id_to_coord(cell_id)
       var map_coord = coord + rect.position
       mapper.write_cell(_gd_problem.map, map_coord, solution)
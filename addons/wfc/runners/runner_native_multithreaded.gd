@@ -12,7 +12,7 @@ var _native_problems: Array = []  # Array of WFC2DProblemNative
 var _gd_problem: WFC2DProblem = null  # Keep for rendering via mapper
 var _interrupted: bool = false
 var _started: bool = false
-var _needs_final_update: bool = true
+var _finished: bool = false
 
 ## See [member WFCSolverRunner.start].
 func start(problem_: WFCProblem):
@@ -29,12 +29,20 @@ func start(problem_: WFCProblem):
   var sub_problems = native_problem.split(concurrency)
   print("start %d threads -> %d problems" % [concurrency,sub_problems.size()])
   # Setup preconditions on EACH sub-problem (after split)
+  # A native precondition is evaluated once over the whole rect and shared by sub-problems.
+  # The border rect covers neighbours outside the rect, edge conditions are not applied next
+  # to constrained ones.
+  var precondition_map = null
+  if _gd_problem.precondition != null:
+    var native_precondition = _gd_problem.precondition.create_native_precondition()
+    if native_precondition != null:
+      precondition_map = native_precondition.evaluate(native_problem.get_precondition_border_rect())
   _native_problems.clear()
   for i in range(sub_problems.size()):
     var sub = sub_problems[i]
     var native_sub_problem = sub.get_problem()
     # Setup preconditions using absolute coordinates for this sub-problem's rect
-    _setup_preconditions_for_subproblem(native_sub_problem, _gd_problem)
+    _setup_preconditions_for_subproblem(native_sub_problem, _gd_problem, precondition_map)
     _native_problems.append(native_sub_problem)
 
   # Create native settings
@@ -43,26 +51,40 @@ func start(problem_: WFCProblem):
   native_settings.set_force_ac3(solver_settings.force_ac3)
 
   # Create and start native multithreaded runner
+  # Scheduling happens on native worker threads, completion is reported through signals
   _native_runner = WFCMultithreadedRunnerNative.new()
+  _native_runner.task_completed.connect(_on_native_task_completed)
+  _native_runner.task_failed.connect(_on_native_task_failed)
+  _native_runner.all_completed.connect(_on_native_all_completed)
+  _native_runner.priority = runner_settings.priority
   _native_runner.start(sub_problems, native_settings, concurrency)
   _started = true
 
 ## See [member WFCSolverRunner.update].
+## [br]
+## Only reports partial progress, the native runner does not depend on it.
 func update():
-  if not is_started():
+  if not is_running():
     return
+
+  partial_solution.emit(_gd_problem, null)
+
+func _on_native_task_completed(_task_index: int):
   if _interrupted:
     return
+  sub_problem_solved.emit(_gd_problem, null)
 
-  var done = _native_runner.update()
+func _on_native_task_failed(task_index: int):
+  if _interrupted:
+    return
+  push_warning("Native sub-problem %d failed to solve" % task_index)
 
-  if done:
-    _needs_final_update = false
-    _render_all_to_map()
-    sub_problem_solved.emit(_gd_problem, null)
-    all_solved.emit()
-  else:
-    partial_solution.emit(_gd_problem, null)
+func _on_native_all_completed():
+  if _interrupted or _finished:
+    return
+  _finished = true
+  _render_all_to_map()
+  all_solved.emit()
 
 ## See [member WFCSolverRunner.is_running].
 func is_running() -> bool:
@@ -70,14 +92,8 @@ func is_running() -> bool:
     return false
   if _interrupted:
     return false
-  # Check if native runner is still running
-  # Note: We need to keep running until we've processed the completion
-  var native_running = _native_runner.is_running()
-  if not native_running:
-    # Runner finished - check if we need one more update to emit signals
-    # The update() method will handle the final emission
-    return _needs_final_update
-  return true
+  # Keep running until all_completed has been delivered and rendered
+  return not _finished
 
 ## See [member WFCSolverRunner.is_started].
 func is_started() -> bool:
@@ -87,7 +103,8 @@ func is_started() -> bool:
 func interrupt():
   _interrupted = true
   if _native_runner != null:
-    _native_runner.interrupt()
+    # Does not block: workers observe the cancellation inside propagation and exit on their own
+    _native_runner.interrupt_async()
 
 ## See [member WFCSolverRunner.get_progress].
 func get_progress() -> float:
@@ -106,45 +123,73 @@ func _convert_problem_to_native(gd_problem: WFC2DProblem):
     axes.append(axis)
   native_rules.initialize(gd_rules.mapper.size(), axes)
 
+  # Matrices are imported whole: native rows hold the same bits as WFCBitMatrix rows
   for axis_idx in range(gd_rules.axis_matrices.size()):
     var matrix = gd_rules.axis_matrices[axis_idx]
+    @warning_ignore("integer_division")
+    var words_per_row: int = (matrix.width + WFCBitSet.BITS_PER_INT - 1) / WFCBitSet.BITS_PER_INT
+    var words := PackedInt64Array()
+    words.resize(matrix.height * words_per_row)
     for i in range(matrix.height):
-      for j in matrix.rows[i].iterator():
-        # Matrix stores rows[y].bit(x) meaning "x can follow y"
-        # So we need set_rule(axis_idx, j, i, true) - j (column) can follow i (row)
-        native_rules.set_rule(axis_idx, j, i, true)
+      for w in range(words_per_row):
+        words[i * words_per_row + w] = matrix.rows[i].get_elem(w)
+    native_rules.set_axis_matrix_words(axis_idx, words)
 
   # Copy probabilities for weighted selection
   native_rules.set_probabilities_enabled(gd_rules.probabilities_enabled)
   if gd_rules.probabilities_enabled:
     native_rules.set_probabilities(gd_rules.probabilities)
 
+  # Copy edge conditions (applied natively in populate_initial_state)
+  if gd_rules.edge_domain != null:
+    var native_edge_domain = WFCBitSetNative.new()
+    native_edge_domain.initialize(gd_rules.edge_domain.size, false)
+    for bit in gd_rules.edge_domain.iterator():
+      native_edge_domain.set_bit(bit, true)
+    native_rules.set_edge_domain(native_edge_domain)
+
   var native_problem = WFC2DProblemNative.new()
   native_problem.initialize(native_rules, gd_problem.rect)
+  native_problem.set_edges_rect(gd_problem.edges_rect)
+  # Drop-in for the GDScript runner: same seed, same map
+  native_problem.set_gdscript_parity(true)
   return native_problem
 
-func _setup_preconditions_for_subproblem(native_problem, gd_problem: WFC2DProblem):
+func _setup_preconditions_for_subproblem(native_problem, gd_problem: WFC2DProblem, precondition_map = null):
+  if precondition_map != null:
+    precondition_map.apply_to(native_problem)
+    return
+
   # Get this sub-problem's rect (may be different from gd_problem.rect)
   var rect = native_problem.get_rect()
   var precondition = gd_problem.precondition
   if precondition == null:
     return
 
-  for x in range(rect.size.x):
-    for y in range(rect.size.y):
+  # Collected row-major and passed in bulk, domains as a palette of distinct bitsets
+  var domain_classes := PackedInt32Array()
+  domain_classes.resize(rect.get_area())
+  domain_classes.fill(-1)
+  var palette_words := PackedInt64Array()
+  var classes_by_words := {}
+
+  var index := 0
+  for y in range(rect.size.y):
+    for x in range(rect.size.x):
       # Use ABSOLUTE coordinates for precondition query
       var abs_pos = rect.position + Vector2i(x, y)
-      var cell_id = rect.size.x * y + x
 
-      # Apply precondition domain using absolute coordinates
       var domain = precondition.read_domain(abs_pos)
       if domain != null:
-        # Convert WFCBitSet to native format
-        var native_domain = WFCBitSetNative.new()
-        native_domain.initialize(domain.size, false)
-        for bit in domain.iterator():
-          native_domain.set_bit(bit, true)
-        native_problem.set_precondition_domain(cell_id, native_domain)
+        domain_classes[index] = WFC2DPrecondition.get_domain_class(domain, classes_by_words, palette_words)
+      index += 1
+
+  if not classes_by_words.is_empty():
+    native_problem.set_precondition_domains(palette_words, domain_classes, classes_by_words.size())
+
+  if gd_problem.rules.edge_domain != null:
+    var border_rect: Rect2i = native_problem.get_precondition_border_rect()
+    native_problem.set_precondition_border_mask(precondition.read_border_mask(border_rect, rect))
 
 func _render_all_to_map():
   var mapper = _gd_problem.rules.mapper
@@ -181,8 +226,7 @@ func _render_all_to_map():
     for cell_id in range(solutions.size()):
       var solution = solutions[cell_id]
       if solution >= 0:
-        @warning_ignore("integer_division")
-        var local_coord = Vector2i(cell_id % sub_rect.size.x, cell_id / sub_rect.size.x)
+        var local_coord = native_problem.id_to_coord(cell_id)
         var abs_coord = local_coord + sub_rect.position
 
         # Only render if within renderable rect
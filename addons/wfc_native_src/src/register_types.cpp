@@ -3,6 +3,7 @@
 #include <gdextension_interface.h>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
+#include <godot_cpp/classes/engine.hpp>
 
 #include "wfc_bitset_native.h"
 #include "wfc_bitmatrix_native.h"
@@ -13,9 +14,26 @@
 #include "wfc_rules_2d_native.h"
 #include "wfc_2d_problem_native.h"
 #include "wfc_multithreaded_runner_native.h"
+#include "wfc_cancellation_token_native.h"
+#include "wfc_generation_scheduler_native.h"
+#include "wfc_batch_solver_native.h"
+#include "wfc_portfolio_settings_native.h"
+#include "wfc_portfolio_solver_native.h"
+#include "wfc_block_solver_native.h"
+#include "wfc_2d_chunked_world_native.h"
+#include "wfc_tile_store_native.h"
+#include "wfc_2d_precondition_native.h"
+#include "wfc_2d_precondition_dungeon_native.h"
+#include "wfc_rules_compilation_native.h"
+#include "wfc_rules_3d_native.h"
+#include "wfc_3d_problem_native.h"
+#include "wfc_2d_hex_problem_native.h"
+#include "wfc_graph_problem_native.h"
 
 using namespace godot;
 
+static WFCGenerationSchedulerNative* generation_scheduler = nullptr;
+
 void initialize_wfc_solver_native_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
@@ -25,6 +43,7 @@ void initialize_wfc_solver_native_module(ModuleInitializationLevel p_level) {
     ClassDB::register_class<WFCBitMatrixNative>();
     ClassDB::register_class<WFCSolverSettingsNative>();
     ClassDB::register_class<WFCSolverStateNative>();
+    ClassDB::register_class<WFCCancellationTokenNative>();
     ClassDB::register_class<WFCProblemAC4BinaryConstraintNative>();
     ClassDB::register_class<WFCProblemSubProblemNative>();
     ClassDB::register_class<WFCProblemNative>();
@@ -33,12 +52,45 @@ void initialize_wfc_solver_native_module(ModuleInitializationLevel p_level) {
     ClassDB::register_class<WFC2DAC4BinaryConstraintNative>();
     ClassDB::register_class<WFC2DProblemNative>();
     ClassDB::register_class<WFCMultithreadedRunnerNative>();
+    ClassDB::register_abstract_class<WFCGenerationSchedulerNative>();
+    ClassDB::register_class<WFCBatchSolverNative>();
+    ClassDB::register_class<WFCPortfolioSettingsNative>();
+    ClassDB::register_class<WFCPortfolioSolverNative>();
+    ClassDB::register_class<WFCBlockSolverNative>();
+    ClassDB::register_class<WFC2DChunkedWorldNative>();
+    ClassDB::register_class<WFCTileStoreNative>();
+    ClassDB::register_class<WFC2DPreconditionMapNative>();
+    ClassDB::register_class<WFC2DPreconditionNative>();
+    ClassDB::register_class<WFC2DPreconditionReadExistingNative>();
+    ClassDB::register_class<WFC2DPreconditionRemapNative>();
+    ClassDB::register_class<WFC2DPreconditionComposeNative>();
+    ClassDB::register_class<WFC2DPreconditionDungeonNative>();
+    ClassDB::register_class<WFCRulesCompilation2DNative>();
+    ClassDB::register_class<WFCRules3DNative>();
+    ClassDB::register_class<WFC3DAC4BinaryConstraintNative>();
+    ClassDB::register_class<WFC3DProblemNative>();
+    ClassDB::register_class<WFC2DHexAC4BinaryConstraintNative>();
+    ClassDB::register_class<WFC2DHexProblemNative>();
+    ClassDB::register_class<WFCGraphAC4BinaryConstraintNative>();
+    ClassDB::register_class<WFCGraphProblemNative>();
+
+    // Process-wide worker pool shared by all runners
+    generation_scheduler = memnew(WFCGenerationSchedulerNative);
+    Engine::get_singleton()->register_singleton("WFCGenerationSchedulerNative", generation_scheduler);
 }
 
 void uninitialize_wfc_solver_native_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+
+    WFCRules2DNative::clear_binary_cache();
+
+    if (generation_scheduler) {
+        Engine::get_singleton()->unregister_singleton("WFCGenerationSchedulerNative");
+        memdelete(generation_scheduler);
+        generation_scheduler = nullptr;
+    }
 }
 
 extern "C" {
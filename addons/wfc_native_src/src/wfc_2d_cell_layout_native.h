@@ -0,0 +1,73 @@
+#ifndef WFC_2D_CELL_LAYOUT_NATIVE_H
+#define WFC_2D_CELL_LAYOUT_NATIVE_H
+
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <algorithm>
+
+namespace godot {
+
+// Mapping between cell coordinates (relative to the problem rect) and cell ids.
+//
+// ROW_MAJOR: id = y * width + x.
+// TILED: square blocks of TILED_BLOCK_SIZE cells stored one after another (row-major
+// blocks, row-major cells within a block), so vertical neighbours are close in memory.
+class WFC2DCellLayout {
+public:
+    enum Mode {
+        ROW_MAJOR = 0,
+        TILED = 1,
+    };
+
+    static const int TILED_BLOCK_SIZE = 8;
+
+private:
+    Mode mode_ = ROW_MAJOR;
+    Vector2i size_;
+
+public:
+    void configure(const Vector2i& size, Mode mode) {
+        mode_ = mode;
+        size_ = size;
+    }
+
+    Mode get_mode() const { return mode_; }
+    Vector2i get_size() const { return size_; }
+    bool is_row_major() const { return mode_ == ROW_MAJOR; }
+
+    int coord_to_id(const Vector2i& coord) const {
+        switch (mode_) {
+            case TILED: {
+                const int b = TILED_BLOCK_SIZE;
+                int bx = coord.x / b;
+                int by = coord.y / b;
+                int block_w = std::min(b, size_.x - bx * b);
+                int block_h = std::min(b, size_.y - by * b);
+                return by * b * size_.x + bx * b * block_h + (coord.y - by * b) * block_w + (coord.x - bx * b);
+            }
+            default:
+                return size_.x * coord.y + coord.x;
+        }
+    }
+
+    Vector2i id_to_coord(int id) const {
+        switch (mode_) {
+            case TILED: {
+                const int b = TILED_BLOCK_SIZE;
+                int by = id / (b * size_.x);
+                int rest = id - by * b * size_.x;
+                int block_h = std::min(b, size_.y - by * b);
+                int bx = rest / (b * block_h);
+                rest -= bx * b * block_h;
+                int block_w = std::min(b, size_.x - bx * b);
+                return Vector2i(bx * b + rest % block_w, by * b + rest / block_w);
+            }
+            default:
+                return Vector2i(id % size_.x, id / size_.x);
+        }
+    }
+};
+
+} // namespace godot
+
+#endif // WFC_2D_CELL_LAYOUT_NATIVE_H
@@ -0,0 +1,472 @@
+#include "wfc_2d_chunked_world_native.h"
+#include "wfc_solver_native.h"
+#include "wfc_solver_state_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/random_number_generator.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace godot {
+
+void WFC2DChunkedWorldNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "settings"), &WFC2DChunkedWorldNative::initialize, DEFVAL(Ref<WFCSolverSettingsNative>()));
+    ClassDB::bind_method(D_METHOD("get_chunk_rect", "coord"), &WFC2DChunkedWorldNative::get_chunk_rect);
+    ClassDB::bind_method(D_METHOD("request_chunk", "coord"), &WFC2DChunkedWorldNative::request_chunk);
+    ClassDB::bind_method(D_METHOD("request_chunks_around", "center", "radius"), &WFC2DChunkedWorldNative::request_chunks_around);
+    ClassDB::bind_method(D_METHOD("generate_chunk", "coord"), &WFC2DChunkedWorldNative::generate_chunk);
+    ClassDB::bind_method(D_METHOD("get_chunk", "coord"), &WFC2DChunkedWorldNative::get_chunk);
+    ClassDB::bind_method(D_METHOD("has_chunk", "coord"), &WFC2DChunkedWorldNative::has_chunk);
+    ClassDB::bind_method(D_METHOD("wait"), &WFC2DChunkedWorldNative::wait);
+    ClassDB::bind_method(D_METHOD("cancel"), &WFC2DChunkedWorldNative::cancel);
+    ClassDB::bind_method(D_METHOD("clear"), &WFC2DChunkedWorldNative::clear);
+    ClassDB::bind_method(D_METHOD("get_pending_count"), &WFC2DChunkedWorldNative::get_pending_count);
+    ClassDB::bind_method(D_METHOD("get_cached_chunk_count"), &WFC2DChunkedWorldNative::get_cached_chunk_count);
+
+    ClassDB::bind_method(D_METHOD("get_focus"), &WFC2DChunkedWorldNative::get_focus);
+    ClassDB::bind_method(D_METHOD("set_focus", "val"), &WFC2DChunkedWorldNative::set_focus);
+    ClassDB::bind_method(D_METHOD("get_chunk_size"), &WFC2DChunkedWorldNative::get_chunk_size);
+    ClassDB::bind_method(D_METHOD("set_chunk_size", "val"), &WFC2DChunkedWorldNative::set_chunk_size);
+    ClassDB::bind_method(D_METHOD("get_cache_capacity"), &WFC2DChunkedWorldNative::get_cache_capacity);
+    ClassDB::bind_method(D_METHOD("set_cache_capacity", "val"), &WFC2DChunkedWorldNative::set_cache_capacity);
+    ClassDB::bind_method(D_METHOD("get_spill_directory"), &WFC2DChunkedWorldNative::get_spill_directory);
+    ClassDB::bind_method(D_METHOD("set_spill_directory", "val"), &WFC2DChunkedWorldNative::set_spill_directory);
+    ClassDB::bind_method(D_METHOD("get_seed"), &WFC2DChunkedWorldNative::get_seed);
+    ClassDB::bind_method(D_METHOD("set_seed", "val"), &WFC2DChunkedWorldNative::set_seed);
+    ClassDB::bind_method(D_METHOD("get_chunk_attempts"), &WFC2DChunkedWorldNative::get_chunk_attempts);
+    ClassDB::bind_method(D_METHOD("set_chunk_attempts", "val"), &WFC2DChunkedWorldNative::set_chunk_attempts);
+    ClassDB::bind_method(D_METHOD("get_max_concurrent_chunks"), &WFC2DChunkedWorldNative::get_max_concurrent_chunks);
+    ClassDB::bind_method(D_METHOD("set_max_concurrent_chunks", "val"), &WFC2DChunkedWorldNative::set_max_concurrent_chunks);
+    ClassDB::bind_method(D_METHOD("get_priority"), &WFC2DChunkedWorldNative::get_priority);
+    ClassDB::bind_method(D_METHOD("set_priority", "val"), &WFC2DChunkedWorldNative::set_priority);
+    ClassDB::bind_method(D_METHOD("get_settings"), &WFC2DChunkedWorldNative::get_settings);
+    ClassDB::bind_method(D_METHOD("set_settings", "val"), &WFC2DChunkedWorldNative::set_settings);
+
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "focus"), "set_focus", "get_focus");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "chunk_size"), "set_chunk_size", "get_chunk_size");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "cache_capacity"), "set_cache_capacity", "get_cache_capacity");
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "spill_directory", PROPERTY_HINT_GLOBAL_DIR), "set_spill_directory", "get_spill_directory");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "chunk_attempts"), "set_chunk_attempts", "get_chunk_attempts");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_concurrent_chunks"), "set_max_concurrent_chunks", "get_max_concurrent_chunks");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "settings", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverSettingsNative"), "set_settings", "get_settings");
+
+    ADD_SIGNAL(MethodInfo("chunk_generated", PropertyInfo(Variant::VECTOR2I, "coord")));
+    ADD_SIGNAL(MethodInfo("chunk_failed", PropertyInfo(Variant::VECTOR2I, "coord")));
+}
+
+WFC2DChunkedWorldNative::WFC2DChunkedWorldNative() {
+    cancellation_token_.instantiate();
+}
+
+WFC2DChunkedWorldNative::~WFC2DChunkedWorldNative() {
+    cancel();
+}
+
+void WFC2DChunkedWorldNative::initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings) {
+    ERR_FAIL_COND(rules.is_null());
+
+    cancel();
+
+    // Template rect is irrelevant, chunk problems take their own rect in initialize_from()
+    template_problem_.instantiate();
+    template_problem_->initialize(rules, Rect2i());
+    dependencies_range_ = template_problem_->get_dependencies_range();
+
+    settings_ = settings;
+    if (settings_.is_null()) {
+        settings_.instantiate();
+    }
+}
+
+int64_t WFC2DChunkedWorldNative::make_key(const Vector2i& coord) {
+    return (static_cast<int64_t>(coord.x) << 32) | static_cast<uint32_t>(coord.y);
+}
+
+static Vector2i key_to_coord(int64_t key) {
+    return Vector2i(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xffffffff));
+}
+
+String WFC2DChunkedWorldNative::get_spill_path(const Vector2i& coord) const {
+    return spill_directory_.path_join(String::num_int64(coord.x) + "_" + String::num_int64(coord.y) + ".chunk");
+}
+
+Rect2i WFC2DChunkedWorldNative::get_chunk_rect(const Vector2i& coord) const {
+    return Rect2i(coord * chunk_size_, chunk_size_);
+}
+
+bool WFC2DChunkedWorldNative::is_neighbour_in_flight(const Vector2i& coord) const {
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (in_flight_.count(make_key(coord + Vector2i(dx, dy)))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+PackedInt64Array WFC2DChunkedWorldNative::find_chunk_locked(const Vector2i& coord) {
+    int64_t key = make_key(coord);
+
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+        return it->second.solution;
+    }
+
+    if (!spilled_.count(key)) {
+        return PackedInt64Array();
+    }
+
+    Ref<FileAccess> file = FileAccess::open(get_spill_path(coord), FileAccess::READ);
+    ERR_FAIL_COND_V_MSG(file.is_null(), PackedInt64Array(), "Cannot read spilled chunk");
+
+    // Files of other versions or chunk sizes are regenerated
+    int64_t cell_count = (int64_t)chunk_size_.x * chunk_size_.y;
+    bool valid = (int64_t)file->get_length() == SPILL_HEADER_SIZE + cell_count * (int64_t)sizeof(int64_t) &&
+                 file->get_32() == SPILL_MAGIC && file->get_32() == SPILL_VERSION &&
+                 (int32_t)file->get_32() == chunk_size_.x && (int32_t)file->get_32() == chunk_size_.y;
+    if (!valid) {
+        spilled_.erase(key);
+        ERR_FAIL_V_MSG(PackedInt64Array(), "Spilled chunk does not match this world, it will be generated again");
+    }
+
+    PackedByteArray bytes = file->get_buffer(cell_count * sizeof(int64_t));
+    PackedInt64Array solution;
+    solution.resize(cell_count);
+    memcpy(solution.ptrw(), bytes.ptr(), solution.size() * sizeof(int64_t));
+
+    store_chunk_locked(coord, solution);
+    return solution;
+}
+
+void WFC2DChunkedWorldNative::store_chunk_locked(const Vector2i& coord, const PackedInt64Array& solution) {
+    int64_t key = make_key(coord);
+
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        it->second.solution = solution;
+        lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    } else {
+        lru_.push_front(key);
+        cache_[key] = CachedChunk{ solution, lru_.begin() };
+    }
+
+    while (static_cast<int>(cache_.size()) > std::max(cache_capacity_, 1)) {
+        int64_t evicted_key = lru_.back();
+        lru_.pop_back();
+
+        if (!spill_directory_.is_empty()) {
+            DirAccess::make_dir_recursive_absolute(spill_directory_);
+            Ref<FileAccess> file = FileAccess::open(get_spill_path(key_to_coord(evicted_key)), FileAccess::WRITE);
+
+            if (file.is_valid()) {
+                const PackedInt64Array& evicted = cache_[evicted_key].solution;
+                PackedByteArray bytes;
+                bytes.resize(evicted.size() * sizeof(int64_t));
+                memcpy(bytes.ptrw(), evicted.ptr(), bytes.size());
+                file->store_32(SPILL_MAGIC);
+                file->store_32(SPILL_VERSION);
+                file->store_32(chunk_size_.x);
+                file->store_32(chunk_size_.y);
+                file->store_buffer(bytes);
+                spilled_.insert(evicted_key);
+            } else {
+                ERR_PRINT("Cannot spill chunk, it will be generated again when needed");
+            }
+        }
+
+        cache_.erase(evicted_key);
+    }
+}
+
+void WFC2DChunkedWorldNative::dispatch_chunks_locked() {
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    if (!scheduler) {
+        return;
+    }
+
+    int limit = max_concurrent_chunks_ > 0 ? max_concurrent_chunks_ : scheduler->get_max_workers();
+
+    while (static_cast<int>(in_flight_.size()) < limit) {
+        // Nearest chunk to the focus whose neighbours are not being generated
+        int best = -1;
+        int64_t best_distance = 0;
+        for (int i = 0; i < static_cast<int>(pending_.size()); i++) {
+            if (is_neighbour_in_flight(pending_[i])) {
+                continue;
+            }
+
+            int64_t distance = (pending_[i] - focus_).length_squared();
+            if (best < 0 || distance < best_distance) {
+                best = i;
+                best_distance = distance;
+            }
+        }
+
+        if (best < 0) {
+            break;
+        }
+
+        Vector2i coord = pending_[best];
+        int64_t key = make_key(coord);
+        pending_.erase(pending_.begin() + best);
+        pending_keys_.erase(key);
+
+        // Generated by generate_chunk() in the meantime
+        if (cache_.count(key) || spilled_.count(key)) {
+            continue;
+        }
+
+        auto job = std::make_shared<WFCGenerationSchedulerNative::Job>();
+        job->priority.store(priority_);
+        job->run_slice = [this, coord](WFCGenerationSchedulerNative::Job&) {
+            // A chunk is small enough to be solved in one slice
+            run_chunk(coord);
+            return true;
+        };
+        // Dropped by a shutting down scheduler, the chunk stays ungenerated
+        job->abandon = [this, key](WFCGenerationSchedulerNative::Job&) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_.erase(key);
+            idle_condition_.notify_all();
+        };
+
+        if (!scheduler->submit(job)) {
+            // Nothing will ever run, forget the remaining requests too
+            pending_.clear();
+            pending_keys_.clear();
+            idle_condition_.notify_all();
+            break;
+        }
+
+        // The job takes the lock held here before it can finish or be abandoned
+        in_flight_[key] = job;
+    }
+}
+
+PackedInt64Array WFC2DChunkedWorldNative::solve_chunk(const Vector2i& coord, bool& solved) {
+    solved = false;
+
+    Rect2i chunk_rect = get_chunk_rect(coord);
+    Rect2i problem_rect = chunk_rect.grow_individual(dependencies_range_.x, dependencies_range_.y,
+                                                     dependencies_range_.x, dependencies_range_.y);
+
+    // Copy neighbour solutions under the lock, blit them without it
+    std::vector<std::pair<Rect2i, PackedInt64Array>> neighbours;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                Vector2i other = coord + Vector2i(dx, dy);
+                if (other == coord) {
+                    continue;
+                }
+
+                PackedInt64Array solution = find_chunk_locked(other);
+                if (!solution.is_empty()) {
+                    neighbours.emplace_back(get_chunk_rect(other), solution);
+                }
+            }
+        }
+    }
+
+    Ref<WFC2DProblemNative> problem;
+    problem.instantiate();
+    problem->initialize_from(template_problem_, problem_rect);
+    for (const auto& neighbour : neighbours) {
+        problem->blit_precondition_solutions(neighbour.first, neighbour.second, problem_rect);
+    }
+
+    Ref<RandomNumberGenerator> rng;
+    rng.instantiate();
+    problem->set_rng(rng);
+
+    Ref<WFCSolverNative> solver;
+    solver.instantiate();
+    solver->set_cancellation_token(cancellation_token_);
+
+    PackedInt64Array result;
+    const uint64_t coord_hash = static_cast<uint64_t>(make_key(coord)) * 0xBF58476D1CE4E5B9ULL;
+
+    for (int attempt = 0; attempt < std::max(chunk_attempts_, 1); attempt++) {
+        rng->set_seed((static_cast<uint64_t>(seed_) * 0x9E3779B97F4A7C15ULL) ^ coord_hash ^ static_cast<uint64_t>(attempt));
+
+        solver->initialize(problem, settings_);
+        Ref<WFCSolverStateNative> state = solver->solve();
+
+        if (solver->is_cancelled()) {
+            return PackedInt64Array();
+        }
+        if (state.is_null()) {
+            continue;
+        }
+
+        // Only the chunk itself is kept, the border belongs to the neighbours
+        PackedInt64Array cells = problem->to_row_major(state->get_cell_solution_or_entropy());
+        result.resize(chunk_rect.get_area());
+        int64_t* dst = result.ptrw();
+        bool failed = false;
+
+        for (int y = 0; y < chunk_rect.size.y; y++) {
+            const int64_t* row = cells.ptr() + (int64_t)(y + dependencies_range_.y) * problem_rect.size.x + dependencies_range_.x;
+            for (int x = 0; x < chunk_rect.size.x; x++) {
+                int64_t solution = row[x];
+                failed = failed || solution < 0 || solution == WFCSolverStateNative::CELL_SOLUTION_FAILED;
+                *dst++ = solution;
+            }
+        }
+
+        if (!failed) {
+            solved = true;
+            break;
+        }
+    }
+
+    return result;
+}
+
+void WFC2DChunkedWorldNative::run_chunk(const Vector2i& coord) {
+    bool solved = false;
+    PackedInt64Array solution = solve_chunk(coord, solved);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_flight_.erase(make_key(coord));
+
+    if (!solution.is_empty()) {
+        store_chunk_locked(coord, solution);
+        call_deferred("emit_signal", solved ? "chunk_generated" : "chunk_failed", coord);
+    }
+
+    dispatch_chunks_locked();
+
+    // Notify under the lock: the waiting thread may destroy this object
+    idle_condition_.notify_all();
+}
+
+void WFC2DChunkedWorldNative::request_chunk(const Vector2i& coord) {
+    ERR_FAIL_COND_MSG(template_problem_.is_null(), "WFC2DChunkedWorldNative is not initialized");
+
+    int64_t key = make_key(coord);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_.count(key) || spilled_.count(key) || in_flight_.count(key) || pending_keys_.count(key)) {
+        return;
+    }
+
+    pending_.push_back(coord);
+    pending_keys_.insert(key);
+    dispatch_chunks_locked();
+}
+
+void WFC2DChunkedWorldNative::request_chunks_around(const Vector2i& center, int radius) {
+    for (int dy = -radius; dy <= radius; dy++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            request_chunk(center + Vector2i(dx, dy));
+        }
+    }
+}
+
+PackedInt64Array WFC2DChunkedWorldNative::generate_chunk(const Vector2i& coord) {
+    ERR_FAIL_COND_V_MSG(template_problem_.is_null(), PackedInt64Array(), "WFC2DChunkedWorldNative is not initialized");
+
+    int64_t key = make_key(coord);
+    {
+        // Neighbours being generated would change the border under our feet
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_condition_.wait(lock, [&]() { return !is_neighbour_in_flight(coord); });
+
+        PackedInt64Array existing = find_chunk_locked(coord);
+        if (!existing.is_empty()) {
+            return existing;
+        }
+
+        if (pending_keys_.erase(key)) {
+            pending_.erase(std::find(pending_.begin(), pending_.end(), coord));
+        }
+        in_flight_[key] = nullptr;
+    }
+
+    run_chunk(coord);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find_chunk_locked(coord);
+}
+
+PackedInt64Array WFC2DChunkedWorldNative::get_chunk(const Vector2i& coord) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find_chunk_locked(coord);
+}
+
+bool WFC2DChunkedWorldNative::has_chunk(const Vector2i& coord) {
+    int64_t key = make_key(coord);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.count(key) || spilled_.count(key);
+}
+
+void WFC2DChunkedWorldNative::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_condition_.wait(lock, [this]() { return pending_.empty() && in_flight_.empty(); });
+}
+
+void WFC2DChunkedWorldNative::cancel() {
+    cancellation_token_->cancel();
+
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_.clear();
+    pending_keys_.clear();
+
+    // Jobs still waiting in the scheduler queue are dropped right away, only running ones
+    // are waited for
+    for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+        if (it->second && scheduler && scheduler->remove(it->second)) {
+            it = in_flight_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    idle_condition_.notify_all();
+    idle_condition_.wait(lock, [this]() { return in_flight_.empty(); });
+
+    // Nothing runs anymore, later chunks get a fresh token
+    cancellation_token_.instantiate();
+}
+
+void WFC2DChunkedWorldNative::clear() {
+    cancel();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int64_t key : spilled_) {
+        DirAccess::remove_absolute(get_spill_path(key_to_coord(key)));
+    }
+    spilled_.clear();
+    cache_.clear();
+    lru_.clear();
+}
+
+int WFC2DChunkedWorldNative::get_pending_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(pending_.size() + in_flight_.size());
+}
+
+int WFC2DChunkedWorldNative::get_cached_chunk_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(cache_.size());
+}
+
+Vector2i WFC2DChunkedWorldNative::get_focus() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return focus_;
+}
+
+void WFC2DChunkedWorldNative::set_focus(const Vector2i& val) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    focus_ = val;
+}
+
+} // namespace godot
@@ -0,0 +1,159 @@
+#ifndef WFC_2D_CHUNKED_WORLD_NATIVE_H
+#define WFC_2D_CHUNKED_WORLD_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include "wfc_2d_problem_native.h"
+#include "wfc_rules_2d_native.h"
+#include "wfc_solver_settings_native.h"
+#include "wfc_cancellation_token_native.h"
+#include "wfc_generation_scheduler_native.h"
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace godot {
+
+// Unbounded 2D world generated in fixed-size chunks.
+//
+// Every chunk is solved as its own WFC2DProblemNative, grown by the dependency range of
+// the rules so that solved cells of neighbouring chunks become its border preconditions.
+// Requested chunks are generated on WFCGenerationSchedulerNative workers, nearest to the
+// focus first; neighbouring chunks never generate at the same time. Solutions are kept in
+// an LRU cache of cache_capacity chunks, evicted chunks are written to spill_directory
+// (when set) and read back on demand.
+//
+// A chunk only sees neighbours generated before it, so its content depends on the order
+// in which chunks were requested, not just on the seed and its coordinate.
+class WFC2DChunkedWorldNative : public RefCounted {
+    GDCLASS(WFC2DChunkedWorldNative, RefCounted)
+
+private:
+    // Spill file: magic, version, chunk width and height (uint32 each), then the cells
+    static constexpr uint32_t SPILL_MAGIC = 0x4B434657; // "WFCK"
+    static constexpr uint32_t SPILL_VERSION = 1;
+    static constexpr int64_t SPILL_HEADER_SIZE = 16;
+
+    struct CachedChunk {
+        PackedInt64Array solution;
+        std::list<int64_t>::iterator lru_position;
+    };
+
+    Ref<WFC2DProblemNative> template_problem_;
+    Ref<WFCSolverSettingsNative> settings_;
+    Ref<WFCCancellationTokenNative> cancellation_token_;
+    Vector2i dependencies_range_;
+
+    Vector2i chunk_size_ = Vector2i(32, 32);
+    int cache_capacity_ = 256;
+    String spill_directory_;
+    int64_t seed_ = 0;
+    int chunk_attempts_ = 3;
+    int max_concurrent_chunks_ = 0;
+    int priority_ = 0;
+
+    // Guards everything below
+    std::mutex mutex_;
+    std::condition_variable idle_condition_;
+    std::unordered_map<int64_t, CachedChunk> cache_;
+    std::list<int64_t> lru_;  // Most recently used first
+    std::unordered_set<int64_t> spilled_;
+    std::vector<Vector2i> pending_;
+    std::unordered_set<int64_t> pending_keys_;
+    // Chunks being generated, with their scheduler job (null when generated inline)
+    std::unordered_map<int64_t, WFCGenerationSchedulerNative::JobPtr> in_flight_;
+    Vector2i focus_;
+
+    static int64_t make_key(const Vector2i& coord);
+    String get_spill_path(const Vector2i& coord) const;
+
+    // Caller must hold mutex_
+    bool is_neighbour_in_flight(const Vector2i& coord) const;
+    PackedInt64Array find_chunk_locked(const Vector2i& coord);
+    void store_chunk_locked(const Vector2i& coord, const PackedInt64Array& solution);
+    void dispatch_chunks_locked();
+
+    // Solves one chunk against the cached solutions of its neighbours
+    PackedInt64Array solve_chunk(const Vector2i& coord, bool& solved);
+
+    // Runs on a worker: solve, store, signal and dispatch more chunks
+    void run_chunk(const Vector2i& coord);
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFC2DChunkedWorldNative();
+    ~WFC2DChunkedWorldNative();
+
+    void initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings = Ref<WFCSolverSettingsNative>());
+
+    // Rect of a chunk in world cells
+    Rect2i get_chunk_rect(const Vector2i& coord) const;
+
+    // Queue chunks for generation on worker threads. Emits chunk_generated or chunk_failed per chunk.
+    void request_chunk(const Vector2i& coord);
+    void request_chunks_around(const Vector2i& center, int radius);
+
+    // Generate a chunk on the calling thread (or wait for a worker generating it) and return it
+    PackedInt64Array generate_chunk(const Vector2i& coord);
+
+    // Solutions of a chunk laid out row-major over get_chunk_rect(), empty when not generated yet
+    PackedInt64Array get_chunk(const Vector2i& coord);
+    bool has_chunk(const Vector2i& coord);
+
+    // Block until no chunk is pending or being generated
+    void wait();
+
+    // Drop pending and queued chunks and stop the ones being generated, keeping the cache.
+    // Waits only for chunks already running.
+    void cancel();
+
+    // Forget all chunks, including spilled ones
+    void clear();
+
+    int get_pending_count();
+    int get_cached_chunk_count();
+
+    // Chunks closer to the focus (in chunk coordinates) are generated first
+    Vector2i get_focus();
+    void set_focus(const Vector2i& val);
+
+    Vector2i get_chunk_size() const { return chunk_size_; }
+    void set_chunk_size(const Vector2i& val) { chunk_size_ = val; }
+
+    // Chunks kept in memory
+    int get_cache_capacity() const { return cache_capacity_; }
+    void set_cache_capacity(int val) { cache_capacity_ = val; }
+
+    // Evicted chunks are stored here when not empty
+    String get_spill_directory() const { return spill_directory_; }
+    void set_spill_directory(const String& val) { spill_directory_ = val; }
+
+    // Chunk seeds are derived from this seed and the chunk coordinate
+    int64_t get_seed() const { return seed_; }
+    void set_seed(int64_t val) { seed_ = val; }
+
+    // Solving attempts with different seeds before a chunk is kept with failed cells
+    int get_chunk_attempts() const { return chunk_attempts_; }
+    void set_chunk_attempts(int val) { chunk_attempts_ = val; }
+
+    // Chunks generated at the same time, 0 = number of scheduler workers
+    int get_max_concurrent_chunks() const { return max_concurrent_chunks_; }
+    void set_max_concurrent_chunks(int val) { max_concurrent_chunks_ = val; }
+
+    int get_priority() const { return priority_; }
+    void set_priority(int val) { priority_ = val; }
+
+    Ref<WFCSolverSettingsNative> get_settings() const { return settings_; }
+    void set_settings(const Ref<WFCSolverSettingsNative>& val) { settings_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_2D_CHUNKED_WORLD_NATIVE_H
@@ -0,0 +1,23 @@
+#include "wfc_2d_hex_layout_native.h"
+
+namespace godot {
+
+void WFC2DHexLayout::configure(OffsetAxis offset_axis, int offset_parity) {
+    // E, W, SE, NW, SW, NE of a row that is not shifted, then of a shifted one
+    static const int table[2][DIRECTION_COUNT][2] = {
+        { { 1, 0 }, { -1, 0 }, { 0, 1 }, { -1, -1 }, { -1, 1 }, { 0, -1 } },
+        { { 1, 0 }, { -1, 0 }, { 1, 1 }, { 0, -1 }, { 0, 1 }, { 1, -1 } },
+    };
+
+    offset_axis_ = offset_axis;
+    offset_parity_ = offset_parity & 1;
+
+    for (int shifted = 0; shifted < 2; shifted++) {
+        for (int d = 0; d < DIRECTION_COUNT; d++) {
+            const int* o = table[shifted][d];
+            offsets_[shifted][d] = offset_axis_ == OFFSET_AXIS_HORIZONTAL ? Vector2i(o[0], o[1]) : Vector2i(o[1], o[0]);
+        }
+    }
+}
+
+} // namespace godot
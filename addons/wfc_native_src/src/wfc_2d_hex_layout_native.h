@@ -0,0 +1,57 @@
+#ifndef WFC_2D_HEX_LAYOUT_NATIVE_H
+#define WFC_2D_HEX_LAYOUT_NATIVE_H
+
+#include <godot_cpp/variant/vector2i.hpp>
+
+namespace godot {
+
+// Neighbours of hex cells in offset coordinates, as used by hexagonal TileSets.
+//
+// With OFFSET_AXIS_HORIZONTAL every other row is shifted by half a cell towards +X, with
+// OFFSET_AXIS_VERTICAL every other column towards +Y. offset_parity 0 shifts odd rows
+// (columns), as TileSet.TILE_LAYOUT_STACKED does; 1 shifts even ones (TILE_LAYOUT_STACKED_OFFSET).
+//
+// Directions come in forward/reverse pairs, direction d * 2 + 1 being the opposite of d * 2,
+// the same order as axes of WFC2DProblemNative. For horizontal offset these are
+// E, W, SE, NW, SW, NE; vertical offset uses the same table with X and Y swapped.
+// Parity is taken from absolute coordinates, so offsets of sub-rects stay consistent.
+class WFC2DHexLayout {
+public:
+    enum OffsetAxis {
+        OFFSET_AXIS_HORIZONTAL = 0,
+        OFFSET_AXIS_VERTICAL = 1,
+    };
+
+    static const int AXIS_COUNT = 3;
+    static const int DIRECTION_COUNT = AXIS_COUNT * 2;
+
+private:
+    OffsetAxis offset_axis_ = OFFSET_AXIS_HORIZONTAL;
+    int offset_parity_ = 0;
+
+    // [0] for rows (columns) that are not shifted, [1] for shifted ones
+    Vector2i offsets_[2][DIRECTION_COUNT];
+
+public:
+    WFC2DHexLayout() { configure(OFFSET_AXIS_HORIZONTAL, 0); }
+
+    void configure(OffsetAxis offset_axis, int offset_parity);
+
+    OffsetAxis get_offset_axis() const { return offset_axis_; }
+    int get_offset_parity() const { return offset_parity_; }
+
+    bool is_shifted(const Vector2i& abs_pos) const {
+        int c = offset_axis_ == OFFSET_AXIS_HORIZONTAL ? abs_pos.y : abs_pos.x;
+        return ((c & 1) ^ offset_parity_) != 0;
+    }
+
+    const Vector2i* get_offsets(const Vector2i& abs_pos) const { return offsets_[is_shifted(abs_pos) ? 1 : 0]; }
+
+    Vector2i get_neighbour(const Vector2i& abs_pos, int direction) const {
+        return abs_pos + get_offsets(abs_pos)[direction];
+    }
+};
+
+} // namespace godot
+
+#endif // WFC_2D_HEX_LAYOUT_NATIVE_H
@@ -0,0 +1,221 @@
+#include "wfc_2d_hex_problem_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <algorithm>
+
+namespace godot {
+
+// WFC2DHexAC4BinaryConstraintNative implementation
+
+void WFC2DHexAC4BinaryConstraintNative::_bind_methods() {
+}
+
+WFC2DHexAC4BinaryConstraintNative::WFC2DHexAC4BinaryConstraintNative() {
+}
+
+WFC2DHexAC4BinaryConstraintNative::~WFC2DHexAC4BinaryConstraintNative() {
+}
+
+void WFC2DHexAC4BinaryConstraintNative::initialize(int direction, const Rect2i& rect, const WFC2DHexLayout& hex,
+                                                   const WFC2DCellLayout& layout, const TypedArray<PackedInt64Array>& supports) {
+    direction_ = direction;
+    rect_ = rect;
+    hex_ = hex;
+    layout_ = layout;
+    allowed_tiles_ = supports;
+}
+
+int WFC2DHexAC4BinaryConstraintNative::get_neighbour_id(int cell_id, int direction) const {
+    Vector2i other = hex_.get_neighbour(layout_.id_to_coord(cell_id) + rect_.position, direction);
+    if (!rect_.has_point(other)) {
+        return -1;
+    }
+    return layout_.coord_to_id(other - rect_.position);
+}
+
+int WFC2DHexAC4BinaryConstraintNative::get_dependent(int cell_id) {
+    // Opposite direction leads back to the cell that has this one as dependency
+    return get_neighbour_id(cell_id, direction_ ^ 1);
+}
+
+int WFC2DHexAC4BinaryConstraintNative::get_dependency(int cell_id) {
+    return get_neighbour_id(cell_id, direction_);
+}
+
+PackedInt64Array WFC2DHexAC4BinaryConstraintNative::get_allowed(int dependency_variant) {
+    if (dependency_variant >= 0 && dependency_variant < allowed_tiles_.size()) {
+        return allowed_tiles_[dependency_variant];
+    }
+    return PackedInt64Array();
+}
+
+// WFC2DHexProblemNative implementation
+
+void WFC2DHexProblemNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "rect"), &WFC2DHexProblemNative::initialize);
+
+    ClassDB::bind_method(D_METHOD("get_offset_axis"), &WFC2DHexProblemNative::get_offset_axis);
+    ClassDB::bind_method(D_METHOD("set_offset_axis", "val"), &WFC2DHexProblemNative::set_offset_axis);
+
+    ClassDB::bind_method(D_METHOD("get_offset_parity"), &WFC2DHexProblemNative::get_offset_parity);
+    ClassDB::bind_method(D_METHOD("set_offset_parity", "val"), &WFC2DHexProblemNative::set_offset_parity);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "offset_axis", PROPERTY_HINT_ENUM, "Horizontal,Vertical"), "set_offset_axis", "get_offset_axis");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "offset_parity", PROPERTY_HINT_ENUM, "Odd,Even"), "set_offset_parity", "get_offset_parity");
+
+    BIND_CONSTANT(OFFSET_AXIS_HORIZONTAL);
+    BIND_CONSTANT(OFFSET_AXIS_VERTICAL);
+}
+
+WFC2DHexProblemNative::WFC2DHexProblemNative() {
+}
+
+WFC2DHexProblemNative::~WFC2DHexProblemNative() {
+}
+
+void WFC2DHexProblemNative::initialize(const Ref<WFCRules2DNative>& rules, const Rect2i& rect) {
+    ERR_FAIL_COND(rules.is_null());
+    ERR_FAIL_COND_MSG(rules->get_axes().size() != WFC2DHexLayout::AXIS_COUNT, "Hex problems need rules with three axes");
+
+    WFC2DProblemNative::initialize(rules, rect);
+    reset_axes();
+    hex_ac4_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
+}
+
+void WFC2DHexProblemNative::reset_axes() {
+    // Offsets of cells in rows (columns) that are not shifted, for the dependency range
+    // and for scripts; neighbours are always looked up in hex_
+    axes_ = TypedArray<Vector2i>();
+    const Vector2i* offsets = hex_.get_offsets(hex_.get_offset_axis() == WFC2DHexLayout::OFFSET_AXIS_HORIZONTAL
+        ? Vector2i(0, hex_.get_offset_parity()) : Vector2i(hex_.get_offset_parity(), 0));
+    for (int d = 0; d < WFC2DHexLayout::DIRECTION_COUNT; d++) {
+        axes_.append(offsets[d]);
+    }
+}
+
+void WFC2DHexProblemNative::set_offset_axis(int val) {
+    ERR_FAIL_COND(val < OFFSET_AXIS_HORIZONTAL || val > OFFSET_AXIS_VERTICAL);
+    hex_.configure(static_cast<WFC2DHexLayout::OffsetAxis>(val), hex_.get_offset_parity());
+    reset_axes();
+    hex_ac4_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
+}
+
+void WFC2DHexProblemNative::set_offset_parity(int val) {
+    hex_.configure(hex_.get_offset_axis(), val);
+    reset_axes();
+    hex_ac4_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
+}
+
+Vector2i WFC2DHexProblemNative::get_neighbour(const Vector2i& abs_pos, int direction) const {
+    return hex_.get_neighbour(abs_pos, direction);
+}
+
+Ref<WFC2DProblemNative> WFC2DHexProblemNative::create_sub_problem(const Rect2i& rect) {
+    Ref<WFC2DHexProblemNative> problem;
+    problem.instantiate();
+    problem->hex_ = hex_;
+    problem->initialize_from(Ref<WFC2DProblemNative>(this), rect);
+    problem->hex_ac4_cache_ = hex_ac4_cache_;
+    problem->hex_ac4_cache_rect_ = hex_ac4_cache_rect_;
+    problem->hex_ac4_cache_layout_ = hex_ac4_cache_layout_;
+    return problem;
+}
+
+Vector2i WFC2DHexProblemNative::get_split_influence_range() const {
+    TypedArray<WFCBitMatrixNative> matrices = rules_->get_axis_matrices();
+    int longest_path = 0;
+
+    for (int a = 0; a < matrices.size(); a++) {
+        Ref<WFCBitMatrixNative> matrix = matrices[a];
+        int forward_path = matrix->get_longest_path();
+        int backward_path = forward_path > 0 ? rules_->get_transposed_matrix(a)->get_longest_path() : 0;
+
+        if (forward_path <= 0 || backward_path <= 0) {
+            return Vector2i(WFCRules2DNative::MAX_INT_32, WFCRules2DNative::MAX_INT_32);
+        }
+        longest_path = std::max(longest_path, std::max(forward_path, backward_path));
+    }
+
+    return Vector2i(longest_path, longest_path);
+}
+
+Ref<WFCBitSetNative> WFC2DHexProblemNative::compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) {
+    TypedArray<WFCBitSetNative> cell_domains = state->get_cell_domains();
+    Ref<WFCBitSetNative> current_domain = cell_domains[cell_id];
+    Ref<WFCBitSetNative> res = current_domain->copy();
+
+    Vector2i abs_pos = id_to_coord(cell_id) + rect_.position;
+    const Vector2i* offsets = hex_.get_offsets(abs_pos);
+
+    for (int i = 0; i < axis_matrices_.size(); i++) {
+        Vector2i other_pos = abs_pos + offsets[i];
+
+        if (!rect_.has_point(other_pos)) {
+            continue;
+        }
+
+        int other_id = coord_to_id(other_pos - rect_.position);
+
+        if (state->get_cell_solution(other_id) == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+            continue;
+        }
+
+        Ref<WFCBitSetNative> other_domain = cell_domains[other_id];
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+        res->intersect_in_place(matrix->transform(other_domain));
+    }
+
+    return res;
+}
+
+void WFC2DHexProblemNative::mark_related_cells(int changed_cell_id, const Callable& mark_cell) {
+    Vector2i abs_pos = id_to_coord(changed_cell_id) + rect_.position;
+    const Vector2i* offsets = hex_.get_offsets(abs_pos);
+
+    for (int i = 0; i < WFC2DHexLayout::DIRECTION_COUNT; i++) {
+        Vector2i other_pos = abs_pos + offsets[i];
+        if (rect_.has_point(other_pos)) {
+            mark_cell.call(coord_to_id(other_pos - rect_.position));
+        }
+    }
+}
+
+PackedInt64Array WFC2DHexProblemNative::get_related_cells(int changed_cell_id) {
+    PackedInt64Array result;
+    Vector2i abs_pos = id_to_coord(changed_cell_id) + rect_.position;
+    const Vector2i* offsets = hex_.get_offsets(abs_pos);
+
+    for (int i = 0; i < WFC2DHexLayout::DIRECTION_COUNT; i++) {
+        Vector2i other_pos = abs_pos + offsets[i];
+        if (rect_.has_point(other_pos)) {
+            result.append(coord_to_id(other_pos - rect_.position));
+        }
+    }
+
+    return result;
+}
+
+TypedArray<WFCProblemAC4BinaryConstraintNative> WFC2DHexProblemNative::get_ac4_binary_constraints() {
+    // Constraints only depend on size and parity of the rect position
+    Rect2i key(Vector2i(rect_.position.x & 1, rect_.position.y & 1), rect_.size);
+    if (!hex_ac4_cache_.is_empty() && hex_ac4_cache_rect_ == key && hex_ac4_cache_layout_ == cell_layout_) {
+        return hex_ac4_cache_;
+    }
+
+    TypedArray<WFCProblemAC4BinaryConstraintNative> constraints;
+
+    for (int i = 0; i < axis_matrices_.size(); i++) {
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+
+        Ref<WFC2DHexAC4BinaryConstraintNative> constraint;
+        constraint.instantiate();
+        constraint->initialize(i, key, hex_, layout_, rules_->get_supports(matrix));
+        constraints.append(constraint);
+    }
+
+    hex_ac4_cache_ = constraints;
+    hex_ac4_cache_rect_ = key;
+    hex_ac4_cache_layout_ = cell_layout_;
+    return constraints;
+}
+
+} // namespace godot
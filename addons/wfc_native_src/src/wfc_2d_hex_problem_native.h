@@ -0,0 +1,92 @@
+#ifndef WFC_2D_HEX_PROBLEM_NATIVE_H
+#define WFC_2D_HEX_PROBLEM_NATIVE_H
+
+#include "wfc_2d_hex_layout_native.h"
+#include "wfc_2d_problem_native.h"
+
+namespace godot {
+
+// AC4 Binary Constraint along one hex direction, neighbours depend on row (column) parity
+class WFC2DHexAC4BinaryConstraintNative : public WFCProblemAC4BinaryConstraintNative {
+    GDCLASS(WFC2DHexAC4BinaryConstraintNative, WFCProblemAC4BinaryConstraintNative)
+
+private:
+    int direction_ = 0;
+    Rect2i rect_;
+    WFC2DHexLayout hex_;
+    WFC2DCellLayout layout_;
+    TypedArray<PackedInt64Array> allowed_tiles_;
+
+    int get_neighbour_id(int cell_id, int direction) const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFC2DHexAC4BinaryConstraintNative();
+    ~WFC2DHexAC4BinaryConstraintNative();
+
+    // Cells of rect (same size as the problem rect, position of the same parity) decide
+    // neighbour offsets, cell ids follow layout
+    void initialize(int direction, const Rect2i& rect, const WFC2DHexLayout& hex, const WFC2DCellLayout& layout,
+                    const TypedArray<PackedInt64Array>& supports);
+
+    virtual int get_dependent(int cell_id) override;
+    virtual int get_dependency(int cell_id) override;
+    virtual PackedInt64Array get_allowed(int dependency_variant) override;
+};
+
+// WFC2DProblemNative over a hex map in offset coordinates. Rules need exactly three axes,
+// matrix of axis a holding the rules of hex directions a * 2 (forward) and a * 2 + 1
+// (transposed), see WFC2DHexLayout for the direction order. The axis vectors of the rules
+// are not used; WFCRules2DNative::learn_from_hex_grid() learns matching rules.
+class WFC2DHexProblemNative : public WFC2DProblemNative {
+    GDCLASS(WFC2DHexProblemNative, WFC2DProblemNative)
+
+public:
+    enum OffsetAxis {
+        OFFSET_AXIS_HORIZONTAL = WFC2DHexLayout::OFFSET_AXIS_HORIZONTAL,
+        OFFSET_AXIS_VERTICAL = WFC2DHexLayout::OFFSET_AXIS_VERTICAL,
+    };
+
+private:
+    WFC2DHexLayout hex_;
+
+    // AC4 constraints also depend on parity of the rect position, the key rect holds it
+    TypedArray<WFCProblemAC4BinaryConstraintNative> hex_ac4_cache_;
+    Rect2i hex_ac4_cache_rect_;
+    int hex_ac4_cache_layout_ = CELL_LAYOUT_ROW_MAJOR;
+
+    void reset_axes();
+
+protected:
+    static void _bind_methods();
+
+    virtual Vector2i get_neighbour(const Vector2i& abs_pos, int direction) const override;
+    virtual Ref<WFC2DProblemNative> create_sub_problem(const Rect2i& rect) override;
+    // A hex step moves at most one cell along X and Y, so the range is the longest
+    // path (in steps) of any direction on both axes
+    virtual Vector2i get_split_influence_range() const override;
+
+public:
+    WFC2DHexProblemNative();
+    ~WFC2DHexProblemNative();
+
+    void initialize(const Ref<WFCRules2DNative>& rules, const Rect2i& rect);
+
+    int get_offset_axis() const { return hex_.get_offset_axis(); }
+    void set_offset_axis(int val);
+
+    // 0: odd rows (columns) are shifted, 1: even ones
+    int get_offset_parity() const { return hex_.get_offset_parity(); }
+    void set_offset_parity(int val);
+
+    virtual Ref<WFCBitSetNative> compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) override;
+    virtual void mark_related_cells(int changed_cell_id, const Callable& mark_cell) override;
+    virtual PackedInt64Array get_related_cells(int changed_cell_id) override;
+    virtual TypedArray<WFCProblemAC4BinaryConstraintNative> get_ac4_binary_constraints() override;
+};
+
+} // namespace godot
+
+#endif // WFC_2D_HEX_PROBLEM_NATIVE_H
@@ -0,0 +1,229 @@
+#include "wfc_2d_precondition_dungeon_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <deque>
+
+namespace godot {
+
+void WFC2DPreconditionDungeonNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("generate", "rect"), &WFC2DPreconditionDungeonNative::generate);
+    ClassDB::bind_method(D_METHOD("get_rect"), &WFC2DPreconditionDungeonNative::get_rect);
+    ClassDB::bind_method(D_METHOD("get_state"), &WFC2DPreconditionDungeonNative::get_state);
+
+    ClassDB::bind_method(D_METHOD("get_walls_domain"), &WFC2DPreconditionDungeonNative::get_walls_domain);
+    ClassDB::bind_method(D_METHOD("set_walls_domain", "val"), &WFC2DPreconditionDungeonNative::set_walls_domain);
+    ClassDB::bind_method(D_METHOD("get_passable_domain"), &WFC2DPreconditionDungeonNative::get_passable_domain);
+    ClassDB::bind_method(D_METHOD("set_passable_domain", "val"), &WFC2DPreconditionDungeonNative::set_passable_domain);
+    ClassDB::bind_method(D_METHOD("get_wall_border_size"), &WFC2DPreconditionDungeonNative::get_wall_border_size);
+    ClassDB::bind_method(D_METHOD("set_wall_border_size", "val"), &WFC2DPreconditionDungeonNative::set_wall_border_size);
+    ClassDB::bind_method(D_METHOD("get_free_gap"), &WFC2DPreconditionDungeonNative::get_free_gap);
+    ClassDB::bind_method(D_METHOD("set_free_gap", "val"), &WFC2DPreconditionDungeonNative::set_free_gap);
+    ClassDB::bind_method(D_METHOD("get_room_half_size_base"), &WFC2DPreconditionDungeonNative::get_room_half_size_base);
+    ClassDB::bind_method(D_METHOD("set_room_half_size_base", "val"), &WFC2DPreconditionDungeonNative::set_room_half_size_base);
+    ClassDB::bind_method(D_METHOD("get_room_half_size_variation"), &WFC2DPreconditionDungeonNative::get_room_half_size_variation);
+    ClassDB::bind_method(D_METHOD("set_room_half_size_variation", "val"), &WFC2DPreconditionDungeonNative::set_room_half_size_variation);
+    ClassDB::bind_method(D_METHOD("get_room_probability"), &WFC2DPreconditionDungeonNative::get_room_probability);
+    ClassDB::bind_method(D_METHOD("set_room_probability", "val"), &WFC2DPreconditionDungeonNative::set_room_probability);
+    ClassDB::bind_method(D_METHOD("get_road_len_base"), &WFC2DPreconditionDungeonNative::get_road_len_base);
+    ClassDB::bind_method(D_METHOD("set_road_len_base", "val"), &WFC2DPreconditionDungeonNative::set_road_len_base);
+    ClassDB::bind_method(D_METHOD("get_road_len_variation"), &WFC2DPreconditionDungeonNative::get_road_len_variation);
+    ClassDB::bind_method(D_METHOD("set_road_len_variation", "val"), &WFC2DPreconditionDungeonNative::set_road_len_variation);
+    ClassDB::bind_method(D_METHOD("get_fork_probability"), &WFC2DPreconditionDungeonNative::get_fork_probability);
+    ClassDB::bind_method(D_METHOD("set_fork_probability", "val"), &WFC2DPreconditionDungeonNative::set_fork_probability);
+    ClassDB::bind_method(D_METHOD("get_full_fork_probability"), &WFC2DPreconditionDungeonNative::get_full_fork_probability);
+    ClassDB::bind_method(D_METHOD("set_full_fork_probability", "val"), &WFC2DPreconditionDungeonNative::set_full_fork_probability);
+    ClassDB::bind_method(D_METHOD("get_passable_area_ratio"), &WFC2DPreconditionDungeonNative::get_passable_area_ratio);
+    ClassDB::bind_method(D_METHOD("set_passable_area_ratio", "val"), &WFC2DPreconditionDungeonNative::set_passable_area_ratio);
+    ClassDB::bind_method(D_METHOD("get_iterations_limit"), &WFC2DPreconditionDungeonNative::get_iterations_limit);
+    ClassDB::bind_method(D_METHOD("set_iterations_limit", "val"), &WFC2DPreconditionDungeonNative::set_iterations_limit);
+    ClassDB::bind_method(D_METHOD("get_seed"), &WFC2DPreconditionDungeonNative::get_seed);
+    ClassDB::bind_method(D_METHOD("set_seed", "val"), &WFC2DPreconditionDungeonNative::set_seed);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "walls_domain", PROPERTY_HINT_RESOURCE_TYPE, "WFCBitSetNative"), "set_walls_domain", "get_walls_domain");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "passable_domain", PROPERTY_HINT_RESOURCE_TYPE, "WFCBitSetNative"), "set_passable_domain", "get_passable_domain");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "wall_border_size"), "set_wall_border_size", "get_wall_border_size");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "free_gap"), "set_free_gap", "get_free_gap");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "room_half_size_base"), "set_room_half_size_base", "get_room_half_size_base");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "room_half_size_variation"), "set_room_half_size_variation", "get_room_half_size_variation");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "room_probability"), "set_room_probability", "get_room_probability");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "road_len_base"), "set_road_len_base", "get_road_len_base");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "road_len_variation"), "set_road_len_variation", "get_road_len_variation");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "fork_probability"), "set_fork_probability", "get_fork_probability");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "full_fork_probability"), "set_full_fork_probability", "get_full_fork_probability");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "passable_area_ratio"), "set_passable_area_ratio", "get_passable_area_ratio");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "iterations_limit"), "set_iterations_limit", "get_iterations_limit");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+
+    BIND_CONSTANT(STATE_WALL);
+    BIND_CONSTANT(STATE_FREE);
+    BIND_CONSTANT(STATE_PASSAGE);
+}
+
+WFC2DPreconditionDungeonNative::WFC2DPreconditionDungeonNative() {
+    rng_.instantiate();
+}
+
+WFC2DPreconditionDungeonNative::~WFC2DPreconditionDungeonNative() {
+}
+
+void WFC2DPreconditionDungeonNative::GrowthPoint::rotate(bool reverse) {
+    direction = Vector2i(direction.y, -direction.x);
+
+    if (reverse) {
+        direction = -direction;
+    }
+}
+
+int WFC2DPreconditionDungeonNative::replace_rect(const Rect2i& r, uint8_t from, uint8_t to) {
+    int replaced_area = 0;
+    uint8_t* state = state_.ptrw();
+
+    for (int y = r.position.y; y < r.get_end().y; y++) {
+        int64_t offy = (int64_t)(y - rect_.position.y) * rect_.size.x;
+        for (int x = r.position.x; x < r.get_end().x; x++) {
+            int64_t off = offy + x - rect_.position.x;
+            if (state[off] == from) {
+                state[off] = to;
+                replaced_area++;
+            }
+        }
+    }
+
+    return replaced_area;
+}
+
+Rect2i WFC2DPreconditionDungeonNative::get_safe_free_rect() const {
+    return rect_.grow_individual(
+            -wall_border_size_.x, -wall_border_size_.y,
+            -wall_border_size_.x, -wall_border_size_.y);
+}
+
+Rect2i WFC2DPreconditionDungeonNative::get_safe_passable_rect() const {
+    return get_safe_free_rect().grow_individual(
+            -free_gap_.x, -free_gap_.y,
+            -free_gap_.x, -free_gap_.y);
+}
+
+void WFC2DPreconditionDungeonNative::free_space_around(const Rect2i& r) {
+    replace_rect(
+            r.grow_individual(free_gap_.x, free_gap_.y, free_gap_.x, free_gap_.y).intersection(get_safe_free_rect()),
+            STATE_WALL, STATE_FREE);
+}
+
+int WFC2DPreconditionDungeonNative::generate_room(const Vector2i& center) {
+    // Drawn one by one to keep the GDScript call order
+    int min_x = rng_->randi_range(-room_half_size_variation_.x, room_half_size_variation_.x);
+    int min_y = rng_->randi_range(-room_half_size_variation_.y, room_half_size_variation_.y);
+    int max_x = rng_->randi_range(-room_half_size_variation_.x, room_half_size_variation_.x);
+    int max_y = rng_->randi_range(-room_half_size_variation_.y, room_half_size_variation_.y);
+
+    Vector2i mins = center - room_half_size_base_ - Vector2i(min_x, min_y);
+    Vector2i maxs = center + room_half_size_base_ + Vector2i(max_x, max_y);
+    Rect2i r = Rect2i(mins, Vector2i()).expand(maxs).intersection(get_safe_passable_rect());
+
+    int area = replace_rect(r, STATE_WALL, STATE_PASSAGE);
+
+    free_space_around(r);
+
+    return area;
+}
+
+PackedByteArray WFC2DPreconditionDungeonNative::generate(const Rect2i& rect) {
+    ERR_FAIL_COND_V_MSG(!rect.has_area(), PackedByteArray(), "Dungeon rect must have an area");
+
+    rect_ = rect;
+    state_.resize(rect.get_area());
+    state_.fill(STATE_WALL);
+
+    Rect2i passable_rect = get_safe_passable_rect();
+    ERR_FAIL_COND_V_MSG(!passable_rect.has_area(), state_, "Rect too small for wall_border_size and free_gap");
+    ERR_FAIL_COND_V(passable_area_ratio_ <= 0.0 || passable_area_ratio_ >= 1.0, state_);
+
+    rng_->set_seed(static_cast<uint64_t>(seed_ >= 0 ? seed_ : UtilityFunctions::randi()));
+
+    Vector2i start_point = passable_rect.position + passable_rect.size / 2;
+
+    std::deque<GrowthPoint> growth_points;
+    growth_points.push_back({ start_point, Vector2i(0, 1) });
+    growth_points.push_back({ start_point, Vector2i(0, -1) });
+
+    int64_t remaining_area = static_cast<int64_t>(passable_area_ratio_ * passable_rect.get_area());
+    int remaining_iterations = iterations_limit_;
+
+    remaining_area -= generate_room(start_point);
+
+    while (remaining_area > 0 && remaining_iterations > 0) {
+        remaining_iterations--;
+
+        GrowthPoint gp = growth_points.front();
+        growth_points.pop_front();
+        Vector2i initial_position = gp.position;
+
+        int road_length = road_len_base_ + rng_->randi_range(-road_len_variation_, road_len_variation_);
+
+        for (int i = 0; i < road_length; i++) {
+            Vector2i next_pos = gp.position + gp.direction;
+
+            if (!passable_rect.has_point(next_pos)) {
+                break;
+            }
+
+            gp.position = next_pos;
+        }
+
+        Rect2i road_rect = Rect2i(initial_position, Vector2i(1, 1)).expand(gp.position);
+
+        remaining_area -= replace_rect(road_rect, STATE_WALL, STATE_PASSAGE);
+        remaining_area -= replace_rect(road_rect, STATE_FREE, STATE_PASSAGE);
+
+        if (room_probability_ > rng_->randf()) {
+            remaining_area -= generate_room(gp.position);
+        }
+
+        free_space_around(road_rect);
+
+        if (rng_->randf() < fork_probability_) {
+            GrowthPoint reversed = gp;
+            reversed.rotate(true);
+            GrowthPoint forward = gp;
+            forward.rotate(false);
+            growth_points.push_back(reversed);
+            growth_points.push_back(forward);
+            if (rng_->randf() < full_fork_probability_) {
+                growth_points.push_back(gp);
+            }
+        } else {
+            gp.rotate(rng_->randf() > 0.5);
+            growth_points.push_back(gp);
+        }
+    }
+
+    return state_;
+}
+
+void WFC2DPreconditionDungeonNative::evaluate_into(WFC2DPreconditionMapNative& map) {
+    if (map.get_rect() != rect_ || state_.size() != rect_.get_area()) {
+        generate(map.get_rect());
+    }
+
+    int32_t walls_class = walls_domain_.is_valid() ? map.add_class(walls_domain_) : -1;
+    int32_t passable_class = passable_domain_.is_valid() ? map.add_class(passable_domain_) : -1;
+
+    const uint8_t* src = state_.ptr();
+    int32_t* dst = map.get_domain_classes_ptrw();
+    for (int64_t i = 0; i < state_.size(); i++) {
+        switch (src[i]) {
+            case STATE_WALL:
+                dst[i] = walls_class;
+                break;
+            case STATE_PASSAGE:
+                dst[i] = passable_class;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+} // namespace godot
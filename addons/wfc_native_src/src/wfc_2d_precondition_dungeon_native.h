@@ -0,0 +1,124 @@
+#ifndef WFC_2D_PRECONDITION_DUNGEON_NATIVE_H
+#define WFC_2D_PRECONDITION_DUNGEON_NATIVE_H
+
+#include <godot_cpp/classes/random_number_generator.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include "wfc_2d_precondition_native.h"
+
+namespace godot {
+
+// Native port of WFC2DPreconditionDungeon. Draws random numbers in the same order as the
+// GDScript version, so both carve the same layout for the same seed.
+class WFC2DPreconditionDungeonNative : public WFC2DPreconditionNative {
+    GDCLASS(WFC2DPreconditionDungeonNative, WFC2DPreconditionNative)
+
+public:
+    enum CellState {
+        STATE_WALL = 0,
+        STATE_FREE = 1,
+        STATE_PASSAGE = 2,
+    };
+
+private:
+    Ref<WFCBitSetNative> walls_domain_;
+    Ref<WFCBitSetNative> passable_domain_;
+
+    Vector2i wall_border_size_ = Vector2i(1, 2);
+    Vector2i free_gap_ = Vector2i(2, 2);
+
+    Vector2i room_half_size_base_ = Vector2i(2, 2);
+    Vector2i room_half_size_variation_ = Vector2i(2, 2);
+    double room_probability_ = 0.5;
+
+    int road_len_base_ = 15;
+    int road_len_variation_ = 5;
+    double fork_probability_ = 0.5;
+    double full_fork_probability_ = 0.5;
+
+    double passable_area_ratio_ = 0.1;
+
+    int iterations_limit_ = 1000;
+
+    int64_t seed_ = -1;
+
+    // Layout of the last generate() call
+    Rect2i rect_;
+    PackedByteArray state_;
+    Ref<RandomNumberGenerator> rng_;
+
+    struct GrowthPoint {
+        Vector2i position;
+        Vector2i direction;
+
+        void rotate(bool reverse);
+    };
+
+    int replace_rect(const Rect2i& r, uint8_t from, uint8_t to);
+    Rect2i get_safe_free_rect() const;
+    Rect2i get_safe_passable_rect() const;
+    void free_space_around(const Rect2i& r);
+    int generate_room(const Vector2i& center);
+
+protected:
+    static void _bind_methods();
+
+    virtual void evaluate_into(WFC2DPreconditionMapNative& map) override;
+
+public:
+    WFC2DPreconditionDungeonNative();
+    ~WFC2DPreconditionDungeonNative();
+
+    // Carves a layout over rect, one CellState per cell (row-major). Reused by evaluate()
+    // for the same rect.
+    PackedByteArray generate(const Rect2i& rect);
+
+    Rect2i get_rect() const { return rect_; }
+    PackedByteArray get_state() const { return state_; }
+
+    Ref<WFCBitSetNative> get_walls_domain() const { return walls_domain_; }
+    void set_walls_domain(const Ref<WFCBitSetNative>& val) { walls_domain_ = val; }
+
+    Ref<WFCBitSetNative> get_passable_domain() const { return passable_domain_; }
+    void set_passable_domain(const Ref<WFCBitSetNative>& val) { passable_domain_ = val; }
+
+    Vector2i get_wall_border_size() const { return wall_border_size_; }
+    void set_wall_border_size(const Vector2i& val) { wall_border_size_ = val; }
+
+    Vector2i get_free_gap() const { return free_gap_; }
+    void set_free_gap(const Vector2i& val) { free_gap_ = val; }
+
+    Vector2i get_room_half_size_base() const { return room_half_size_base_; }
+    void set_room_half_size_base(const Vector2i& val) { room_half_size_base_ = val; }
+
+    Vector2i get_room_half_size_variation() const { return room_half_size_variation_; }
+    void set_room_half_size_variation(const Vector2i& val) { room_half_size_variation_ = val; }
+
+    double get_room_probability() const { return room_probability_; }
+    void set_room_probability(double val) { room_probability_ = val; }
+
+    int get_road_len_base() const { return road_len_base_; }
+    void set_road_len_base(int val) { road_len_base_ = val; }
+
+    int get_road_len_variation() const { return road_len_variation_; }
+    void set_road_len_variation(int val) { road_len_variation_ = val; }
+
+    double get_fork_probability() const { return fork_probability_; }
+    void set_fork_probability(double val) { fork_probability_ = val; }
+
+    double get_full_fork_probability() const { return full_fork_probability_; }
+    void set_full_fork_probability(double val) { full_fork_probability_ = val; }
+
+    double get_passable_area_ratio() const { return passable_area_ratio_; }
+    void set_passable_area_ratio(double val) { passable_area_ratio_ = val; }
+
+    int get_iterations_limit() const { return iterations_limit_; }
+    void set_iterations_limit(int val) { iterations_limit_ = val; }
+
+    // Negative = seed drawn from the global RNG on each generate()
+    int64_t get_seed() const { return seed_; }
+    void set_seed(int64_t val) { seed_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_2D_PRECONDITION_DUNGEON_NATIVE_H
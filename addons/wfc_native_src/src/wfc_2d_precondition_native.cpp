@@ -0,0 +1,323 @@
+#include "wfc_2d_precondition_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/vector4i.hpp>
+
+#include <unordered_map>
+
+namespace godot {
+
+// WFC2DPreconditionMapNative implementation
+
+void WFC2DPreconditionMapNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rect"), &WFC2DPreconditionMapNative::initialize);
+    ClassDB::bind_method(D_METHOD("add_class", "domain"), &WFC2DPreconditionMapNative::add_class);
+    ClassDB::bind_method(D_METHOD("get_domain", "pos"), &WFC2DPreconditionMapNative::get_domain);
+    ClassDB::bind_method(D_METHOD("apply_to", "problem"), &WFC2DPreconditionMapNative::apply_to);
+    ClassDB::bind_method(D_METHOD("get_domain_classes_over", "rect"), &WFC2DPreconditionMapNative::get_domain_classes_over);
+    ClassDB::bind_method(D_METHOD("get_constrained_mask", "rect"), &WFC2DPreconditionMapNative::get_constrained_mask);
+    ClassDB::bind_method(D_METHOD("get_palette_words", "words_per_domain"), &WFC2DPreconditionMapNative::get_palette_words);
+    ClassDB::bind_method(D_METHOD("get_rect"), &WFC2DPreconditionMapNative::get_rect);
+    ClassDB::bind_method(D_METHOD("get_domain_classes"), &WFC2DPreconditionMapNative::get_domain_classes);
+    ClassDB::bind_method(D_METHOD("get_palette"), &WFC2DPreconditionMapNative::get_palette);
+    ClassDB::bind_method(D_METHOD("get_class_count"), &WFC2DPreconditionMapNative::get_class_count);
+}
+
+WFC2DPreconditionMapNative::WFC2DPreconditionMapNative() {
+}
+
+WFC2DPreconditionMapNative::~WFC2DPreconditionMapNative() {
+}
+
+void WFC2DPreconditionMapNative::initialize(const Rect2i& rect) {
+    rect_ = rect;
+    domain_classes_.resize(rect.get_area());
+    domain_classes_.fill(-1);
+    palette_ = TypedArray<WFCBitSetNative>();
+}
+
+int WFC2DPreconditionMapNative::add_class(const Ref<WFCBitSetNative>& domain) {
+    palette_.append(domain);
+    return static_cast<int>(palette_.size()) - 1;
+}
+
+Ref<WFCBitSetNative> WFC2DPreconditionMapNative::get_domain(const Vector2i& pos) const {
+    if (!rect_.has_point(pos)) {
+        return Ref<WFCBitSetNative>();
+    }
+
+    Vector2i local = pos - rect_.position;
+    int32_t domain_class = domain_classes_[(int64_t)local.y * rect_.size.x + local.x];
+    if (domain_class < 0) {
+        return Ref<WFCBitSetNative>();
+    }
+    return palette_[domain_class];
+}
+
+void WFC2DPreconditionMapNative::apply_to(const Ref<WFC2DProblemNative>& problem) const {
+    ERR_FAIL_COND(problem.is_null());
+
+    int class_count = static_cast<int>(palette_.size());
+    if (class_count == 0) {
+        return;
+    }
+
+    // All palette domains are stored with the word count of the largest one
+    int words_per_domain = 1;
+    for (int c = 0; c < class_count; c++) {
+        Ref<WFCBitSetNative> domain = palette_[c];
+        words_per_domain = std::max(words_per_domain, static_cast<int>((domain->get_size() + WFCBitSetNative::BITS_PER_INT - 1) / WFCBitSetNative::BITS_PER_INT));
+    }
+
+    PackedInt64Array words = get_palette_words(words_per_domain);
+
+    problem->set_precondition_domains(words, get_domain_classes_over(problem->get_rect()), class_count);
+    problem->set_precondition_border_mask(get_constrained_mask(problem->get_precondition_border_rect()));
+}
+
+PackedInt32Array WFC2DPreconditionMapNative::get_domain_classes_over(const Rect2i& rect) const {
+    if (rect == rect_) {
+        return domain_classes_;
+    }
+
+    PackedInt32Array classes;
+    classes.resize(rect.get_area());
+    classes.fill(-1);
+
+    Rect2i overlap = rect.intersection(rect_);
+    int32_t* classes_ptr = classes.ptrw();
+    for (int y = overlap.position.y; y < overlap.get_end().y; y++) {
+        const int32_t* src = domain_classes_.ptr() + (int64_t)(y - rect_.position.y) * rect_.size.x + (overlap.position.x - rect_.position.x);
+        int32_t* row = classes_ptr + (int64_t)(y - rect.position.y) * rect.size.x + (overlap.position.x - rect.position.x);
+        std::copy(src, src + overlap.size.x, row);
+    }
+
+    return classes;
+}
+
+PackedByteArray WFC2DPreconditionMapNative::get_constrained_mask(const Rect2i& rect) const {
+    PackedInt32Array classes = get_domain_classes_over(rect);
+
+    PackedByteArray mask;
+    mask.resize(classes.size());
+    const int32_t* src = classes.ptr();
+    uint8_t* dst = mask.ptrw();
+    for (int64_t i = 0; i < classes.size(); i++) {
+        dst[i] = src[i] >= 0 ? 1 : 0;
+    }
+
+    return mask;
+}
+
+PackedInt64Array WFC2DPreconditionMapNative::get_palette_words(int words_per_domain) const {
+    PackedInt64Array words;
+    words.resize((int64_t)palette_.size() * words_per_domain);
+    int64_t* dst = words.ptrw();
+
+    for (int64_t c = 0; c < palette_.size(); c++) {
+        Ref<WFCBitSetNative> domain = palette_[c];
+        const int domain_words = static_cast<int>((domain->get_size() + WFCBitSetNative::BITS_PER_INT - 1) / WFCBitSetNative::BITS_PER_INT);
+        for (int w = 0; w < words_per_domain; w++) {
+            *dst++ = w < domain_words ? domain->get_elem(w) : 0;
+        }
+    }
+
+    return words;
+}
+
+// WFC2DPreconditionNative implementation
+
+void WFC2DPreconditionNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("evaluate", "rect"), &WFC2DPreconditionNative::evaluate);
+    ClassDB::bind_method(D_METHOD("get_tile_count"), &WFC2DPreconditionNative::get_tile_count);
+    ClassDB::bind_method(D_METHOD("set_tile_count", "val"), &WFC2DPreconditionNative::set_tile_count);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "tile_count"), "set_tile_count", "get_tile_count");
+}
+
+WFC2DPreconditionNative::WFC2DPreconditionNative() {
+}
+
+WFC2DPreconditionNative::~WFC2DPreconditionNative() {
+}
+
+Ref<WFC2DPreconditionMapNative> WFC2DPreconditionNative::evaluate(const Rect2i& rect) {
+    Ref<WFC2DPreconditionMapNative> map;
+    map.instantiate();
+    map->initialize(rect);
+    evaluate_into(*map.ptr());
+    return map;
+}
+
+// WFC2DPreconditionReadExistingNative implementation
+
+void WFC2DPreconditionReadExistingNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_cells", "rect", "tile_ids"), &WFC2DPreconditionReadExistingNative::set_cells);
+    ClassDB::bind_method(D_METHOD("read_tile_map_layer", "layer", "attrs_to_id"), &WFC2DPreconditionReadExistingNative::read_tile_map_layer);
+    ClassDB::bind_method(D_METHOD("get_cell", "pos"), &WFC2DPreconditionReadExistingNative::get_cell);
+    ClassDB::bind_method(D_METHOD("get_cells_rect"), &WFC2DPreconditionReadExistingNative::get_cells_rect);
+}
+
+WFC2DPreconditionReadExistingNative::WFC2DPreconditionReadExistingNative() {
+}
+
+WFC2DPreconditionReadExistingNative::~WFC2DPreconditionReadExistingNative() {
+}
+
+void WFC2DPreconditionReadExistingNative::set_cells(const Rect2i& rect, const PackedInt32Array& tile_ids) {
+    ERR_FAIL_COND_MSG(tile_ids.size() != rect.get_area(), "Expected one tile id per cell of the rect");
+    cells_rect_ = rect;
+    cells_ = tile_ids;
+}
+
+void WFC2DPreconditionReadExistingNative::read_tile_map_layer(TileMapLayer* layer, const Dictionary& attrs_to_id) {
+    ERR_FAIL_NULL(layer);
+
+    cells_rect_ = layer->get_used_rect();
+    cells_.resize(cells_rect_.get_area());
+    cells_.fill(-1);
+    int32_t* dst = cells_.ptrw();
+
+    TypedArray<Vector2i> used_cells = layer->get_used_cells();
+    for (int64_t i = 0; i < used_cells.size(); i++) {
+        Vector2i cell = used_cells[i];
+        Vector2i atlas_coords = layer->get_cell_atlas_coords(cell);
+        Vector4i attrs(layer->get_cell_source_id(cell), atlas_coords.x, atlas_coords.y, layer->get_cell_alternative_tile(cell));
+
+        Variant tile = attrs_to_id.get(attrs, -1);
+        Vector2i local = cell - cells_rect_.position;
+        dst[(int64_t)local.y * cells_rect_.size.x + local.x] = static_cast<int32_t>(static_cast<int64_t>(tile));
+    }
+}
+
+int WFC2DPreconditionReadExistingNative::get_cell(const Vector2i& pos) const {
+    if (!cells_rect_.has_point(pos)) {
+        return -1;
+    }
+    Vector2i local = pos - cells_rect_.position;
+    return cells_[(int64_t)local.y * cells_rect_.size.x + local.x];
+}
+
+Ref<WFCBitSetNative> WFC2DPreconditionReadExistingNative::make_tile_domain(int tile) const {
+    Ref<WFCBitSetNative> domain;
+    domain.instantiate();
+    domain->initialize(tile_count_);
+    domain->set_bit(tile, true);
+    return domain;
+}
+
+void WFC2DPreconditionReadExistingNative::evaluate_into(WFC2DPreconditionMapNative& map) {
+    Rect2i rect = map.get_rect();
+    int32_t* dst = map.get_domain_classes_ptrw();
+
+    // Palette entries are created for tiles actually present
+    std::vector<int32_t> class_by_tile(std::max(tile_count_, 0), -2);
+
+    int32_t empty_class = -1;
+    Ref<WFCBitSetNative> empty_domain = get_empty_domain();
+    if (empty_domain.is_valid()) {
+        empty_class = map.add_class(empty_domain);
+    }
+
+    for (int y = rect.position.y; y < rect.get_end().y; y++) {
+        for (int x = rect.position.x; x < rect.get_end().x; x++) {
+            int tile = get_cell(Vector2i(x, y));
+
+            if (tile < 0 || tile >= tile_count_) {
+                *dst++ = empty_class;
+                continue;
+            }
+
+            if (class_by_tile[tile] == -2) {
+                Ref<WFCBitSetNative> domain = make_tile_domain(tile);
+                class_by_tile[tile] = domain.is_valid() ? map.add_class(domain) : -1;
+            }
+            *dst++ = class_by_tile[tile];
+        }
+    }
+}
+
+// WFC2DPreconditionRemapNative implementation
+
+void WFC2DPreconditionRemapNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_domains_map"), &WFC2DPreconditionRemapNative::get_domains_map);
+    ClassDB::bind_method(D_METHOD("set_domains_map", "val"), &WFC2DPreconditionRemapNative::set_domains_map);
+    ClassDB::bind_method(D_METHOD("get_default_domain"), &WFC2DPreconditionRemapNative::get_default_domain);
+    ClassDB::bind_method(D_METHOD("set_default_domain", "val"), &WFC2DPreconditionRemapNative::set_default_domain);
+
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "domains_map"), "set_domains_map", "get_domains_map");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "default_domain", PROPERTY_HINT_RESOURCE_TYPE, "WFCBitSetNative"), "set_default_domain", "get_default_domain");
+}
+
+WFC2DPreconditionRemapNative::WFC2DPreconditionRemapNative() {
+}
+
+WFC2DPreconditionRemapNative::~WFC2DPreconditionRemapNative() {
+}
+
+Ref<WFCBitSetNative> WFC2DPreconditionRemapNative::make_tile_domain(int tile) const {
+    if (tile >= domains_map_.size()) {
+        return Ref<WFCBitSetNative>();
+    }
+    return domains_map_[tile];
+}
+
+// WFC2DPreconditionComposeNative implementation
+
+void WFC2DPreconditionComposeNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_preconditions"), &WFC2DPreconditionComposeNative::get_preconditions);
+    ClassDB::bind_method(D_METHOD("set_preconditions", "val"), &WFC2DPreconditionComposeNative::set_preconditions);
+
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "preconditions"), "set_preconditions", "get_preconditions");
+}
+
+WFC2DPreconditionComposeNative::WFC2DPreconditionComposeNative() {
+}
+
+WFC2DPreconditionComposeNative::~WFC2DPreconditionComposeNative() {
+}
+
+void WFC2DPreconditionComposeNative::evaluate_into(WFC2DPreconditionMapNative& map) {
+    Rect2i rect = map.get_rect();
+    int32_t* dst = map.get_domain_classes_ptrw();
+    int64_t cell_count = rect.get_area();
+
+    for (int i = 0; i < preconditions_.size(); i++) {
+        Ref<WFC2DPreconditionNative> precondition = preconditions_[i];
+        if (precondition.is_null()) {
+            continue;
+        }
+
+        Ref<WFC2DPreconditionMapNative> part = precondition->evaluate(rect);
+        const int32_t* src = part->get_domain_classes().ptr();
+
+        // Result class for a part class alone, and for a (result class, part class) pair
+        std::vector<int32_t> class_by_part(part->get_class_count(), -1);
+        std::unordered_map<int64_t, int32_t> class_by_pair;
+
+        for (int64_t cell = 0; cell < cell_count; cell++) {
+            int32_t part_class = src[cell];
+            if (part_class < 0) {
+                continue;
+            }
+
+            int32_t current = dst[cell];
+            if (current < 0) {
+                if (class_by_part[part_class] < 0) {
+                    class_by_part[part_class] = map.add_class(part->get_class_domain(part_class));
+                }
+                dst[cell] = class_by_part[part_class];
+                continue;
+            }
+
+            int64_t key = ((int64_t)current << 32) | (uint32_t)part_class;
+            auto found = class_by_pair.find(key);
+            if (found == class_by_pair.end()) {
+                Ref<WFCBitSetNative> domain = part->get_class_domain(part_class)->intersect(map.get_class_domain(current));
+                found = class_by_pair.emplace(key, map.add_class(domain)).first;
+            }
+            dst[cell] = found->second;
+        }
+    }
+}
+
+} // namespace godot
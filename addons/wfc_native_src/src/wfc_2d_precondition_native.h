@@ -0,0 +1,175 @@
+#ifndef WFC_2D_PRECONDITION_NATIVE_H
+#define WFC_2D_PRECONDITION_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/tile_map_layer.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include "wfc_bitset_native.h"
+#include "wfc_2d_problem_native.h"
+
+#include <vector>
+
+namespace godot {
+
+// Result of evaluating a precondition over a rect: a domain class per cell (row-major,
+// -1 = not constrained) and the palette of class domains.
+class WFC2DPreconditionMapNative : public RefCounted {
+    GDCLASS(WFC2DPreconditionMapNative, RefCounted)
+
+private:
+    Rect2i rect_;
+    PackedInt32Array domain_classes_;
+    TypedArray<WFCBitSetNative> palette_;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFC2DPreconditionMapNative();
+    ~WFC2DPreconditionMapNative();
+
+    // All cells of rect unconstrained, empty palette
+    void initialize(const Rect2i& rect);
+
+    // Appends a domain to the palette, returns its class
+    int add_class(const Ref<WFCBitSetNative>& domain);
+
+    // Domain at absolute coordinates, null when not constrained
+    Ref<WFCBitSetNative> get_domain(const Vector2i& pos) const;
+
+    // Passes the domains to the problem with WFC2DProblemNative::set_precondition_domains(),
+    // and which cells of its border rect are constrained. Cells outside of this map's rect
+    // are not constrained, so evaluate over the problem's precondition border rect.
+    void apply_to(const Ref<WFC2DProblemNative>& problem) const;
+
+    // Classes (row-major over rect), -1 for cells outside of this map's rect
+    PackedInt32Array get_domain_classes_over(const Rect2i& rect) const;
+
+    // One byte per cell of rect (row-major), 1 where a domain is set
+    PackedByteArray get_constrained_mask(const Rect2i& rect) const;
+
+    // Palette domains as words_per_domain words each, one domain after another
+    PackedInt64Array get_palette_words(int words_per_domain) const;
+
+    Rect2i get_rect() const { return rect_; }
+    PackedInt32Array get_domain_classes() const { return domain_classes_; }
+    TypedArray<WFCBitSetNative> get_palette() const { return palette_; }
+
+    // For subclasses filling the map, no bounds checks
+    int32_t* get_domain_classes_ptrw() { return domain_classes_.ptrw(); }
+    Ref<WFCBitSetNative> get_class_domain(int domain_class) const { return palette_[domain_class]; }
+    int get_class_count() const { return static_cast<int>(palette_.size()); }
+};
+
+// Native counterpart of GDScript WFC2DPrecondition, evaluated over a whole rect at once
+class WFC2DPreconditionNative : public RefCounted {
+    GDCLASS(WFC2DPreconditionNative, RefCounted)
+
+protected:
+    int tile_count_ = 0;
+
+    static void _bind_methods();
+
+    // Fills the classes of an initialized map; default does not constrain any cell
+    virtual void evaluate_into(WFC2DPreconditionMapNative& map) {}
+
+public:
+    WFC2DPreconditionNative();
+    ~WFC2DPreconditionNative();
+
+    Ref<WFC2DPreconditionMapNative> evaluate(const Rect2i& rect);
+
+    // Size of produced domains
+    int get_tile_count() const { return tile_count_; }
+    void set_tile_count(int val) { tile_count_ = val; }
+};
+
+// Requires cells to keep the tiles already placed in a map (WFC2DPreconditionReadExistingMap)
+class WFC2DPreconditionReadExistingNative : public WFC2DPreconditionNative {
+    GDCLASS(WFC2DPreconditionReadExistingNative, WFC2DPreconditionNative)
+
+private:
+    Rect2i cells_rect_;
+    PackedInt32Array cells_;
+
+protected:
+    static void _bind_methods();
+
+    virtual void evaluate_into(WFC2DPreconditionMapNative& map) override;
+
+    // Domain of a cell holding `tile`, and of an empty cell (null = not constrained)
+    virtual Ref<WFCBitSetNative> make_tile_domain(int tile) const;
+    virtual Ref<WFCBitSetNative> get_empty_domain() const { return Ref<WFCBitSetNative>(); }
+
+public:
+    WFC2DPreconditionReadExistingNative();
+    ~WFC2DPreconditionReadExistingNative();
+
+    // Tile ids laid out row-major over rect, -1 = empty
+    void set_cells(const Rect2i& rect, const PackedInt32Array& tile_ids);
+
+    // Reads all used cells of a layer. attrs_to_id maps Vector4i(source, atlas x, atlas y,
+    // alternative) to tile id, as WFCTilemapLayerMapper2D.attrs_to_id.
+    void read_tile_map_layer(TileMapLayer* layer, const Dictionary& attrs_to_id);
+
+    // Tile at absolute coordinates, -1 when empty
+    int get_cell(const Vector2i& pos) const;
+
+    Rect2i get_cells_rect() const { return cells_rect_; }
+};
+
+// Replaces the tiles of a map by domains (WFC2DPreconditionRemap)
+class WFC2DPreconditionRemapNative : public WFC2DPreconditionReadExistingNative {
+    GDCLASS(WFC2DPreconditionRemapNative, WFC2DPreconditionReadExistingNative)
+
+private:
+    TypedArray<WFCBitSetNative> domains_map_;
+    Ref<WFCBitSetNative> default_domain_;
+
+protected:
+    static void _bind_methods();
+
+    virtual Ref<WFCBitSetNative> make_tile_domain(int tile) const override;
+    virtual Ref<WFCBitSetNative> get_empty_domain() const override { return default_domain_; }
+
+public:
+    WFC2DPreconditionRemapNative();
+    ~WFC2DPreconditionRemapNative();
+
+    // Domain per tile id
+    TypedArray<WFCBitSetNative> get_domains_map() const { return domains_map_; }
+    void set_domains_map(const TypedArray<WFCBitSetNative>& val) { domains_map_ = val; }
+
+    // Domain of empty cells, null leaves them unconstrained
+    Ref<WFCBitSetNative> get_default_domain() const { return default_domain_; }
+    void set_default_domain(const Ref<WFCBitSetNative>& val) { default_domain_ = val; }
+};
+
+// Intersection of several preconditions (WFC2DPreconditionCompose), computed once per
+// distinct pair of palette entries
+class WFC2DPreconditionComposeNative : public WFC2DPreconditionNative {
+    GDCLASS(WFC2DPreconditionComposeNative, WFC2DPreconditionNative)
+
+private:
+    TypedArray<WFC2DPreconditionNative> preconditions_;
+
+protected:
+    static void _bind_methods();
+
+    virtual void evaluate_into(WFC2DPreconditionMapNative& map) override;
+
+public:
+    WFC2DPreconditionComposeNative();
+    ~WFC2DPreconditionComposeNative();
+
+    TypedArray<WFC2DPreconditionNative> get_preconditions() const { return preconditions_; }
+    void set_preconditions(const TypedArray<WFC2DPreconditionNative>& val) { preconditions_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_2D_PRECONDITION_NATIVE_H
@@ -22,6 +22,7 @@ WFC2DAC4BinaryConstraintNative::~WFC2DAC4BinaryConstraintNative() {
 void WFC2DAC4BinaryConstraintNative::initialize(const Vector2i& axis, const Vector2i& size, const Ref<WFCBitMatrixNative>& axis_matrix) {
     axis_ = axis;
     problem_size_ = Rect2i(Vector2i(0, 0), size);
+    layout_.configure(size, WFC2DCellLayout::ROW_MAJOR);
 
     allowed_tiles_.clear();
     for (int i = 0; i < axis_matrix->get_height(); i++) {
@@ -34,16 +35,22 @@ void WFC2DAC4BinaryConstraintNative::initialize(const Vector2i& axis, const Vect
     }
 }
 
+void WFC2DAC4BinaryConstraintNative::initialize_with_supports(const Vector2i& axis, const Vector2i& size, const TypedArray<PackedInt64Array>& supports) {
+    axis_ = axis;
+    problem_size_ = Rect2i(Vector2i(0, 0), size);
+    layout_.configure(size, WFC2DCellLayout::ROW_MAJOR);
+    allowed_tiles_ = supports;
+}
+
 int WFC2DAC4BinaryConstraintNative::get_cell_id(const Vector2i& pos) const {
     if (problem_size_.has_point(pos)) {
-        return pos.x + pos.y * problem_size_.size.x;
+        return layout_.coord_to_id(pos);
     }
     return -1;
 }
 
 Vector2i WFC2DAC4BinaryConstraintNative::get_cell_pos(int cell_id) const {
-    int szx = problem_size_.size.x;
-    return Vector2i(cell_id % szx, cell_id / szx);
+    return layout_.id_to_coord(cell_id);
 }
 
 int WFC2DAC4BinaryConstraintNative::get_dependent(int cell_id) {
@@ -81,12 +88,21 @@ void WFC2DProblemNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_init_read_rects"), &WFC2DProblemNative::get_init_read_rects);
     ClassDB::bind_method(D_METHOD("set_init_read_rects", "val"), &WFC2DProblemNative::set_init_read_rects);
 
+    ClassDB::bind_method(D_METHOD("get_cell_layout"), &WFC2DProblemNative::get_cell_layout);
+    ClassDB::bind_method(D_METHOD("set_cell_layout", "val"), &WFC2DProblemNative::set_cell_layout);
+
+    ClassDB::bind_method(D_METHOD("get_gdscript_parity"), &WFC2DProblemNative::get_gdscript_parity);
+    ClassDB::bind_method(D_METHOD("set_gdscript_parity", "val"), &WFC2DProblemNative::set_gdscript_parity);
+
     ClassDB::bind_method(D_METHOD("get_axes"), &WFC2DProblemNative::get_axes);
     ClassDB::bind_method(D_METHOD("get_axis_matrices"), &WFC2DProblemNative::get_axis_matrices);
 
     ClassDB::bind_method(D_METHOD("coord_to_id", "coord"), &WFC2DProblemNative::coord_to_id);
     ClassDB::bind_method(D_METHOD("id_to_coord", "id"), &WFC2DProblemNative::id_to_coord);
+    ClassDB::bind_method(D_METHOD("to_row_major", "cells"), &WFC2DProblemNative::to_row_major);
+    ClassDB::bind_method(D_METHOD("from_row_major", "cells"), &WFC2DProblemNative::from_row_major);
 
+    ClassDB::bind_method(D_METHOD("get_cells_in_rect", "area"), &WFC2DProblemNative::get_cells_in_rect);
     ClassDB::bind_method(D_METHOD("get_dependencies_range"), &WFC2DProblemNative::get_dependencies_range);
     ClassDB::bind_method(D_METHOD("split", "concurrency_limit"), &WFC2DProblemNative::split);
 
@@ -94,12 +110,24 @@ void WFC2DProblemNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_precondition_domain", "cell_id", "domain"), &WFC2DProblemNative::set_precondition_domain);
     ClassDB::bind_method(D_METHOD("set_precondition_solution", "cell_id", "solution"), &WFC2DProblemNative::set_precondition_solution);
     ClassDB::bind_method(D_METHOD("clear_preconditions"), &WFC2DProblemNative::clear_preconditions);
+    ClassDB::bind_method(D_METHOD("set_precondition_solutions", "solutions"), &WFC2DProblemNative::set_precondition_solutions);
+    ClassDB::bind_method(D_METHOD("set_precondition_domains", "palette_words", "domain_classes", "class_count"), &WFC2DProblemNative::set_precondition_domains);
+    ClassDB::bind_method(D_METHOD("get_precondition_border_rect"), &WFC2DProblemNative::get_precondition_border_rect);
+    ClassDB::bind_method(D_METHOD("set_precondition_border_mask", "mask"), &WFC2DProblemNative::set_precondition_border_mask);
+    ClassDB::bind_method(D_METHOD("get_precondition_border_mask"), &WFC2DProblemNative::get_precondition_border_mask);
+    ClassDB::bind_method(D_METHOD("initialize_from", "other", "rect"), &WFC2DProblemNative::initialize_from);
+    ClassDB::bind_method(D_METHOD("blit_precondition_solutions", "source_rect", "source_solutions", "read_rect"), &WFC2DProblemNative::blit_precondition_solutions);
 
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "rules", PROPERTY_HINT_RESOURCE_TYPE, "WFCRules2DNative"), "set_rules", "get_rules");
     ADD_PROPERTY(PropertyInfo(Variant::RECT2I, "rect"), "set_rect", "get_rect");
     ADD_PROPERTY(PropertyInfo(Variant::RECT2I, "renderable_rect"), "set_renderable_rect", "get_renderable_rect");
     ADD_PROPERTY(PropertyInfo(Variant::RECT2I, "edges_rect"), "set_edges_rect", "get_edges_rect");
     ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "init_read_rects"), "set_init_read_rects", "get_init_read_rects");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_layout", PROPERTY_HINT_ENUM, "Row Major,Tiled"), "set_cell_layout", "get_cell_layout");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "gdscript_parity"), "set_gdscript_parity", "get_gdscript_parity");
+
+    BIND_CONSTANT(CELL_LAYOUT_ROW_MAJOR);
+    BIND_CONSTANT(CELL_LAYOUT_TILED);
 }
 
 WFC2DProblemNative::WFC2DProblemNative() {
@@ -114,10 +142,12 @@ void WFC2DProblemNative::initialize(const Ref<WFCRules2DNative>& rules, const Re
     renderable_rect_ = rect;
     edges_rect_ = rect;
     tile_count_ = rules->get_tile_count();
+    update_layout();
 
-    // Build axes and axis_matrices (including reverse directions)
-    axes_.clear();
-    axis_matrices_.clear();
+    // Build axes and axis_matrices (including reverse directions).
+    // Fresh arrays, not clear(): they may be shared with problems made by initialize_from().
+    axes_ = TypedArray<Vector2i>();
+    axis_matrices_ = TypedArray<WFCBitMatrixNative>();
 
     TypedArray<Vector2i> rule_axes = rules->get_axes();
     TypedArray<WFCBitMatrixNative> rule_matrices = rules->get_axis_matrices();
@@ -130,19 +160,82 @@ void WFC2DProblemNative::initialize(const Ref<WFCRules2DNative>& rules, const Re
         axes_.append(axis);
         axis_matrices_.append(matrix);
 
-        // Reverse direction
+        // Reverse direction, transposed once per rules
         axes_.append(-axis);
-        axis_matrices_.append(matrix->transpose());
+        axis_matrices_.append(rules->get_transposed_matrix(i));
     }
+
+    ac4_constraints_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
 }
 
-int WFC2DProblemNative::coord_to_id(const Vector2i& coord) const {
-    return rect_.size.x * coord.y + coord.x;
+void WFC2DProblemNative::initialize_from(const Ref<WFC2DProblemNative>& other, const Rect2i& rect) {
+    ERR_FAIL_COND(other.is_null());
+
+    if (other.ptr() != this) {
+        rules_ = other->rules_;
+        axes_ = other->axes_;
+        axis_matrices_ = other->axis_matrices_;
+        tile_count_ = other->tile_count_;
+        ac4_constraints_cache_ = other->ac4_constraints_cache_;
+        ac4_constraints_cache_size_ = other->ac4_constraints_cache_size_;
+        ac4_constraints_cache_layout_ = other->ac4_constraints_cache_layout_;
+        cell_layout_ = other->cell_layout_;
+        gdscript_parity_ = other->gdscript_parity_;
+        layout_ = other->layout_;
+    }
+
+    rect_ = rect;
+    renderable_rect_ = rect;
+    edges_rect_ = rect;
+    update_layout();
+    init_read_rects_.clear();
+    clear_preconditions();
 }
 
-Vector2i WFC2DProblemNative::id_to_coord(int id) const {
-    int szx = rect_.size.x;
-    return Vector2i(id % szx, id / szx);
+void WFC2DProblemNative::set_cell_layout(int val) {
+    ERR_FAIL_COND(val < CELL_LAYOUT_ROW_MAJOR || val > CELL_LAYOUT_TILED);
+    cell_layout_ = val;
+    update_layout();
+    // Preconditions were indexed by the previous layout
+    clear_preconditions();
+}
+
+PackedInt64Array WFC2DProblemNative::to_row_major(const PackedInt64Array& cells) const {
+    if (layout_.is_row_major() || cells.size() != rect_.get_area()) {
+        return cells;
+    }
+
+    PackedInt64Array result;
+    result.resize(cells.size());
+    int64_t* dst = result.ptrw();
+    const int64_t* src = cells.ptr();
+
+    for (int y = 0; y < rect_.size.y; y++) {
+        for (int x = 0; x < rect_.size.x; x++) {
+            *dst++ = src[coord_to_id(Vector2i(x, y))];
+        }
+    }
+
+    return result;
+}
+
+PackedInt64Array WFC2DProblemNative::from_row_major(const PackedInt64Array& cells) const {
+    if (layout_.is_row_major() || cells.size() != rect_.get_area()) {
+        return cells;
+    }
+
+    PackedInt64Array result;
+    result.resize(cells.size());
+    int64_t* dst = result.ptrw();
+    const int64_t* src = cells.ptr();
+
+    for (int y = 0; y < rect_.size.y; y++) {
+        for (int x = 0; x < rect_.size.x; x++) {
+            dst[coord_to_id(Vector2i(x, y))] = *src++;
+        }
+    }
+
+    return result;
 }
 
 int WFC2DProblemNative::get_cell_count() {
@@ -156,10 +249,9 @@ Ref<WFCBitSetNative> WFC2DProblemNative::get_default_domain() {
     return domain;
 }
 
-void WFC2DProblemNative::set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain) {
+void WFC2DProblemNative::ensure_precondition_arrays() {
     int cell_count = get_cell_count();
 
-    // Initialize arrays if needed
     if (precondition_domains_.size() != cell_count) {
         precondition_domains_.resize(cell_count);
         // All elements are null by default (no precondition)
@@ -168,25 +260,20 @@ void WFC2DProblemNative::set_precondition_domain(int cell_id, const Ref<WFCBitSe
         precondition_solutions_.resize(cell_count);
         precondition_solutions_.fill(-1);  // -1 = not pre-solved
     }
+}
 
-    if (cell_id >= 0 && cell_id < cell_count) {
+void WFC2DProblemNative::set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain) {
+    ensure_precondition_arrays();
+
+    if (cell_id >= 0 && cell_id < precondition_domains_.size()) {
         precondition_domains_[cell_id] = domain;
     }
 }
 
 void WFC2DProblemNative::set_precondition_solution(int cell_id, int solution) {
-    int cell_count = get_cell_count();
+    ensure_precondition_arrays();
 
-    // Initialize arrays if needed
-    if (precondition_domains_.size() != cell_count) {
-        precondition_domains_.resize(cell_count);
-    }
-    if (precondition_solutions_.size() != cell_count) {
-        precondition_solutions_.resize(cell_count);
-        precondition_solutions_.fill(-1);
-    }
-
-    if (cell_id >= 0 && cell_id < cell_count) {
+    if (cell_id >= 0 && cell_id < precondition_solutions_.size()) {
         precondition_solutions_[cell_id] = solution;
     }
 }
@@ -194,6 +281,111 @@ void WFC2DProblemNative::set_precondition_solution(int cell_id, int solution) {
 void WFC2DProblemNative::clear_preconditions() {
     precondition_domains_.clear();
     precondition_solutions_.clear();
+    precondition_border_mask_.clear();
+}
+
+Rect2i WFC2DProblemNative::get_precondition_border_rect() const {
+    Vector2i range = get_dependencies_range();
+    return rect_.grow_individual(range.x, range.y, range.x, range.y);
+}
+
+void WFC2DProblemNative::set_precondition_border_mask(const PackedByteArray& mask) {
+    ERR_FAIL_COND_MSG(!mask.is_empty() && mask.size() != get_precondition_border_rect().get_area(),
+                      "Expected one byte per cell of the border rect");
+    precondition_border_mask_ = mask;
+}
+
+void WFC2DProblemNative::set_precondition_solutions(const PackedInt32Array& solutions) {
+    ERR_FAIL_COND_MSG(solutions.size() != get_cell_count(), "Expected one solution per cell of the rect");
+
+    ensure_precondition_arrays();
+
+    const int32_t* src = solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+
+    for (int y = 0; y < rect_.size.y; y++) {
+        for (int x = 0; x < rect_.size.x; x++) {
+            int32_t solution = *src++;
+            dst[coord_to_id(Vector2i(x, y))] = solution >= 0 && solution < tile_count_ ? solution : -1;
+        }
+    }
+}
+
+void WFC2DProblemNative::set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count) {
+    ERR_FAIL_COND_MSG(domain_classes.size() != get_cell_count(), "Expected one domain class per cell of the rect");
+    ERR_FAIL_COND(class_count < 0);
+
+    int words_per_domain = class_count > 0 ? palette_words.size() / class_count : 0;
+    int required_words = (tile_count_ + WFCBitSetNative::BITS_PER_INT - 1) / WFCBitSetNative::BITS_PER_INT;
+    ERR_FAIL_COND_MSG(class_count > 0 && (words_per_domain < required_words || words_per_domain * class_count != palette_words.size()),
+                      "Palette does not hold class_count domains of tile_count bits");
+
+    // One shared bitset per class, solver states replace domains instead of modifying them
+    std::vector<Ref<WFCBitSetNative>> palette(class_count);
+    const int64_t* words = palette_words.ptr();
+    for (int c = 0; c < class_count; c++) {
+        palette[c].instantiate();
+        palette[c]->initialize(tile_count_);
+        for (int w = 0; w < required_words; w++) {
+            palette[c]->set_elem(w, words[(int64_t)c * words_per_domain + w]);
+        }
+    }
+
+    ensure_precondition_arrays();
+
+    const int32_t* src = domain_classes.ptr();
+    for (int y = 0; y < rect_.size.y; y++) {
+        for (int x = 0; x < rect_.size.x; x++) {
+            int32_t domain_class = *src++;
+            int cell_id = coord_to_id(Vector2i(x, y));
+
+            if (domain_class >= 0 && domain_class < class_count) {
+                precondition_domains_[cell_id] = palette[domain_class];
+            } else {
+                precondition_domains_[cell_id] = Ref<WFCBitSetNative>();
+            }
+        }
+    }
+}
+
+void WFC2DProblemNative::blit_precondition_solutions(const Rect2i& source_rect, const PackedInt64Array& source_solutions, const Rect2i& read_rect) {
+    Rect2i region = read_rect.intersection(source_rect).intersection(rect_);
+
+    if (!region.has_area() || source_solutions.size() < source_rect.get_area()) {
+        return;
+    }
+
+    ensure_precondition_arrays();
+
+    const int64_t* src = source_solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+
+    int src_x = region.position.x - source_rect.position.x;
+    int dst_x = region.position.x - rect_.position.x;
+
+    for (int y = region.position.y; y < region.position.y + region.size.y; y++) {
+        const int64_t* src_row = src + (int64_t)(y - source_rect.position.y) * source_rect.size.x + src_x;
+
+        if (layout_.is_row_major()) {
+            int64_t* dst_row = dst + (int64_t)(y - rect_.position.y) * rect_.size.x + dst_x;
+
+            for (int x = 0; x < region.size.x; x++) {
+                int64_t solution = src_row[x];
+                // Skip unsolved (negative entropy) and failed cells
+                if (solution >= 0 && solution != WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                    dst_row[x] = solution;
+                }
+            }
+            continue;
+        }
+
+        for (int x = 0; x < region.size.x; x++) {
+            int64_t solution = src_row[x];
+            if (solution >= 0 && solution != WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                dst[coord_to_id(Vector2i(dst_x + x, y - rect_.position.y))] = solution;
+            }
+        }
+    }
 }
 
 void WFC2DProblemNative::populate_initial_state(const Ref<WFCSolverStateNative>& state) {
@@ -201,27 +393,121 @@ void WFC2DProblemNative::populate_initial_state(const Ref<WFCSolverStateNative>&
     int width = rect_.size.x;
     int height = rect_.size.y;
 
+    // Domains allowed next to the edge, per axis, same as in GDScript WFC2DProblem
+    std::vector<Ref<WFCBitSetNative>> pre_edge_domains;
+    Ref<WFCBitSetNative> edge_domain = rules_.is_valid() ? rules_->get_edge_domain() : Ref<WFCBitSetNative>();
+    if (edge_domain.is_valid() && !edge_domain->is_empty()) {
+        pre_edge_domains.reserve(axis_matrices_.size());
+        for (int i = 0; i < axis_matrices_.size(); i++) {
+            Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+            pre_edge_domains.push_back(matrix->transform(edge_domain));
+        }
+    }
+
+    bool has_preconditions = !precondition_solutions_.is_empty() || !precondition_domains_.is_empty();
+
+    if (!has_preconditions && pre_edge_domains.empty()) {
+        return;
+    }
+
+    if (!gdscript_parity_) {
+        if (!has_preconditions) {
+            // Only cells near the edges are affected
+            Vector2i range = get_dependencies_range();
+            Rect2i inner = edges_rect_.grow_individual(-range.x, -range.y, -range.x, -range.y);
+
+            for (int y = rect_.position.y; y < rect_.get_end().y; y++) {
+                bool inner_row = y >= inner.position.y && y < inner.get_end().y;
+                int skip_from = inner_row ? std::max(inner.position.x, rect_.position.x) : rect_.get_end().x;
+                int skip_to = inner_row ? std::min(inner.get_end().x, rect_.get_end().x) : rect_.get_end().x;
+
+                for (int x = rect_.position.x; x < rect_.get_end().x; x++) {
+                    if (x == skip_from && skip_to > skip_from) {
+                        x = skip_to - 1;
+                        continue;
+                    }
+                    apply_precondition(state, coord_to_id(Vector2i(x, y) - rect_.position), pre_edge_domains);
+                }
+            }
+            return;
+        }
+
+        // Cell id order, walks memory linearly in any layout
+        for (int cell_id = 0; cell_id < cell_count; cell_id++) {
+            apply_precondition(state, cell_id, pre_edge_domains);
+        }
+        return;
+    }
+
     // IMPORTANT: Iterate in same order as GDScript (for x ... for y)
     // to ensure changed_cells is populated in identical order.
     // GDScript iterates: for x in range(rect.size.x): for y in range(rect.size.y)
     // which visits cells in column-major order.
     for (int x = 0; x < width; x++) {
         for (int y = 0; y < height; y++) {
-            int cell_id = y * width + x;
+            apply_precondition(state, coord_to_id(Vector2i(x, y)), pre_edge_domains);
+        }
+    }
+}
 
-            // Check for pre-solved cells first
-            if (precondition_solutions_.size() > cell_id && precondition_solutions_[cell_id] >= 0) {
-                state->set_solution(cell_id, precondition_solutions_[cell_id]);
-            }
-            // Otherwise check for domain constraints
-            else if (precondition_domains_.size() > cell_id) {
-                Ref<WFCBitSetNative> domain = precondition_domains_[cell_id];
-                if (domain.is_valid() && !domain->is_empty()) {
-                    state->set_domain(cell_id, domain);
-                }
+bool WFC2DProblemNative::has_precondition_domain_at(const Vector2i& abs_pos) const {
+    if (!rect_.has_point(abs_pos)) {
+        Rect2i border = get_precondition_border_rect();
+        if (precondition_border_mask_.size() != border.get_area() || !border.has_point(abs_pos)) {
+            return false;
+        }
+
+        Vector2i local = abs_pos - border.position;
+        return precondition_border_mask_[(int64_t)local.y * border.size.x + local.x] != 0;
+    }
+
+    int cell_id = coord_to_id(abs_pos - rect_.position);
+    if (cell_id >= precondition_domains_.size()) {
+        return false;
+    }
+
+    Ref<WFCBitSetNative> domain = precondition_domains_[cell_id];
+    return domain.is_valid();
+}
+
+void WFC2DProblemNative::apply_precondition(const Ref<WFCSolverStateNative>& state, int cell_id,
+                                            const std::vector<Ref<WFCBitSetNative>>& pre_edge_domains) {
+    // Check for pre-solved cells first
+    if (precondition_solutions_.size() > cell_id && precondition_solutions_[cell_id] >= 0) {
+        state->set_solution(cell_id, precondition_solutions_[cell_id]);
+        return;
+    }
+
+    // Otherwise check for domain constraints...
+    Ref<WFCBitSetNative> domain;
+    if (precondition_domains_.size() > cell_id) {
+        domain = precondition_domains_[cell_id];
+    }
+
+    // ...and edge conditions. Neighbours with own precondition domain are not treated as edge.
+    if (!pre_edge_domains.empty()) {
+        Vector2i abs_pos = id_to_coord(cell_id) + rect_.position;
+
+        for (int i = 0; i < axes_.size(); i++) {
+            Vector2i neighbour_pos = get_neighbour(abs_pos, i);
+
+            if (edges_rect_.has_point(neighbour_pos) || has_precondition_domain_at(neighbour_pos)) {
+                continue;
             }
+
+            domain = domain.is_valid() ? domain->intersect(pre_edge_domains[i]) : pre_edge_domains[i];
         }
     }
+
+    if (domain.is_null()) {
+        return;
+    }
+
+    // Conflicting preconditions, the cell is marked failed
+    if (domain->is_empty()) {
+        ERR_PRINT("Precondition yielded an empty domain at " + String(id_to_coord(cell_id) + rect_.position));
+    }
+    state->set_domain(cell_id, domain);
 }
 
 Ref<WFCBitSetNative> WFC2DProblemNative::compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) {
@@ -230,7 +516,6 @@ Ref<WFCBitSetNative> WFC2DProblemNative::compute_cell_domain(const Ref<WFCSolver
     Ref<WFCBitSetNative> res = current_domain->copy();
 
     Vector2i pos = id_to_coord(cell_id);
-    PackedInt64Array solution_or_entropy = state->get_cell_solution_or_entropy();
 
     for (int i = 0; i < axes_.size(); i++) {
         Vector2i axis = axes_[i];
@@ -242,7 +527,7 @@ Ref<WFCBitSetNative> WFC2DProblemNative::compute_cell_domain(const Ref<WFCSolver
 
         int other_id = coord_to_id(other_pos);
 
-        if (solution_or_entropy[other_id] == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+        if (state->get_cell_solution(other_id) == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
             continue;
         }
 
@@ -282,58 +567,58 @@ PackedInt64Array WFC2DProblemNative::get_related_cells(int changed_cell_id) {
     return result;
 }
 
-int WFC2DProblemNative::pick_divergence_option(TypedArray<int> options) {
-    if (rules_.is_null() || !rules_->get_probabilities_enabled()) {
-        return WFCProblemNative::pick_divergence_option(options);
-    }
-
-    if (options.size() == 0) return -1;
-    if (options.size() == 1) {
-        // Explicit Variant conversion to avoid issues with TypedArray operator[]
-        Variant v = options[0];
-        int result = static_cast<int>(static_cast<int64_t>(v));
-        options.remove_at(0);
-        return result;
-    }
+PackedInt64Array WFC2DProblemNative::get_cells_in_rect(const Rect2i& area) const {
+    Rect2i region = area.intersection(rect_);
 
-    PackedFloat32Array probabilities = rules_->get_probabilities();
-    float probabilities_sum = 0.0f;
+    PackedInt64Array result;
+    result.resize(region.get_area());
+    int64_t* ptr = result.ptrw();
 
-    for (int i = 0; i < options.size(); i++) {
-        Variant v = options[i];
-        int option = static_cast<int>(static_cast<int64_t>(v));
-        if (option >= 0 && option < probabilities.size()) {
-            probabilities_sum += probabilities[option];
+    for (int y = region.position.y; y < region.get_end().y; y++) {
+        for (int x = region.position.x; x < region.get_end().x; x++) {
+            *ptr++ = coord_to_id(Vector2i(x, y) - rect_.position);
         }
     }
 
-    float value = UtilityFunctions::randf_range(0.0f, probabilities_sum);
-    probabilities_sum = 0.0f;
-    int chosen_index = 0;
+    return result;
+}
 
-    for (int i = 0; i < options.size(); i++) {
-        Variant v = options[i];
-        int option = static_cast<int>(static_cast<int64_t>(v));
-        if (option >= 0 && option < probabilities.size()) {
-            probabilities_sum += probabilities[option];
-        }
-        if (probabilities_sum > value) {
-            chosen_index = i;
-            break;
+PackedInt64Array WFC2DProblemNative::get_cells_in_radius(int cell_id, int radius) {
+    Vector2i pos = id_to_coord(cell_id);
+    Rect2i area = Rect2i(pos - Vector2i(radius, radius), Vector2i(radius, radius) * 2 + Vector2i(1, 1))
+        .intersection(Rect2i(Vector2i(), rect_.size));
+
+    PackedInt64Array result;
+    result.resize(area.get_area());
+    int64_t* ptr = result.ptrw();
+
+    for (int y = area.position.y; y < area.get_end().y; y++) {
+        for (int x = area.position.x; x < area.get_end().x; x++) {
+            *ptr++ = coord_to_id(Vector2i(x, y));
         }
     }
 
-    Variant v = options[chosen_index];
-    int result = static_cast<int>(static_cast<int64_t>(v));
-    options.remove_at(chosen_index);
     return result;
 }
 
+int WFC2DProblemNative::pick_divergence_option(TypedArray<int> options) {
+    if (rules_.is_null() || !rules_->get_probabilities_enabled() || get_uniform_divergence_options()) {
+        return WFCProblemNative::pick_divergence_option(options);
+    }
+
+    return pick_weighted_option(options, rules_->get_probabilities());
+}
+
 bool WFC2DProblemNative::supports_ac4() {
     return true;
 }
 
 TypedArray<WFCProblemAC4BinaryConstraintNative> WFC2DProblemNative::get_ac4_binary_constraints() {
+    if (!ac4_constraints_cache_.is_empty() && ac4_constraints_cache_size_ == rect_.size &&
+        ac4_constraints_cache_layout_ == cell_layout_) {
+        return ac4_constraints_cache_;
+    }
+
     TypedArray<WFCProblemAC4BinaryConstraintNative> constraints;
 
     for (int i = 0; i < axes_.size(); i++) {
@@ -342,13 +627,62 @@ TypedArray<WFCProblemAC4BinaryConstraintNative> WFC2DProblemNative::get_ac4_bina
 
         Ref<WFC2DAC4BinaryConstraintNative> constraint;
         constraint.instantiate();
-        constraint->initialize(axis, rect_.size, matrix);
+        if (rules_.is_valid()) {
+            constraint->initialize_with_supports(axis, rect_.size, rules_->get_supports(matrix));
+        } else {
+            constraint->initialize(axis, rect_.size, matrix);
+        }
+        constraint->set_cell_layout(layout_);
         constraints.append(constraint);
     }
 
+    ac4_constraints_cache_ = constraints;
+    ac4_constraints_cache_size_ = rect_.size;
+    ac4_constraints_cache_layout_ = cell_layout_;
     return constraints;
 }
 
+Ref<WFCProblemNative> WFC2DProblemNative::clone_problem() {
+    Ref<WFC2DProblemNative> clone = create_sub_problem(rect_);
+    clone->renderable_rect_ = renderable_rect_;
+    clone->edges_rect_ = edges_rect_;
+    clone->init_read_rects_ = init_read_rects_.duplicate();
+    clone->precondition_domains_ = precondition_domains_.duplicate();
+    clone->precondition_solutions_ = precondition_solutions_;
+    clone->precondition_border_mask_ = precondition_border_mask_;
+    return clone;
+}
+
+Vector2i WFC2DProblemNative::get_neighbour(const Vector2i& abs_pos, int direction) const {
+    Vector2i axis = axes_[direction];
+    return abs_pos + axis;
+}
+
+Ref<WFC2DProblemNative> WFC2DProblemNative::create_sub_problem(const Rect2i& rect) {
+    Ref<WFC2DProblemNative> problem;
+    problem.instantiate();
+    problem->initialize_from(Ref<WFC2DProblemNative>(this), rect);
+    return problem;
+}
+
+Vector2i WFC2DProblemNative::get_split_influence_range() const {
+    return rules_->get_influence_range();
+}
+
+void WFC2DProblemNative::prepare_dependency_reads() {
+    ensure_precondition_arrays();
+}
+
+void WFC2DProblemNative::read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                                   const PackedInt64Array& solutions) {
+    const WFC2DProblemNative* source = Object::cast_to<WFC2DProblemNative>(dependency.ptr());
+    if (!source || dependency_index < 0 || dependency_index >= init_read_rects_.size()) {
+        return;
+    }
+
+    blit_precondition_solutions(source->get_rect(), source->to_row_major(solutions), init_read_rects_[dependency_index]);
+}
+
 Vector2i WFC2DProblemNative::get_dependencies_range() const {
     int rx = 0;
     int ry = 0;
@@ -362,32 +696,6 @@ Vector2i WFC2DProblemNative::get_dependencies_range() const {
     return Vector2i(rx, ry);
 }
 
-PackedInt64Array WFC2DProblemNative::split_range(int first, int size, int partitions, int min_partition_size) {
-    if (partitions <= 0) {
-        return PackedInt64Array();
-    }
-
-    int approx_partition_size = size / partitions;
-
-    if (approx_partition_size < min_partition_size) {
-        if (partitions <= 2) {
-            PackedInt64Array res;
-            res.append(first);
-            res.append(first + size);
-            return res;
-        }
-        return split_range(first, size, partitions - 1, min_partition_size);
-    }
-
-    PackedInt64Array res;
-    for (int partition = 0; partition < partitions; partition++) {
-        res.append(first + (size * partition) / partitions);
-    }
-    res.append(first + size);
-
-    return res;
-}
-
 TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency_limit) {
     TypedArray<WFCProblemSubProblemNative> empty_result;
 
@@ -397,9 +705,7 @@ TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency
         sub.instantiate();
 
         // Create a copy of this problem
-        Ref<WFC2DProblemNative> problem_copy;
-        problem_copy.instantiate();
-        problem_copy->initialize(rules_, rect_);
+        Ref<WFC2DProblemNative> problem_copy = create_sub_problem(rect_);
         problem_copy->set_renderable_rect(renderable_rect_);
         problem_copy->set_edges_rect(edges_rect_);
 
@@ -414,7 +720,7 @@ TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency
     Vector2i overlap_min = dependency_range / 2;
     Vector2i overlap_max = overlap_min + Vector2i(dependency_range.x % 2, dependency_range.y % 2);
 
-    Vector2i influence_range = rules_->get_influence_range();
+    Vector2i influence_range = get_split_influence_range();
     Vector2i extra_overlap(0, 0);
 
     bool may_split_x = influence_range.x < rect_.size.x;
@@ -470,9 +776,7 @@ TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency
         // Return single sub-problem
         Ref<WFCProblemSubProblemNative> sub;
         sub.instantiate();
-        Ref<WFC2DProblemNative> problem_copy;
-        problem_copy.instantiate();
-        problem_copy->initialize(rules_, rect_);
+        Ref<WFC2DProblemNative> problem_copy = create_sub_problem(rect_);
         problem_copy->set_renderable_rect(renderable_rect_);
         problem_copy->set_edges_rect(edges_rect_);
         sub->initialize(problem_copy, PackedInt64Array());
@@ -485,9 +789,7 @@ TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency
         // Return single sub-problem
         Ref<WFCProblemSubProblemNative> sub;
         sub.instantiate();
-        Ref<WFC2DProblemNative> problem_copy;
-        problem_copy.instantiate();
-        problem_copy->initialize(rules_, rect_);
+        Ref<WFC2DProblemNative> problem_copy = create_sub_problem(rect_);
         problem_copy->set_renderable_rect(renderable_rect_);
         problem_copy->set_edges_rect(edges_rect_);
         sub->initialize(problem_copy, PackedInt64Array());
@@ -520,9 +822,7 @@ TypedArray<WFCProblemSubProblemNative> WFC2DProblemNative::split(int concurrency
         }
 
         // Create sub-problem
-        Ref<WFC2DProblemNative> sub_problem;
-        sub_problem.instantiate();
-        sub_problem->initialize(rules_, sub_rect);
+        Ref<WFC2DProblemNative> sub_problem = create_sub_problem(sub_rect);
         sub_problem->set_renderable_rect(sub_renderable_rect);
         sub_problem->set_edges_rect(edges_rect_);
 
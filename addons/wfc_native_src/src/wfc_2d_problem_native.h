@@ -4,9 +4,14 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/rect2i.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
 #include "wfc_problem_native.h"
 #include "wfc_rules_2d_native.h"
+#include "wfc_2d_cell_layout_native.h"
+
+#include <vector>
 
 namespace godot {
 
@@ -17,6 +22,7 @@ class WFC2DAC4BinaryConstraintNative : public WFCProblemAC4BinaryConstraintNativ
 private:
     Vector2i axis_;
     Rect2i problem_size_;
+    WFC2DCellLayout layout_;
     TypedArray<PackedInt64Array> allowed_tiles_;
 
 protected:
@@ -28,6 +34,12 @@ public:
 
     void initialize(const Vector2i& axis, const Vector2i& size, const Ref<WFCBitMatrixNative>& axis_matrix);
 
+    // Same, with allowed tiles already extracted (WFCRules2DNative::get_supports())
+    void initialize_with_supports(const Vector2i& axis, const Vector2i& size, const TypedArray<PackedInt64Array>& supports);
+
+    // Cell ids follow this layout instead of row-major order
+    void set_cell_layout(const WFC2DCellLayout& layout) { layout_ = layout; }
+
     int get_cell_id(const Vector2i& pos) const;
     Vector2i get_cell_pos(int cell_id) const;
 
@@ -40,7 +52,13 @@ public:
 class WFC2DProblemNative : public WFCProblemNative {
     GDCLASS(WFC2DProblemNative, WFCProblemNative)
 
-private:
+public:
+    enum CellLayout {
+        CELL_LAYOUT_ROW_MAJOR = WFC2DCellLayout::ROW_MAJOR,
+        CELL_LAYOUT_TILED = WFC2DCellLayout::TILED,
+    };
+
+protected:
     Ref<WFCRules2DNative> rules_;
     Rect2i rect_;
     Rect2i renderable_rect_;
@@ -49,17 +67,45 @@ private:
     TypedArray<WFCBitMatrixNative> axis_matrices_;
     int tile_count_ = 0;
 
+    // Order of cell ids in solver state, see WFC2DCellLayout
+    int cell_layout_ = CELL_LAYOUT_ROW_MAJOR;
+    WFC2DCellLayout layout_;
+
+    // Apply preconditions in the same (column-major) order as the GDScript problem,
+    // so that both produce identical results for the same seed. Off by default: the
+    // column-major walk is slower, enable it only when comparing against GDScript.
+    bool gdscript_parity_ = false;
+
     // Precondition data (set from GDScript before solver init)
     TypedArray<WFCBitSetNative> precondition_domains_;  // Per-cell domains (null = full domain)
     PackedInt64Array precondition_solutions_;            // Pre-solved cells (-1 = not solved)
+    // Cells of get_precondition_border_rect() outside the rect with a precondition domain
+    PackedByteArray precondition_border_mask_;
 
     // For multithreaded solving - rects to read from completed neighbors
     TypedArray<Rect2i> init_read_rects_;
 
-    // Helper for split()
-    static PackedInt64Array split_range(int first, int size, int partitions, int min_partition_size);
+    // AC4 constraints depend only on axes and rect size, kept while both stay the same
+    TypedArray<WFCProblemAC4BinaryConstraintNative> ac4_constraints_cache_;
+    Vector2i ac4_constraints_cache_size_;
+    int ac4_constraints_cache_layout_ = CELL_LAYOUT_ROW_MAJOR;
+
+    // Preconditions of one cell combined with edge conditions of rules' edge_domain
+    void apply_precondition(const Ref<WFCSolverStateNative>& state, int cell_id,
+                            const std::vector<Ref<WFCBitSetNative>>& pre_edge_domains);
+    bool has_precondition_domain_at(const Vector2i& abs_pos) const;
+
+    void update_layout() { layout_.configure(rect_.size, static_cast<WFC2DCellLayout::Mode>(cell_layout_)); }
+
+    // Neighbour of a cell (absolute coordinates) in direction axes_[direction]
+    virtual Vector2i get_neighbour(const Vector2i& abs_pos, int direction) const;
+
+    // Problem of the same type and settings over rect, for split() and clone_problem()
+    virtual Ref<WFC2DProblemNative> create_sub_problem(const Rect2i& rect);
+
+    // Influence range used to place and size the cuts of split()
+    virtual Vector2i get_split_influence_range() const;
 
-protected:
     static void _bind_methods();
 
 public:
@@ -68,12 +114,31 @@ public:
 
     void initialize(const Ref<WFCRules2DNative>& rules, const Rect2i& rect);
 
+    // Cheap re-initialization for another rect: shares axes, transposed matrices and
+    // (for equal rect sizes) AC4 constraints of `other` instead of rebuilding them.
+    // Preconditions are cleared. `other` may be this problem itself.
+    void initialize_from(const Ref<WFC2DProblemNative>& other, const Rect2i& rect);
+
     // Property accessors
     Ref<WFCRules2DNative> get_rules() const { return rules_; }
     void set_rules(const Ref<WFCRules2DNative>& val) { rules_ = val; }
 
     Rect2i get_rect() const { return rect_; }
-    void set_rect(const Rect2i& val) { rect_ = val; }
+    void set_rect(const Rect2i& val) {
+        rect_ = val;
+        update_layout();
+    }
+
+    // Non row-major layouts keep neighbouring cells close in memory. Solver states,
+    // preconditions and AC4 data are indexed by cell id; use to_row_major() and
+    // from_row_major() for arrays laid out over the rect. Solvers pick cells by id, so results
+    // match the GDScript solver only in row-major layout; gdscript_parity still applies
+    // preconditions in GDScript's cell order, which works in any layout.
+    int get_cell_layout() const { return cell_layout_; }
+    void set_cell_layout(int val);
+
+    bool get_gdscript_parity() const { return gdscript_parity_; }
+    void set_gdscript_parity(bool val) { gdscript_parity_ = val; }
 
     Rect2i get_renderable_rect() const { return renderable_rect_; }
     void set_renderable_rect(const Rect2i& val) { renderable_rect_ = val; }
@@ -87,9 +152,17 @@ public:
     TypedArray<Vector2i> get_axes() const { return axes_; }
     TypedArray<WFCBitMatrixNative> get_axis_matrices() const { return axis_matrices_; }
 
-    // Coordinate conversion
-    int coord_to_id(const Vector2i& coord) const;
-    Vector2i id_to_coord(int id) const;
+    // Coordinate conversion, coordinates are relative to the rect
+    int coord_to_id(const Vector2i& coord) const { return layout_.coord_to_id(coord); }
+    Vector2i id_to_coord(int id) const { return layout_.id_to_coord(id); }
+
+    // Reorder per-cell values between cell id order and row-major order over the rect.
+    // Return the same array for the row-major layout.
+    PackedInt64Array to_row_major(const PackedInt64Array& cells) const;
+    PackedInt64Array from_row_major(const PackedInt64Array& cells) const;
+
+    // IDs of cells inside `area` (absolute coordinates), clipped to the problem rect
+    PackedInt64Array get_cells_in_rect(const Rect2i& area) const;
 
     // Maximal distances along X and Y axes between a cell and its immediate dependencies
     Vector2i get_dependencies_range() const;
@@ -102,6 +175,26 @@ public:
     void set_precondition_solution(int cell_id, int solution);
     void clear_preconditions();
 
+    // Bulk variants, both laid out row-major over the rect (relative to rect position).
+    // solutions: -1 = not pre-solved. domain_classes: index into a palette of class_count
+    // domains stored one after another as bitset words in palette_words, -1 = no precondition.
+    void set_precondition_solutions(const PackedInt32Array& solutions);
+    void set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count);
+
+    // Allocates precondition arrays for current rect (no-op when already allocated)
+    void ensure_precondition_arrays();
+
+    // Edge conditions are not applied next to cells with a precondition domain, like in
+    // GDScript. For neighbours outside the rect, pass one byte per cell of the border rect
+    // (the rect grown by the dependencies range, row-major), non-zero where constrained.
+    Rect2i get_precondition_border_rect() const;
+    void set_precondition_border_mask(const PackedByteArray& mask);
+    PackedByteArray get_precondition_border_mask() const { return precondition_border_mask_; }
+
+    // Copies solved cells of source_solutions (laid out row-major over source_rect, absolute
+    // coordinates) that fall within read_rect into precondition solutions, one row span at a time.
+    void blit_precondition_solutions(const Rect2i& source_rect, const PackedInt64Array& source_solutions, const Rect2i& read_rect);
+
     // WFCProblemNative overrides
     virtual int get_cell_count() override;
     virtual Ref<WFCBitSetNative> get_default_domain() override;
@@ -109,9 +202,16 @@ public:
     virtual Ref<WFCBitSetNative> compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) override;
     virtual void mark_related_cells(int changed_cell_id, const Callable& mark_cell) override;
     virtual PackedInt64Array get_related_cells(int changed_cell_id) override;
+    // Square of side 2 * radius + 1, clipped to the problem rect
+    virtual PackedInt64Array get_cells_in_radius(int cell_id, int radius) override;
     virtual int pick_divergence_option(TypedArray<int> options) override;
     virtual bool supports_ac4() override;
     virtual TypedArray<WFCProblemAC4BinaryConstraintNative> get_ac4_binary_constraints() override;
+    virtual Ref<WFCProblemNative> clone_problem() override;
+    virtual void prepare_dependency_reads() override;
+    // Blits the part of the dependency within init_read_rects[dependency_index]
+    virtual void read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                           const PackedInt64Array& solutions) override;
 };
 
 } // namespace godot
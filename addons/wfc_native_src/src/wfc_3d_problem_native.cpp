@@ -0,0 +1,675 @@
+#include "wfc_3d_problem_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+namespace godot {
+
+WFCBox3i WFCBox3i::intersection(const WFCBox3i& other) const {
+    Vector3i begin(std::max(position.x, other.position.x), std::max(position.y, other.position.y),
+                   std::max(position.z, other.position.z));
+    Vector3i end(std::min(get_end().x, other.get_end().x), std::min(get_end().y, other.get_end().y),
+                 std::min(get_end().z, other.get_end().z));
+
+    if (end.x <= begin.x || end.y <= begin.y || end.z <= begin.z) {
+        return WFCBox3i(begin, Vector3i(0, 0, 0));
+    }
+    return WFCBox3i(begin, end - begin);
+}
+
+// WFC3DAC4BinaryConstraintNative implementation
+
+void WFC3DAC4BinaryConstraintNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize_with_supports", "axis", "size", "supports"), &WFC3DAC4BinaryConstraintNative::initialize_with_supports);
+    ClassDB::bind_method(D_METHOD("get_cell_id", "pos"), &WFC3DAC4BinaryConstraintNative::get_cell_id);
+    ClassDB::bind_method(D_METHOD("get_cell_pos", "cell_id"), &WFC3DAC4BinaryConstraintNative::get_cell_pos);
+}
+
+WFC3DAC4BinaryConstraintNative::WFC3DAC4BinaryConstraintNative() {
+}
+
+WFC3DAC4BinaryConstraintNative::~WFC3DAC4BinaryConstraintNative() {
+}
+
+void WFC3DAC4BinaryConstraintNative::initialize_with_supports(const Vector3i& axis, const Vector3i& size, const TypedArray<PackedInt64Array>& supports) {
+    axis_ = axis;
+    size_ = size;
+    allowed_tiles_ = supports;
+}
+
+int WFC3DAC4BinaryConstraintNative::get_cell_id(const Vector3i& pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.z < 0 || pos.x >= size_.x || pos.y >= size_.y || pos.z >= size_.z) {
+        return -1;
+    }
+    return pos.x + size_.x * (pos.y + size_.y * pos.z);
+}
+
+Vector3i WFC3DAC4BinaryConstraintNative::get_cell_pos(int cell_id) const {
+    int layer = size_.x * size_.y;
+    return Vector3i(cell_id % size_.x, (cell_id % layer) / size_.x, cell_id / layer);
+}
+
+int WFC3DAC4BinaryConstraintNative::get_dependent(int cell_id) {
+    return get_cell_id(get_cell_pos(cell_id) - axis_);
+}
+
+int WFC3DAC4BinaryConstraintNative::get_dependency(int cell_id) {
+    return get_cell_id(get_cell_pos(cell_id) + axis_);
+}
+
+PackedInt64Array WFC3DAC4BinaryConstraintNative::get_allowed(int dependency_variant) {
+    if (dependency_variant >= 0 && dependency_variant < allowed_tiles_.size()) {
+        return allowed_tiles_[dependency_variant];
+    }
+    return PackedInt64Array();
+}
+
+// WFC3DProblemNative implementation
+
+void WFC3DProblemNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "position", "size"), &WFC3DProblemNative::initialize);
+    ClassDB::bind_method(D_METHOD("initialize_from", "other", "position", "size"), &WFC3DProblemNative::initialize_from);
+
+    ClassDB::bind_method(D_METHOD("get_rules"), &WFC3DProblemNative::get_rules);
+    ClassDB::bind_method(D_METHOD("get_position"), &WFC3DProblemNative::get_position);
+    ClassDB::bind_method(D_METHOD("get_size"), &WFC3DProblemNative::get_size);
+
+    ClassDB::bind_method(D_METHOD("get_renderable_position"), &WFC3DProblemNative::get_renderable_position);
+    ClassDB::bind_method(D_METHOD("set_renderable_position", "val"), &WFC3DProblemNative::set_renderable_position);
+    ClassDB::bind_method(D_METHOD("get_renderable_size"), &WFC3DProblemNative::get_renderable_size);
+    ClassDB::bind_method(D_METHOD("set_renderable_size", "val"), &WFC3DProblemNative::set_renderable_size);
+
+    ClassDB::bind_method(D_METHOD("get_edges_position"), &WFC3DProblemNative::get_edges_position);
+    ClassDB::bind_method(D_METHOD("set_edges_position", "val"), &WFC3DProblemNative::set_edges_position);
+    ClassDB::bind_method(D_METHOD("get_edges_size"), &WFC3DProblemNative::get_edges_size);
+    ClassDB::bind_method(D_METHOD("set_edges_size", "val"), &WFC3DProblemNative::set_edges_size);
+
+    ClassDB::bind_method(D_METHOD("get_axes"), &WFC3DProblemNative::get_axes);
+    ClassDB::bind_method(D_METHOD("get_axis_matrices"), &WFC3DProblemNative::get_axis_matrices);
+
+    ClassDB::bind_method(D_METHOD("coord_to_id", "coord"), &WFC3DProblemNative::coord_to_id);
+    ClassDB::bind_method(D_METHOD("id_to_coord", "id"), &WFC3DProblemNative::id_to_coord);
+    ClassDB::bind_method(D_METHOD("get_dependencies_range"), &WFC3DProblemNative::get_dependencies_range);
+    ClassDB::bind_method(D_METHOD("split", "concurrency_limit"), &WFC3DProblemNative::split);
+
+    ClassDB::bind_method(D_METHOD("set_precondition_domain", "cell_id", "domain"), &WFC3DProblemNative::set_precondition_domain);
+    ClassDB::bind_method(D_METHOD("set_precondition_solution", "cell_id", "solution"), &WFC3DProblemNative::set_precondition_solution);
+    ClassDB::bind_method(D_METHOD("clear_preconditions"), &WFC3DProblemNative::clear_preconditions);
+    ClassDB::bind_method(D_METHOD("set_precondition_solutions", "solutions"), &WFC3DProblemNative::set_precondition_solutions);
+    ClassDB::bind_method(D_METHOD("set_precondition_domains", "palette_words", "domain_classes", "class_count"), &WFC3DProblemNative::set_precondition_domains);
+    ClassDB::bind_method(D_METHOD("get_precondition_border_position"), &WFC3DProblemNative::get_precondition_border_position);
+    ClassDB::bind_method(D_METHOD("get_precondition_border_size"), &WFC3DProblemNative::get_precondition_border_size);
+    ClassDB::bind_method(D_METHOD("set_precondition_border_mask", "mask"), &WFC3DProblemNative::set_precondition_border_mask);
+    ClassDB::bind_method(D_METHOD("get_precondition_border_mask"), &WFC3DProblemNative::get_precondition_border_mask);
+
+    ClassDB::bind_method(D_METHOD("write_to_grid_map", "grid_map", "solutions", "tile_items", "tile_orientations"),
+                         &WFC3DProblemNative::write_to_grid_map, DEFVAL(PackedInt32Array()));
+
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR3I, "renderable_position"), "set_renderable_position", "get_renderable_position");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR3I, "renderable_size"), "set_renderable_size", "get_renderable_size");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR3I, "edges_position"), "set_edges_position", "get_edges_position");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR3I, "edges_size"), "set_edges_size", "get_edges_size");
+}
+
+WFC3DProblemNative::WFC3DProblemNative() {
+}
+
+WFC3DProblemNative::~WFC3DProblemNative() {
+}
+
+void WFC3DProblemNative::initialize(const Ref<WFCRules3DNative>& rules, const Vector3i& position, const Vector3i& size) {
+    ERR_FAIL_COND(rules.is_null());
+
+    rules_ = rules;
+    box_ = WFCBox3i(position, size);
+    renderable_box_ = box_;
+    edges_box_ = box_;
+    tile_count_ = rules->get_tile_count();
+
+    // Forward direction, then the reverse one with the transposed matrix
+    axes_ = TypedArray<Vector3i>();
+    axis_matrices_ = TypedArray<WFCBitMatrixNative>();
+
+    TypedArray<Vector3i> rule_axes = rules->get_axes_3d();
+    TypedArray<WFCBitMatrixNative> rule_matrices = rules->get_axis_matrices();
+
+    for (int i = 0; i < rule_axes.size() && i < rule_matrices.size(); i++) {
+        Vector3i axis = rule_axes[i];
+
+        axes_.append(axis);
+        axis_matrices_.append(rule_matrices[i]);
+
+        axes_.append(-axis);
+        axis_matrices_.append(rules->get_transposed_matrix(i));
+    }
+
+    ac4_constraints_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
+    init_read_boxes_.clear();
+    clear_preconditions();
+}
+
+void WFC3DProblemNative::initialize_from(const Ref<WFC3DProblemNative>& other, const Vector3i& position, const Vector3i& size) {
+    ERR_FAIL_COND(other.is_null());
+
+    if (other.ptr() != this) {
+        rules_ = other->rules_;
+        axes_ = other->axes_;
+        axis_matrices_ = other->axis_matrices_;
+        tile_count_ = other->tile_count_;
+        ac4_constraints_cache_ = other->ac4_constraints_cache_;
+        ac4_constraints_cache_size_ = other->ac4_constraints_cache_size_;
+    }
+
+    box_ = WFCBox3i(position, size);
+    renderable_box_ = box_;
+    edges_box_ = box_;
+    init_read_boxes_.clear();
+    clear_preconditions();
+}
+
+int WFC3DProblemNative::get_cell_count() {
+    return static_cast<int>(box_.get_volume());
+}
+
+Ref<WFCBitSetNative> WFC3DProblemNative::get_default_domain() {
+    Ref<WFCBitSetNative> domain;
+    domain.instantiate();
+    domain->initialize(tile_count_, true);
+    return domain;
+}
+
+void WFC3DProblemNative::ensure_precondition_arrays() {
+    int cell_count = get_cell_count();
+
+    if (precondition_domains_.size() != cell_count) {
+        precondition_domains_.resize(cell_count);
+    }
+    if (precondition_solutions_.size() != cell_count) {
+        precondition_solutions_.resize(cell_count);
+        precondition_solutions_.fill(-1);
+    }
+}
+
+void WFC3DProblemNative::set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain) {
+    ensure_precondition_arrays();
+    ERR_FAIL_INDEX(cell_id, precondition_domains_.size());
+    precondition_domains_[cell_id] = domain;
+}
+
+void WFC3DProblemNative::set_precondition_solution(int cell_id, int solution) {
+    ensure_precondition_arrays();
+    ERR_FAIL_INDEX(cell_id, precondition_solutions_.size());
+    precondition_solutions_[cell_id] = solution;
+}
+
+void WFC3DProblemNative::clear_preconditions() {
+    precondition_domains_.clear();
+    precondition_solutions_.clear();
+    precondition_border_mask_.clear();
+}
+
+WFCBox3i WFC3DProblemNative::get_precondition_border_box() const {
+    Vector3i range = get_dependencies_range();
+    return WFCBox3i(box_.position - range, box_.size + range * 2);
+}
+
+void WFC3DProblemNative::set_precondition_border_mask(const PackedByteArray& mask) {
+    ERR_FAIL_COND_MSG(!mask.is_empty() && mask.size() != get_precondition_border_box().get_volume(),
+                      "Expected one byte per cell of the border box");
+    precondition_border_mask_ = mask;
+}
+
+void WFC3DProblemNative::set_precondition_solutions(const PackedInt32Array& solutions) {
+    ERR_FAIL_COND_MSG(solutions.size() != get_cell_count(), "Expected one solution per cell of the box");
+
+    ensure_precondition_arrays();
+
+    // Cell ids are in array order
+    const int32_t* src = solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+    for (int64_t i = 0; i < solutions.size(); i++) {
+        dst[i] = src[i] >= 0 && src[i] < tile_count_ ? src[i] : -1;
+    }
+}
+
+void WFC3DProblemNative::set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count) {
+    ERR_FAIL_COND_MSG(domain_classes.size() != get_cell_count(), "Expected one domain class per cell of the box");
+    ERR_FAIL_COND(class_count < 0);
+
+    int words_per_domain = class_count > 0 ? palette_words.size() / class_count : 0;
+    int required_words = (tile_count_ + WFCBitSetNative::BITS_PER_INT - 1) / WFCBitSetNative::BITS_PER_INT;
+    ERR_FAIL_COND_MSG(class_count > 0 && (words_per_domain < required_words || words_per_domain * class_count != palette_words.size()),
+                      "Palette does not hold class_count domains of tile_count bits");
+
+    std::vector<Ref<WFCBitSetNative>> palette(class_count);
+    const int64_t* words = palette_words.ptr();
+    for (int c = 0; c < class_count; c++) {
+        palette[c].instantiate();
+        palette[c]->initialize(tile_count_);
+        for (int w = 0; w < required_words; w++) {
+            palette[c]->set_elem(w, words[(int64_t)c * words_per_domain + w]);
+        }
+    }
+
+    ensure_precondition_arrays();
+
+    const int32_t* src = domain_classes.ptr();
+    for (int64_t cell_id = 0; cell_id < domain_classes.size(); cell_id++) {
+        int32_t domain_class = src[cell_id];
+        if (domain_class >= 0 && domain_class < class_count) {
+            precondition_domains_[cell_id] = palette[domain_class];
+        } else {
+            precondition_domains_[cell_id] = Ref<WFCBitSetNative>();
+        }
+    }
+}
+
+void WFC3DProblemNative::blit_precondition_solutions(const WFCBox3i& source, const PackedInt64Array& source_solutions, const WFCBox3i& read) {
+    WFCBox3i region = read.intersection(source).intersection(box_);
+
+    if (!region.has_volume() || source_solutions.size() < source.get_volume()) {
+        return;
+    }
+
+    ensure_precondition_arrays();
+
+    const int64_t* src = source_solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+
+    // One x run at a time, both arrays are laid out x first
+    for (int z = region.position.z; z < region.get_end().z; z++) {
+        for (int y = region.position.y; y < region.get_end().y; y++) {
+            const int64_t* src_row = src + (((int64_t)(z - source.position.z) * source.size.y + (y - source.position.y)) * source.size.x +
+                                            (region.position.x - source.position.x));
+            int64_t* dst_row = dst + coord_to_id(Vector3i(region.position.x, y, z) - box_.position);
+
+            for (int x = 0; x < region.size.x; x++) {
+                int64_t solution = src_row[x];
+                // Skip unsolved (negative entropy) and failed cells
+                if (solution >= 0 && solution != WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                    dst_row[x] = solution;
+                }
+            }
+        }
+    }
+}
+
+void WFC3DProblemNative::populate_initial_state(const Ref<WFCSolverStateNative>& state) {
+    std::vector<Ref<WFCBitSetNative>> pre_edge_domains;
+    Ref<WFCBitSetNative> edge_domain = rules_.is_valid() ? rules_->get_edge_domain() : Ref<WFCBitSetNative>();
+    if (edge_domain.is_valid() && !edge_domain->is_empty()) {
+        pre_edge_domains.reserve(axis_matrices_.size());
+        for (int i = 0; i < axis_matrices_.size(); i++) {
+            Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+            pre_edge_domains.push_back(matrix->transform(edge_domain));
+        }
+    }
+
+    bool has_preconditions = !precondition_solutions_.is_empty() || !precondition_domains_.is_empty();
+
+    if (!has_preconditions && pre_edge_domains.empty()) {
+        return;
+    }
+
+    int cell_count = get_cell_count();
+    for (int cell_id = 0; cell_id < cell_count; cell_id++) {
+        apply_precondition(state, cell_id, pre_edge_domains);
+    }
+}
+
+bool WFC3DProblemNative::has_precondition_domain_at(const Vector3i& abs_pos) const {
+    if (!box_.has_point(abs_pos)) {
+        WFCBox3i border = get_precondition_border_box();
+        if (precondition_border_mask_.size() != border.get_volume() || !border.has_point(abs_pos)) {
+            return false;
+        }
+
+        Vector3i local = abs_pos - border.position;
+        return precondition_border_mask_[local.x + (int64_t)border.size.x * (local.y + (int64_t)border.size.y * local.z)] != 0;
+    }
+
+    int cell_id = coord_to_id(abs_pos - box_.position);
+    if (cell_id >= precondition_domains_.size()) {
+        return false;
+    }
+
+    Ref<WFCBitSetNative> domain = precondition_domains_[cell_id];
+    return domain.is_valid();
+}
+
+void WFC3DProblemNative::apply_precondition(const Ref<WFCSolverStateNative>& state, int cell_id,
+                                            const std::vector<Ref<WFCBitSetNative>>& pre_edge_domains) {
+    if (precondition_solutions_.size() > cell_id && precondition_solutions_[cell_id] >= 0) {
+        state->set_solution(cell_id, precondition_solutions_[cell_id]);
+        return;
+    }
+
+    Ref<WFCBitSetNative> domain;
+    if (precondition_domains_.size() > cell_id) {
+        domain = precondition_domains_[cell_id];
+    }
+
+    // Neighbours with own precondition domain are not treated as edge
+    if (!pre_edge_domains.empty()) {
+        Vector3i abs_pos = id_to_coord(cell_id) + box_.position;
+
+        for (int i = 0; i < axes_.size(); i++) {
+            Vector3i neighbour_pos = abs_pos + Vector3i(axes_[i]);
+
+            if (edges_box_.has_point(neighbour_pos) || has_precondition_domain_at(neighbour_pos)) {
+                continue;
+            }
+
+            domain = domain.is_valid() ? domain->intersect(pre_edge_domains[i]) : pre_edge_domains[i];
+        }
+    }
+
+    if (domain.is_null()) {
+        return;
+    }
+
+    // Conflicting preconditions, the cell is marked failed
+    if (domain->is_empty()) {
+        ERR_PRINT("Precondition yielded an empty domain at " + String(id_to_coord(cell_id) + box_.position));
+    }
+    state->set_domain(cell_id, domain);
+}
+
+Ref<WFCBitSetNative> WFC3DProblemNative::compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) {
+    TypedArray<WFCBitSetNative> cell_domains = state->get_cell_domains();
+    Ref<WFCBitSetNative> current_domain = cell_domains[cell_id];
+    Ref<WFCBitSetNative> res = current_domain->copy();
+
+    Vector3i pos = id_to_coord(cell_id);
+    WFCBox3i local(Vector3i(0, 0, 0), box_.size);
+
+    for (int i = 0; i < axes_.size(); i++) {
+        Vector3i other_pos = pos + Vector3i(axes_[i]);
+
+        if (!local.has_point(other_pos)) {
+            continue;
+        }
+
+        int other_id = coord_to_id(other_pos);
+
+        if (state->get_cell_solution(other_id) == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+            continue;
+        }
+
+        Ref<WFCBitSetNative> other_domain = cell_domains[other_id];
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+        res->intersect_in_place(matrix->transform(other_domain));
+    }
+
+    return res;
+}
+
+void WFC3DProblemNative::mark_related_cells(int changed_cell_id, const Callable& mark_cell) {
+    Vector3i pos = id_to_coord(changed_cell_id);
+    WFCBox3i local(Vector3i(0, 0, 0), box_.size);
+
+    for (int i = 0; i < axes_.size(); i++) {
+        Vector3i other_pos = pos + Vector3i(axes_[i]);
+        if (local.has_point(other_pos)) {
+            mark_cell.call(coord_to_id(other_pos));
+        }
+    }
+}
+
+PackedInt64Array WFC3DProblemNative::get_related_cells(int changed_cell_id) {
+    PackedInt64Array result;
+    Vector3i pos = id_to_coord(changed_cell_id);
+    WFCBox3i local(Vector3i(0, 0, 0), box_.size);
+
+    for (int i = 0; i < axes_.size(); i++) {
+        Vector3i other_pos = pos + Vector3i(axes_[i]);
+        if (local.has_point(other_pos)) {
+            result.append(coord_to_id(other_pos));
+        }
+    }
+
+    return result;
+}
+
+PackedInt64Array WFC3DProblemNative::get_cells_in_radius(int cell_id, int radius) {
+    Vector3i pos = id_to_coord(cell_id);
+    WFCBox3i area = WFCBox3i(pos - Vector3i(radius, radius, radius), Vector3i(radius, radius, radius) * 2 + Vector3i(1, 1, 1))
+        .intersection(WFCBox3i(Vector3i(0, 0, 0), box_.size));
+
+    PackedInt64Array result;
+    result.resize(area.get_volume());
+    int64_t* ptr = result.ptrw();
+
+    for (int z = area.position.z; z < area.get_end().z; z++) {
+        for (int y = area.position.y; y < area.get_end().y; y++) {
+            for (int x = area.position.x; x < area.get_end().x; x++) {
+                *ptr++ = coord_to_id(Vector3i(x, y, z));
+            }
+        }
+    }
+
+    return result;
+}
+
+int WFC3DProblemNative::pick_divergence_option(TypedArray<int> options) {
+    if (rules_.is_null() || !rules_->get_probabilities_enabled() || get_uniform_divergence_options()) {
+        return WFCProblemNative::pick_divergence_option(options);
+    }
+
+    return pick_weighted_option(options, rules_->get_probabilities());
+}
+
+bool WFC3DProblemNative::supports_ac4() {
+    return true;
+}
+
+TypedArray<WFCProblemAC4BinaryConstraintNative> WFC3DProblemNative::get_ac4_binary_constraints() {
+    if (!ac4_constraints_cache_.is_empty() && ac4_constraints_cache_size_ == box_.size) {
+        return ac4_constraints_cache_;
+    }
+
+    TypedArray<WFCProblemAC4BinaryConstraintNative> constraints;
+
+    for (int i = 0; i < axes_.size(); i++) {
+        Vector3i axis = axes_[i];
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
+
+        Ref<WFC3DAC4BinaryConstraintNative> constraint;
+        constraint.instantiate();
+        constraint->initialize_with_supports(axis, box_.size, rules_->get_supports(matrix));
+        constraints.append(constraint);
+    }
+
+    ac4_constraints_cache_ = constraints;
+    ac4_constraints_cache_size_ = box_.size;
+    return constraints;
+}
+
+Ref<WFCProblemNative> WFC3DProblemNative::clone_problem() {
+    Ref<WFC3DProblemNative> clone;
+    clone.instantiate();
+    clone->initialize_from(Ref<WFC3DProblemNative>(this), box_.position, box_.size);
+    clone->renderable_box_ = renderable_box_;
+    clone->edges_box_ = edges_box_;
+    clone->init_read_boxes_ = init_read_boxes_;
+    clone->precondition_domains_ = precondition_domains_.duplicate();
+    clone->precondition_solutions_ = precondition_solutions_;
+    clone->precondition_border_mask_ = precondition_border_mask_;
+    return clone;
+}
+
+void WFC3DProblemNative::prepare_dependency_reads() {
+    ensure_precondition_arrays();
+}
+
+void WFC3DProblemNative::read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                                   const PackedInt64Array& solutions) {
+    const WFC3DProblemNative* source = Object::cast_to<WFC3DProblemNative>(dependency.ptr());
+    if (!source || dependency_index < 0 || dependency_index >= static_cast<int>(init_read_boxes_.size())) {
+        return;
+    }
+
+    blit_precondition_solutions(source->box_, solutions, init_read_boxes_[dependency_index]);
+}
+
+int WFC3DProblemNative::write_to_grid_map(GridMap* grid_map, const PackedInt64Array& solutions,
+                                          const PackedInt32Array& tile_items,
+                                          const PackedInt32Array& tile_orientations) const {
+    ERR_FAIL_NULL_V(grid_map, 0);
+    ERR_FAIL_COND_V_MSG(solutions.size() != box_.get_volume(), 0, "Expected one solution per cell of the box");
+
+    WFCBox3i region = renderable_box_.intersection(box_);
+    const int64_t* src = solutions.ptr();
+    const int32_t* items = tile_items.ptr();
+    const int32_t* orientations = tile_orientations.ptr();
+    const int64_t item_count = tile_items.size();
+    const int64_t orientation_count = tile_orientations.size();
+    int written = 0;
+
+    for (int z = region.position.z; z < region.get_end().z; z++) {
+        for (int y = region.position.y; y < region.get_end().y; y++) {
+            const int64_t* row = src + coord_to_id(Vector3i(region.position.x, y, z) - box_.position);
+
+            for (int x = 0; x < region.size.x; x++) {
+                int64_t tile = row[x];
+                if (tile < 0 || tile >= item_count || items[tile] < 0) {
+                    continue;
+                }
+
+                int orientation = tile < orientation_count ? orientations[tile] : 0;
+                grid_map->set_cell_item(Vector3i(region.position.x + x, y, z), items[tile], orientation);
+                written++;
+            }
+        }
+    }
+
+    return written;
+}
+
+Vector3i WFC3DProblemNative::get_dependencies_range() const {
+    Vector3i res(0, 0, 0);
+
+    for (int i = 0; i < axes_.size(); i++) {
+        Vector3i axis = axes_[i];
+        for (int c = 0; c < 3; c++) {
+            res[c] = std::max(res[c], std::abs(axis[c]));
+        }
+    }
+
+    return res;
+}
+
+Ref<WFC3DProblemNative> WFC3DProblemNative::make_sub_problem(const WFCBox3i& box, const WFCBox3i& renderable_box) {
+    Ref<WFC3DProblemNative> problem;
+    problem.instantiate();
+    problem->initialize_from(Ref<WFC3DProblemNative>(this), box.position, box.size);
+    problem->renderable_box_ = renderable_box;
+    problem->edges_box_ = edges_box_;
+    return problem;
+}
+
+TypedArray<WFCProblemSubProblemNative> WFC3DProblemNative::split(int concurrency_limit) {
+    // Single sub-problem with no dependencies
+    auto single = [this]() {
+        Ref<WFCProblemSubProblemNative> sub;
+        sub.instantiate();
+        sub->initialize(make_sub_problem(box_, renderable_box_), PackedInt64Array());
+        TypedArray<WFCProblemSubProblemNative> res;
+        res.append(sub);
+        return res;
+    };
+
+    if (concurrency_limit < 2 || rules_.is_null()) {
+        return single();
+    }
+
+    Vector3i dependency_range = get_dependencies_range();
+    Vector3i influence_range = rules_->get_influence_range_3d();
+
+    // Overlap of a cut across axis c grows with the area of the cross-section
+    int split_axis = -1;
+    int64_t best_overhead = 0;
+    for (int c = 0; c < 3; c++) {
+        if (influence_range[c] >= box_.size[c]) {
+            continue;
+        }
+
+        int64_t cross_section = box_.get_volume() / std::max(1, box_.size[c]);
+        int64_t overhead = (int64_t)influence_range[c] * cross_section;
+        if (split_axis < 0 || overhead < best_overhead) {
+            split_axis = c;
+            best_overhead = overhead;
+        }
+    }
+
+    if (split_axis < 0) {
+        UtilityFunctions::print_verbose("Could not split the problem. influence_range=(",
+            influence_range.x, ",", influence_range.y, ",", influence_range.z, ")");
+        return single();
+    }
+
+    int extra_overlap = influence_range[split_axis] * 2;
+    int overlap_min = dependency_range[split_axis] / 2;
+    int overlap_max = overlap_min + dependency_range[split_axis] % 2;
+
+    PackedInt64Array partitions = split_range(
+        box_.position[split_axis],
+        box_.size[split_axis],
+        concurrency_limit * 2,
+        dependency_range[split_axis] + extra_overlap * 2
+    );
+
+    int slab_count = static_cast<int>(partitions.size()) - 1;
+    if (slab_count < 3) {
+        UtilityFunctions::print_verbose("Could not split problem. produced_boxes=", slab_count);
+        return single();
+    }
+
+    std::vector<Ref<WFC3DProblemNative>> problems;
+    TypedArray<WFCProblemSubProblemNative> result;
+
+    for (int i = 0; i < slab_count; i++) {
+        WFCBox3i renderable_box = box_;
+        renderable_box.position[split_axis] = static_cast<int>(partitions[i]) - overlap_min;
+        renderable_box.size[split_axis] = static_cast<int>(partitions[i + 1] - partitions[i]) + overlap_min + overlap_max;
+        renderable_box = renderable_box.intersection(box_);
+
+        // Even-indexed sub-problems get extended boxes
+        WFCBox3i sub_box = renderable_box;
+        if ((i & 1) == 0) {
+            sub_box.position[split_axis] -= extra_overlap;
+            sub_box.size[split_axis] += extra_overlap * 2;
+            sub_box = sub_box.intersection(box_);
+        }
+
+        Ref<WFC3DProblemNative> sub_problem = make_sub_problem(sub_box, renderable_box);
+        problems.push_back(sub_problem);
+
+        PackedInt64Array dependencies;
+        if ((i & 1) == 1) {
+            dependencies.append(i - 1);
+            if (i < slab_count - 1) {
+                dependencies.append(i + 1);
+            }
+        }
+
+        Ref<WFCProblemSubProblemNative> sub;
+        sub.instantiate();
+        sub->initialize(sub_problem, dependencies);
+        result.append(sub);
+    }
+
+    // Odd sub-problems read what their neighbours rendered inside their own box
+    for (int i = 1; i < slab_count; i += 2) {
+        WFC3DProblemNative* current = problems[i].ptr();
+        current->init_read_boxes_.push_back(current->box_.intersection(problems[i - 1]->renderable_box_));
+        if (i + 1 < slab_count) {
+            current->init_read_boxes_.push_back(current->box_.intersection(problems[i + 1]->renderable_box_));
+        }
+    }
+
+    return result;
+}
+
+} // namespace godot
@@ -0,0 +1,190 @@
+#ifndef WFC_3D_PROBLEM_NATIVE_H
+#define WFC_3D_PROBLEM_NATIVE_H
+
+#include <godot_cpp/classes/grid_map.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include "wfc_problem_native.h"
+#include "wfc_rules_3d_native.h"
+
+#include <vector>
+
+namespace godot {
+
+// Integer box, the native counterpart of AABBi
+struct WFCBox3i {
+    Vector3i position;
+    Vector3i size;
+
+    WFCBox3i() {}
+    WFCBox3i(const Vector3i& p_position, const Vector3i& p_size) : position(p_position), size(p_size) {}
+
+    Vector3i get_end() const { return position + size; }
+    int64_t get_volume() const { return (int64_t)size.x * size.y * size.z; }
+    bool has_volume() const { return size.x > 0 && size.y > 0 && size.z > 0; }
+    bool has_point(const Vector3i& p) const {
+        return p.x >= position.x && p.y >= position.y && p.z >= position.z &&
+               p.x < position.x + size.x && p.y < position.y + size.y && p.z < position.z + size.z;
+    }
+    WFCBox3i intersection(const WFCBox3i& other) const;
+};
+
+// AC4 Binary Constraint for 3D problems, cell ids x first, then y, then z
+class WFC3DAC4BinaryConstraintNative : public WFCProblemAC4BinaryConstraintNative {
+    GDCLASS(WFC3DAC4BinaryConstraintNative, WFCProblemAC4BinaryConstraintNative)
+
+private:
+    Vector3i axis_;
+    Vector3i size_;
+    TypedArray<PackedInt64Array> allowed_tiles_;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFC3DAC4BinaryConstraintNative();
+    ~WFC3DAC4BinaryConstraintNative();
+
+    // Allowed tiles per dependency tile, see WFCRules2DNative::get_supports()
+    void initialize_with_supports(const Vector3i& axis, const Vector3i& size, const TypedArray<PackedInt64Array>& supports);
+
+    int get_cell_id(const Vector3i& pos) const;
+    Vector3i get_cell_pos(int cell_id) const;
+
+    virtual int get_dependent(int cell_id) override;
+    virtual int get_dependency(int cell_id) override;
+    virtual PackedInt64Array get_allowed(int dependency_variant) override;
+};
+
+// 3D grid WFC problem over a box of cells, port of WFC3DProblem. Cell ids and all per-cell
+// arrays are laid out x first, then y, then z, relative to the box position.
+class WFC3DProblemNative : public WFCProblemNative {
+    GDCLASS(WFC3DProblemNative, WFCProblemNative)
+
+private:
+    Ref<WFCRules3DNative> rules_;
+    WFCBox3i box_;
+    WFCBox3i renderable_box_;
+    WFCBox3i edges_box_;
+    TypedArray<Vector3i> axes_;
+    TypedArray<WFCBitMatrixNative> axis_matrices_;
+    int tile_count_ = 0;
+
+    TypedArray<WFCBitSetNative> precondition_domains_;  // Per-cell domains (null = full domain)
+    PackedInt64Array precondition_solutions_;            // Pre-solved cells (-1 = not solved)
+    // Cells of the border box outside the box with a precondition domain
+    PackedByteArray precondition_border_mask_;
+
+    // Regions read from completed dependencies, one per dependency
+    std::vector<WFCBox3i> init_read_boxes_;
+
+    TypedArray<WFCProblemAC4BinaryConstraintNative> ac4_constraints_cache_;
+    Vector3i ac4_constraints_cache_size_;
+
+    void apply_precondition(const Ref<WFCSolverStateNative>& state, int cell_id,
+                            const std::vector<Ref<WFCBitSetNative>>& pre_edge_domains);
+    bool has_precondition_domain_at(const Vector3i& abs_pos) const;
+    // The box grown by the dependencies range
+    WFCBox3i get_precondition_border_box() const;
+
+    // Copies solved cells of source_solutions (laid out over source) within read into preconditions
+    void blit_precondition_solutions(const WFCBox3i& source, const PackedInt64Array& source_solutions, const WFCBox3i& read);
+
+    Ref<WFC3DProblemNative> make_sub_problem(const WFCBox3i& box, const WFCBox3i& renderable_box);
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFC3DProblemNative();
+    ~WFC3DProblemNative();
+
+    void initialize(const Ref<WFCRules3DNative>& rules, const Vector3i& position, const Vector3i& size);
+
+    // Re-initialization for another box sharing axes, transposed matrices and (for equal
+    // sizes) AC4 constraints of `other`. Preconditions are cleared.
+    void initialize_from(const Ref<WFC3DProblemNative>& other, const Vector3i& position, const Vector3i& size);
+
+    Ref<WFCRules3DNative> get_rules() const { return rules_; }
+
+    Vector3i get_position() const { return box_.position; }
+    Vector3i get_size() const { return box_.size; }
+
+    // Part of the box written by write_to_grid_map(), the whole box unless split
+    Vector3i get_renderable_position() const { return renderable_box_.position; }
+    void set_renderable_position(const Vector3i& val) { renderable_box_.position = val; }
+    Vector3i get_renderable_size() const { return renderable_box_.size; }
+    void set_renderable_size(const Vector3i& val) { renderable_box_.size = val; }
+
+    // Cells outside this box are edge for rules' edge_domain
+    Vector3i get_edges_position() const { return edges_box_.position; }
+    void set_edges_position(const Vector3i& val) { edges_box_.position = val; }
+    Vector3i get_edges_size() const { return edges_box_.size; }
+    void set_edges_size(const Vector3i& val) { edges_box_.size = val; }
+
+    TypedArray<Vector3i> get_axes() const { return axes_; }
+    TypedArray<WFCBitMatrixNative> get_axis_matrices() const { return axis_matrices_; }
+
+    // Coordinates are relative to the box
+    int coord_to_id(const Vector3i& coord) const {
+        return coord.x + box_.size.x * (coord.y + box_.size.y * coord.z);
+    }
+    Vector3i id_to_coord(int id) const {
+        int layer = box_.size.x * box_.size.y;
+        return Vector3i(id % box_.size.x, (id % layer) / box_.size.x, id / layer);
+    }
+
+    // Maximal distances along X, Y and Z between a cell and its immediate dependencies
+    Vector3i get_dependencies_range() const;
+
+    // Precondition methods (call before solver initialize), same as in WFC2DProblemNative
+    void set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain);
+    void set_precondition_solution(int cell_id, int solution);
+    void clear_preconditions();
+    void set_precondition_solutions(const PackedInt32Array& solutions);
+    void set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count);
+    void ensure_precondition_arrays();
+
+    // Edge conditions are not applied next to cells with a precondition domain. For
+    // neighbours outside the box, pass one byte per cell of the border box (x first, then y,
+    // then z), non-zero where constrained.
+    Vector3i get_precondition_border_position() const { return get_precondition_border_box().position; }
+    Vector3i get_precondition_border_size() const { return get_precondition_border_box().size; }
+    void set_precondition_border_mask(const PackedByteArray& mask);
+    PackedByteArray get_precondition_border_mask() const { return precondition_border_mask_; }
+
+    // Sets the items of solved cells within the renderable box in one pass. solutions are in
+    // cell id order (get_cell_solution_or_entropy() or expanded compiled solutions); tile t is
+    // written as tile_items[t] with tile_orientations[t] (0 when not given). Tiles without
+    // item or mapped to a negative item are skipped. Returns the number of cells written.
+    int write_to_grid_map(GridMap* grid_map, const PackedInt64Array& solutions,
+                          const PackedInt32Array& tile_items,
+                          const PackedInt32Array& tile_orientations = PackedInt32Array()) const;
+
+    // Split into slabs across the axis with the least overlap, solved as the strips of
+    // WFC2DProblemNative: even slabs first, odd slabs from the boundaries of both neighbours
+    virtual TypedArray<WFCProblemSubProblemNative> split(int concurrency_limit) override;
+
+    // WFCProblemNative overrides
+    virtual int get_cell_count() override;
+    virtual Ref<WFCBitSetNative> get_default_domain() override;
+    virtual void populate_initial_state(const Ref<WFCSolverStateNative>& state) override;
+    virtual Ref<WFCBitSetNative> compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) override;
+    virtual void mark_related_cells(int changed_cell_id, const Callable& mark_cell) override;
+    virtual PackedInt64Array get_related_cells(int changed_cell_id) override;
+    // Cube of side 2 * radius + 1, clipped to the box
+    virtual PackedInt64Array get_cells_in_radius(int cell_id, int radius) override;
+    virtual int pick_divergence_option(TypedArray<int> options) override;
+    virtual bool supports_ac4() override;
+    virtual TypedArray<WFCProblemAC4BinaryConstraintNative> get_ac4_binary_constraints() override;
+    virtual Ref<WFCProblemNative> clone_problem() override;
+    virtual void prepare_dependency_reads() override;
+    virtual void read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                           const PackedInt64Array& solutions) override;
+};
+
+} // namespace godot
+
+#endif // WFC_3D_PROBLEM_NATIVE_H
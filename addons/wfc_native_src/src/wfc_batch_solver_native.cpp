@@ -0,0 +1,179 @@
+#include "wfc_batch_solver_native.h"
+#include "wfc_generation_scheduler_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace godot {
+
+void WFCBatchSolverNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "settings"), &WFCBatchSolverNative::initialize, DEFVAL(Ref<WFCSolverSettingsNative>()));
+    ClassDB::bind_method(D_METHOD("solve_batch", "rects", "preconditions", "seeds"), &WFCBatchSolverNative::solve_batch, DEFVAL(Array()), DEFVAL(PackedInt64Array()));
+
+    ClassDB::bind_method(D_METHOD("get_settings"), &WFCBatchSolverNative::get_settings);
+    ClassDB::bind_method(D_METHOD("set_settings", "val"), &WFCBatchSolverNative::set_settings);
+    ClassDB::bind_method(D_METHOD("get_cancellation_token"), &WFCBatchSolverNative::get_cancellation_token);
+    ClassDB::bind_method(D_METHOD("set_cancellation_token", "val"), &WFCBatchSolverNative::set_cancellation_token);
+    ClassDB::bind_method(D_METHOD("get_priority"), &WFCBatchSolverNative::get_priority);
+    ClassDB::bind_method(D_METHOD("set_priority", "val"), &WFCBatchSolverNative::set_priority);
+    ClassDB::bind_method(D_METHOD("get_max_workers"), &WFCBatchSolverNative::get_max_workers);
+    ClassDB::bind_method(D_METHOD("set_max_workers", "val"), &WFCBatchSolverNative::set_max_workers);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "settings", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverSettingsNative"), "set_settings", "get_settings");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "cancellation_token", PROPERTY_HINT_RESOURCE_TYPE, "WFCCancellationTokenNative"), "set_cancellation_token", "get_cancellation_token");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_workers"), "set_max_workers", "get_max_workers");
+}
+
+WFCBatchSolverNative::WFCBatchSolverNative() {
+}
+
+WFCBatchSolverNative::~WFCBatchSolverNative() {
+}
+
+void WFCBatchSolverNative::initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings) {
+    ERR_FAIL_COND(rules.is_null());
+
+    // Template rect is irrelevant, problems take their own rect in initialize_from()
+    template_problem_.instantiate();
+    template_problem_->initialize(rules, Rect2i());
+
+    settings_ = settings;
+    if (settings_.is_null()) {
+        settings_.instantiate();
+    }
+}
+
+PackedInt64Array WFCBatchSolverNative::solve_one(WorkerContext& context, const Rect2i& rect, const PackedInt64Array& precondition, int64_t seed) {
+    if (context.problem.is_null()) {
+        context.problem.instantiate();
+        context.solver.instantiate();
+        context.rng.instantiate();
+        context.problem->set_rng(context.rng);
+        context.solver->set_cancellation_token(cancellation_token_);
+    }
+
+    context.problem->initialize_from(template_problem_, rect);
+    if (!precondition.is_empty()) {
+        context.problem->blit_precondition_solutions(rect, precondition, rect);
+    }
+    context.rng->set_seed(static_cast<uint64_t>(seed));
+
+    context.solver->initialize(context.problem, settings_);
+    Ref<WFCSolverStateNative> state = context.solver->solve();
+
+    if (state.is_null() || context.solver->is_cancelled()) {
+        return PackedInt64Array();
+    }
+
+    return context.problem->to_row_major(state->get_cell_solution_or_entropy());
+}
+
+TypedArray<PackedInt64Array> WFCBatchSolverNative::solve_batch(const TypedArray<Rect2i>& rects,
+                                                               const Array& preconditions,
+                                                               const PackedInt64Array& seeds) {
+    TypedArray<PackedInt64Array> result;
+    ERR_FAIL_COND_V_MSG(template_problem_.is_null(), result, "WFCBatchSolverNative is not initialized");
+
+    const int count = static_cast<int>(rects.size());
+
+    // Variants are unpacked on the calling thread, workers only touch plain vectors
+    std::vector<Rect2i> problem_rects(count);
+    std::vector<PackedInt64Array> problem_preconditions(count);
+    std::vector<int64_t> problem_seeds(count);
+    std::vector<PackedInt64Array> solutions(count);
+
+    for (int i = 0; i < count; i++) {
+        problem_rects[i] = rects[i];
+        if (i < preconditions.size() && preconditions[i].get_type() == Variant::PACKED_INT64_ARRAY) {
+            problem_preconditions[i] = preconditions[i];
+        }
+        problem_seeds[i] = i < seeds.size() ? seeds[i] : UtilityFunctions::randi();
+    }
+
+    std::atomic<int> next_problem{0};
+
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    int worker_count = scheduler ? std::min(scheduler->get_max_workers(), count) : 1;
+    if (max_workers_ > 0) {
+        worker_count = std::min(worker_count, max_workers_);
+    }
+
+    // A worker waiting for other jobs could starve the pool, so workers solve inline
+    if (worker_count <= 1 || !scheduler || WFCGenerationSchedulerNative::is_worker_thread()) {
+        WorkerContext context;
+        for (int i = 0; i < count; i++) {
+            solutions[i] = solve_one(context, problem_rects[i], problem_preconditions[i], problem_seeds[i]);
+        }
+    } else {
+        std::vector<WorkerContext> contexts(worker_count);
+        std::mutex done_mutex;
+        std::condition_variable done_condition;
+        int running_jobs = worker_count;
+
+        // Notify under the lock: the waiting thread owns everything captured here
+        auto finish_job = [&]() {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            running_jobs--;
+            done_condition.notify_all();
+        };
+
+        // Problems are taken one at a time, the worker is given up between problems if asked
+        auto solve_problems = [&](int w, WFCGenerationSchedulerNative::Job& self) {
+            while (true) {
+                int i = next_problem.fetch_add(1);
+                if (i >= count) {
+                    break;
+                }
+
+                solutions[i] = solve_one(contexts[w], problem_rects[i], problem_preconditions[i], problem_seeds[i]);
+
+                if (scheduler->should_yield(self)) {
+                    return false;
+                }
+            }
+
+            finish_job();
+            return true;
+        };
+
+        // The scheduler is shutting down (job refused or abandoned): problems nobody has taken
+        // yet are left unsolved, their results stay empty
+        auto drop_problems = [&]() {
+            next_problem.store(count);
+            finish_job();
+        };
+
+        for (int w = 0; w < worker_count; w++) {
+            auto job = std::make_shared<WFCGenerationSchedulerNative::Job>();
+            job->priority.store(priority_);
+            job->run_slice = [&, w](WFCGenerationSchedulerNative::Job& self) {
+                return solve_problems(w, self);
+            };
+            job->abandon = [&](WFCGenerationSchedulerNative::Job&) {
+                drop_problems();
+            };
+
+            if (!scheduler->submit(job)) {
+                drop_problems();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_condition.wait(lock, [&]() { return running_jobs == 0; });
+    }
+
+    result.resize(count);
+    for (int i = 0; i < count; i++) {
+        result[i] = solutions[i];
+    }
+
+    return result;
+}
+
+} // namespace godot
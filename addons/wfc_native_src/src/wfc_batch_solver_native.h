@@ -0,0 +1,77 @@
+#ifndef WFC_BATCH_SOLVER_NATIVE_H
+#define WFC_BATCH_SOLVER_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/random_number_generator.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include "wfc_2d_problem_native.h"
+#include "wfc_rules_2d_native.h"
+#include "wfc_solver_native.h"
+#include "wfc_solver_settings_native.h"
+#include "wfc_cancellation_token_native.h"
+
+namespace godot {
+
+// Solves many small independent 2D problems sharing one set of rules.
+//
+// Rules are compiled once into a template problem (axes, transposed matrices,
+// AC4 constraints per rect size). Problems are distributed over the workers of
+// WFCGenerationSchedulerNative, each worker reusing its own problem, solver and
+// RNG objects for every problem it takes.
+class WFCBatchSolverNative : public RefCounted {
+    GDCLASS(WFCBatchSolverNative, RefCounted)
+
+private:
+    // Objects reused by one worker for all problems it solves
+    struct WorkerContext {
+        Ref<WFC2DProblemNative> problem;
+        Ref<WFCSolverNative> solver;
+        Ref<RandomNumberGenerator> rng;
+    };
+
+    Ref<WFC2DProblemNative> template_problem_;
+    Ref<WFCSolverSettingsNative> settings_;
+    Ref<WFCCancellationTokenNative> cancellation_token_;
+    int priority_ = 0;
+    int max_workers_ = 0;
+
+    PackedInt64Array solve_one(WorkerContext& context, const Rect2i& rect, const PackedInt64Array& precondition, int64_t seed);
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCBatchSolverNative();
+    ~WFCBatchSolverNative();
+
+    void initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings = Ref<WFCSolverSettingsNative>());
+
+    // Solves one problem per rect and blocks until all are done.
+    // preconditions[i] (optional) holds per-cell solutions laid out row-major over rects[i], -1 = free.
+    // seeds[i] (optional) seeds the RNG of problem i; missing seeds are drawn from the global RNG,
+    // so a preceding seed() still makes the whole batch reproducible.
+    // Returns cell_solution_or_entropy per problem, an empty array where solving failed or
+    // where the scheduler shut down before the problem was taken.
+    TypedArray<PackedInt64Array> solve_batch(const TypedArray<Rect2i>& rects,
+                                             const Array& preconditions = Array(),
+                                             const PackedInt64Array& seeds = PackedInt64Array());
+
+    Ref<WFCSolverSettingsNative> get_settings() const { return settings_; }
+    void set_settings(const Ref<WFCSolverSettingsNative>& val) { settings_ = val; }
+
+    Ref<WFCCancellationTokenNative> get_cancellation_token() const { return cancellation_token_; }
+    void set_cancellation_token(const Ref<WFCCancellationTokenNative>& val) { cancellation_token_ = val; }
+
+    // Scheduling priority of batch jobs, see WFCGenerationSchedulerNative
+    int get_priority() const { return priority_; }
+    void set_priority(int val) { priority_ = val; }
+
+    // Upper bound of workers used by one batch, 0 = scheduler limit
+    int get_max_workers() const { return max_workers_; }
+    void set_max_workers(int val) { max_workers_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_BATCH_SOLVER_NATIVE_H
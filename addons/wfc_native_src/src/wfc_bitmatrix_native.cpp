@@ -22,6 +22,8 @@ void WFCBitMatrixNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_height"), &WFCBitMatrixNative::get_height);
     ClassDB::bind_method(D_METHOD("set_height", "val"), &WFCBitMatrixNative::set_height);
     ClassDB::bind_method(D_METHOD("get_row", "index"), &WFCBitMatrixNative::get_row);
+    ClassDB::bind_method(D_METHOD("get_words"), &WFCBitMatrixNative::get_words);
+    ClassDB::bind_method(D_METHOD("set_words", "words"), &WFCBitMatrixNative::set_words);
 
     ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "rows", PROPERTY_HINT_ARRAY_TYPE, "WFCBitSetNative"), "set_rows", "get_rows");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "width"), "set_width", "get_width");
@@ -189,4 +191,34 @@ Ref<WFCBitSetNative> WFCBitMatrixNative::get_row(int index) const {
     return Object::cast_to<WFCBitSetNative>(rows[index]);
 }
 
+PackedInt64Array WFCBitMatrixNative::get_words() const {
+    const int words_per_row = get_words_per_row();
+    PackedInt64Array words;
+    words.resize((int64_t)height_ * words_per_row);
+
+    int64_t* dst = words.ptrw();
+    for (int i = 0; i < height_; i++) {
+        Ref<WFCBitSetNative> row = get_row(i);
+        for (int w = 0; w < words_per_row; w++) {
+            *dst++ = row.is_valid() ? row->get_elem(w) : 0;
+        }
+    }
+
+    return words;
+}
+
+void WFCBitMatrixNative::set_words(const PackedInt64Array& words) {
+    const int words_per_row = get_words_per_row();
+    ERR_FAIL_COND_MSG(words.size() != (int64_t)height_ * words_per_row, "Expected (width + 63) / 64 words per matrix row");
+
+    const int64_t* src = words.ptr();
+    for (int i = 0; i < height_; i++) {
+        Ref<WFCBitSetNative> row = get_row(i);
+        ERR_FAIL_COND(row.is_null());
+        for (int w = 0; w < words_per_row; w++) {
+            row->set_elem(w, *src++);
+        }
+    }
+}
+
 } // namespace godot
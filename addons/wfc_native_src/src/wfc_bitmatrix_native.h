@@ -44,6 +44,11 @@ public:
 
     // Direct row access
     Ref<WFCBitSetNative> get_row(int index) const;
+
+    // All rows as get_words_per_row() words each, rows one after another
+    int get_words_per_row() const { return (width_ + 63) / 64; }
+    PackedInt64Array get_words() const;
+    void set_words(const PackedInt64Array& words);
 };
 
 } // namespace godot
@@ -28,6 +28,7 @@ void WFCBitSetNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("intersects_with", "other"), &WFCBitSetNative::intersects_with);
 
     ClassDB::bind_method(D_METHOD("get_elem", "n"), &WFCBitSetNative::get_elem);
+    ClassDB::bind_method(D_METHOD("set_elem", "n", "value"), &WFCBitSetNative::set_elem);
     ClassDB::bind_method(D_METHOD("to_array"), &WFCBitSetNative::to_array);
     ClassDB::bind_method(D_METHOD("iterator"), &WFCBitSetNative::iterator);
     ClassDB::bind_method(D_METHOD("count_set_bits", "pass_if_more_than"), &WFCBitSetNative::count_set_bits, DEFVAL(MAX_INT_VAL));
@@ -397,6 +398,18 @@ int64_t WFCBitSetNative::get_elem(int n) const {
     }
 }
 
+void WFCBitSetNative::set_elem(int n, int64_t value) {
+    switch (n) {
+        case 0: data0 = value; break;
+        case 1: data1 = value; break;
+        default:
+            if (n - STATIC_ELEMS < dataX.size()) {
+                dataX.set(n - STATIC_ELEMS, value);
+            }
+            break;
+    }
+}
+
 PackedInt64Array WFCBitSetNative::to_array() const {
     PackedInt64Array res;
     // Pre-estimate capacity based on popcount for fewer reallocations
@@ -65,6 +65,8 @@ public:
     bool intersects_with(const Ref<WFCBitSetNative>& other) const;
 
     int64_t get_elem(int n) const;
+    // Bits beyond size are not cleared, callers pass well-formed words
+    void set_elem(int n, int64_t value);
     PackedInt64Array to_array() const;
     PackedInt64Array iterator() const;
     int count_set_bits(int pass_if_more_than = 2147483647) const;
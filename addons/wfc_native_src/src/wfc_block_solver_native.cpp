@@ -0,0 +1,250 @@
+#include "wfc_block_solver_native.h"
+#include "wfc_2d_problem_native.h"
+#include "wfc_solver_state_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
+
+namespace godot {
+
+// Blocks handed to one WFCBatchSolverNative call, bounds precondition memory of a pass
+static const int BLOCKS_PER_BATCH = 64;
+
+void WFCBlockSolverNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "settings"), &WFCBlockSolverNative::initialize, DEFVAL(Ref<WFCSolverSettingsNative>()));
+    ClassDB::bind_method(D_METHOD("solve", "rect", "initial"), &WFCBlockSolverNative::solve, DEFVAL(PackedInt64Array()));
+
+    ClassDB::bind_method(D_METHOD("get_block_size"), &WFCBlockSolverNative::get_block_size);
+    ClassDB::bind_method(D_METHOD("set_block_size", "val"), &WFCBlockSolverNative::set_block_size);
+    ClassDB::bind_method(D_METHOD("get_block_overlap"), &WFCBlockSolverNative::get_block_overlap);
+    ClassDB::bind_method(D_METHOD("set_block_overlap", "val"), &WFCBlockSolverNative::set_block_overlap);
+    ClassDB::bind_method(D_METHOD("get_block_attempts"), &WFCBlockSolverNative::get_block_attempts);
+    ClassDB::bind_method(D_METHOD("set_block_attempts", "val"), &WFCBlockSolverNative::set_block_attempts);
+    ClassDB::bind_method(D_METHOD("get_modify_passes"), &WFCBlockSolverNative::get_modify_passes);
+    ClassDB::bind_method(D_METHOD("set_modify_passes", "val"), &WFCBlockSolverNative::set_modify_passes);
+    ClassDB::bind_method(D_METHOD("get_seed"), &WFCBlockSolverNative::get_seed);
+    ClassDB::bind_method(D_METHOD("set_seed", "val"), &WFCBlockSolverNative::set_seed);
+    ClassDB::bind_method(D_METHOD("get_discarded_block_count"), &WFCBlockSolverNative::get_discarded_block_count);
+    ClassDB::bind_method(D_METHOD("get_settings"), &WFCBlockSolverNative::get_settings);
+    ClassDB::bind_method(D_METHOD("set_settings", "val"), &WFCBlockSolverNative::set_settings);
+    ClassDB::bind_method(D_METHOD("get_cancellation_token"), &WFCBlockSolverNative::get_cancellation_token);
+    ClassDB::bind_method(D_METHOD("set_cancellation_token", "val"), &WFCBlockSolverNative::set_cancellation_token);
+    ClassDB::bind_method(D_METHOD("get_priority"), &WFCBlockSolverNative::get_priority);
+    ClassDB::bind_method(D_METHOD("set_priority", "val"), &WFCBlockSolverNative::set_priority);
+    ClassDB::bind_method(D_METHOD("get_max_workers"), &WFCBlockSolverNative::get_max_workers);
+    ClassDB::bind_method(D_METHOD("set_max_workers", "val"), &WFCBlockSolverNative::set_max_workers);
+
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "block_size"), "set_block_size", "get_block_size");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "block_overlap"), "set_block_overlap", "get_block_overlap");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "block_attempts"), "set_block_attempts", "get_block_attempts");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "modify_passes"), "set_modify_passes", "get_modify_passes");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "settings", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverSettingsNative"), "set_settings", "get_settings");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "cancellation_token", PROPERTY_HINT_RESOURCE_TYPE, "WFCCancellationTokenNative"), "set_cancellation_token", "get_cancellation_token");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_workers"), "set_max_workers", "get_max_workers");
+}
+
+WFCBlockSolverNative::WFCBlockSolverNative() {
+    batch_.instantiate();
+}
+
+WFCBlockSolverNative::~WFCBlockSolverNative() {
+}
+
+void WFCBlockSolverNative::initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings) {
+    ERR_FAIL_COND(rules.is_null());
+
+    batch_->initialize(rules, settings);
+
+    Ref<WFC2DProblemNative> problem;
+    problem.instantiate();
+    problem->initialize(rules, Rect2i());
+    dependencies_range_ = problem->get_dependencies_range();
+}
+
+Vector2i WFCBlockSolverNative::get_block_step() const {
+    // Blocks two steps apart are solved in parallel, so the gap between them
+    // (block size - 2 * overlap) must cover the dependency range
+    int overlap_x = std::clamp(block_overlap_, 0, std::max((block_size_.x - dependencies_range_.x) / 2, 0));
+    int overlap_y = std::clamp(block_overlap_, 0, std::max((block_size_.y - dependencies_range_.y) / 2, 0));
+
+    return Vector2i(std::max(block_size_.x - overlap_x, 1), std::max(block_size_.y - overlap_y, 1));
+}
+
+void WFCBlockSolverNative::make_block_groups(const Rect2i& rect, const Vector2i& offset, std::vector<std::vector<Rect2i>>& groups) const {
+    Vector2i step = get_block_step();
+    Vector2i origin = rect.position - offset;
+
+    groups.assign(4, std::vector<Rect2i>());
+
+    for (int j = 0; origin.y + j * step.y < rect.get_end().y; j++) {
+        for (int i = 0; origin.x + i * step.x < rect.get_end().x; i++) {
+            Rect2i block = Rect2i(origin + Vector2i(i * step.x, j * step.y), block_size_).intersection(rect);
+            if (block.has_area()) {
+                groups[(i % 2) + 2 * (j % 2)].push_back(block);
+            }
+        }
+    }
+}
+
+void WFCBlockSolverNative::solve_blocks(const Rect2i& rect, PackedInt64Array& map, const std::vector<Rect2i>& blocks, bool keep_solved) {
+    std::vector<Rect2i> pending = blocks;
+
+    for (int attempt = 0; attempt < std::max(block_attempts_, 1) && !pending.empty(); attempt++) {
+        std::vector<Rect2i> failed;
+
+        for (size_t first = 0; first < pending.size(); first += BLOCKS_PER_BATCH) {
+            if (is_cancelled()) {
+                return;
+            }
+
+            size_t last = std::min(pending.size(), first + BLOCKS_PER_BATCH);
+
+            TypedArray<Rect2i> rects;
+            Array preconditions;
+            PackedInt64Array seeds;
+
+            for (size_t b = first; b < last; b++) {
+                const Rect2i& block = pending[b];
+                Rect2i problem_rect = block.grow_individual(dependencies_range_.x, dependencies_range_.y,
+                                                            dependencies_range_.x, dependencies_range_.y)
+                                          .intersection(rect);
+
+                PackedInt64Array precondition;
+                precondition.resize(problem_rect.get_area());
+                int64_t* dst = precondition.ptrw();
+                const int64_t* src = map.ptr();
+
+                for (int y = problem_rect.position.y; y < problem_rect.get_end().y; y++) {
+                    const int64_t* src_row = src + (int64_t)(y - rect.position.y) * rect.size.x + (problem_rect.position.x - rect.position.x);
+                    for (int x = 0; x < problem_rect.size.x; x++) {
+                        bool free = !keep_solved && block.has_point(Vector2i(problem_rect.position.x + x, y));
+                        *dst++ = free ? -1 : src_row[x];
+                    }
+                }
+
+                rects.append(problem_rect);
+                preconditions.append(precondition);
+                seeds.append(rng_->randi());
+            }
+
+            TypedArray<PackedInt64Array> solutions = batch_->solve_batch(rects, preconditions, seeds);
+
+            for (size_t b = first; b < last; b++) {
+                const Rect2i& block = pending[b];
+                Rect2i problem_rect = rects[b - first];
+                PackedInt64Array solution = solutions[b - first];
+
+                bool solved = solution.size() == problem_rect.get_area();
+                int64_t block_x = block.position.x - problem_rect.position.x;
+
+                for (int y = block.position.y; solved && y < block.get_end().y; y++) {
+                    const int64_t* row = solution.ptr() + (int64_t)(y - problem_rect.position.y) * problem_rect.size.x + block_x;
+                    for (int x = 0; x < block.size.x; x++) {
+                        if (row[x] < 0 || row[x] == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                            solved = false;
+                            break;
+                        }
+                    }
+                }
+
+                // A failed block is discarded as a whole, the map keeps its previous cells
+                if (!solved) {
+                    failed.push_back(block);
+                    continue;
+                }
+
+                int64_t* dst = map.ptrw();
+                for (int y = block.position.y; y < block.get_end().y; y++) {
+                    const int64_t* row = solution.ptr() + (int64_t)(y - problem_rect.position.y) * problem_rect.size.x + block_x;
+                    int64_t* map_row = dst + (int64_t)(y - rect.position.y) * rect.size.x + (block.position.x - rect.position.x);
+                    std::copy(row, row + block.size.x, map_row);
+                }
+            }
+        }
+
+        pending.swap(failed);
+    }
+
+    discarded_block_count_ += static_cast<int>(pending.size());
+}
+
+bool WFCBlockSolverNative::is_cancelled() const {
+    Ref<WFCCancellationTokenNative> token = batch_->get_cancellation_token();
+    return token.is_valid() && token->is_cancelled();
+}
+
+PackedInt64Array WFCBlockSolverNative::solve(const Rect2i& rect, const PackedInt64Array& initial) {
+    PackedInt64Array map;
+    ERR_FAIL_COND_V_MSG(dependencies_range_ == Vector2i(), map, "WFCBlockSolverNative is not initialized");
+    ERR_FAIL_COND_V(!rect.has_area(), map);
+    ERR_FAIL_COND_V_MSG(block_size_.x <= dependencies_range_.x || block_size_.y <= dependencies_range_.y, map,
+                        "Block size must exceed the dependency range of the rules");
+
+    if (initial.size() == rect.get_area()) {
+        map = initial;
+    } else {
+        map.resize(rect.get_area());
+        map.fill(-1);
+    }
+
+    rng_.instantiate();
+    rng_->set_seed(static_cast<uint64_t>(seed_ >= 0 ? seed_ : UtilityFunctions::randi()));
+    discarded_block_count_ = 0;
+
+    std::vector<std::vector<Rect2i>> groups;
+
+    // Initial map: solved cells are kept, so overlapping blocks continue what is already there
+    make_block_groups(rect, Vector2i(), groups);
+    for (const std::vector<Rect2i>& group : groups) {
+        solve_blocks(rect, map, group, true);
+    }
+
+    // Modification: every block is solved again from scratch, shifted by half a step on
+    // every other pass so that seams of previous passes end up inside blocks
+    Vector2i half_step = get_block_step() / 2;
+    for (int pass = 0; pass < modify_passes_; pass++) {
+        make_block_groups(rect, pass % 2 == 0 ? half_step : Vector2i(), groups);
+        for (const std::vector<Rect2i>& group : groups) {
+            solve_blocks(rect, map, group, false);
+        }
+    }
+
+    return map;
+}
+
+Ref<WFCSolverSettingsNative> WFCBlockSolverNative::get_settings() const {
+    return batch_->get_settings();
+}
+
+void WFCBlockSolverNative::set_settings(const Ref<WFCSolverSettingsNative>& val) {
+    batch_->set_settings(val);
+}
+
+Ref<WFCCancellationTokenNative> WFCBlockSolverNative::get_cancellation_token() const {
+    return batch_->get_cancellation_token();
+}
+
+void WFCBlockSolverNative::set_cancellation_token(const Ref<WFCCancellationTokenNative>& val) {
+    batch_->set_cancellation_token(val);
+}
+
+int WFCBlockSolverNative::get_priority() const {
+    return batch_->get_priority();
+}
+
+void WFCBlockSolverNative::set_priority(int val) {
+    batch_->set_priority(val);
+}
+
+int WFCBlockSolverNative::get_max_workers() const {
+    return batch_->get_max_workers();
+}
+
+void WFCBlockSolverNative::set_max_workers(int val) {
+    batch_->set_max_workers(val);
+}
+
+} // namespace godot
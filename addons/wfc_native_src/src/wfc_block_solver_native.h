@@ -0,0 +1,102 @@
+#ifndef WFC_BLOCK_SOLVER_NATIVE_H
+#define WFC_BLOCK_SOLVER_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/random_number_generator.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include "wfc_batch_solver_native.h"
+#include "wfc_rules_2d_native.h"
+#include "wfc_solver_settings_native.h"
+#include "wfc_cancellation_token_native.h"
+
+#include <vector>
+
+namespace godot {
+
+// Solves arbitrarily large 2D maps by modifying them in fixed-size blocks.
+//
+// The map is first generated block by block, every block reading the already solved
+// cells around (and inside) it as preconditions. Modification passes then re-solve
+// shifted, overlapping blocks in place, which repairs cells left unsolved and hides
+// block seams. Solver memory only depends on the block size. A failing block is
+// retried with another seed and discarded after block_attempts, leaving the rest of
+// the map untouched. Blocks far enough apart to not see each other are solved in
+// parallel through WFCBatchSolverNative.
+class WFCBlockSolverNative : public RefCounted {
+    GDCLASS(WFCBlockSolverNative, RefCounted)
+
+private:
+    Ref<WFCBatchSolverNative> batch_;
+    Ref<RandomNumberGenerator> rng_;
+    Vector2i dependencies_range_;
+
+    Vector2i block_size_ = Vector2i(32, 32);
+    int block_overlap_ = 4;
+    int block_attempts_ = 3;
+    int modify_passes_ = 1;
+    int64_t seed_ = -1;
+    int discarded_block_count_ = 0;
+
+    // Distance between neighbouring blocks, block size minus the clamped overlap
+    Vector2i get_block_step() const;
+
+    // Blocks of one pass, grouped so that blocks of a group are solved in parallel
+    void make_block_groups(const Rect2i& rect, const Vector2i& offset, std::vector<std::vector<Rect2i>>& groups) const;
+
+    // Solves given blocks in place. With keep_solved, solved cells inside blocks are kept as preconditions.
+    void solve_blocks(const Rect2i& rect, PackedInt64Array& map, const std::vector<Rect2i>& blocks, bool keep_solved);
+
+    bool is_cancelled() const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCBlockSolverNative();
+    ~WFCBlockSolverNative();
+
+    void initialize(const Ref<WFCRules2DNative>& rules, const Ref<WFCSolverSettingsNative>& settings = Ref<WFCSolverSettingsNative>());
+
+    // Solves rect and returns its solutions laid out row-major. Blocks until done.
+    // `initial` (optional, same layout) holds cells to start from, -1 = free.
+    // Cells no block could solve are -1.
+    PackedInt64Array solve(const Rect2i& rect, const PackedInt64Array& initial = PackedInt64Array());
+
+    // Must exceed the dependency range of the rules
+    Vector2i get_block_size() const { return block_size_; }
+    void set_block_size(const Vector2i& val) { block_size_ = val; }
+
+    // Cells shared by neighbouring blocks of a pass. Clamped so that blocks solved
+    // in parallel stay out of each other's dependency range.
+    int get_block_overlap() const { return block_overlap_; }
+    void set_block_overlap(int val) { block_overlap_ = val; }
+
+    int get_block_attempts() const { return block_attempts_; }
+    void set_block_attempts(int val) { block_attempts_ = val; }
+
+    int get_modify_passes() const { return modify_passes_; }
+    void set_modify_passes(int val) { modify_passes_ = val; }
+
+    // Seed for block seeds, -1 = drawn from the global RNG
+    int64_t get_seed() const { return seed_; }
+    void set_seed(int64_t val) { seed_ = val; }
+
+    // Blocks given up after all attempts during the last solve()
+    int get_discarded_block_count() const { return discarded_block_count_; }
+
+    Ref<WFCSolverSettingsNative> get_settings() const;
+    void set_settings(const Ref<WFCSolverSettingsNative>& val);
+
+    Ref<WFCCancellationTokenNative> get_cancellation_token() const;
+    void set_cancellation_token(const Ref<WFCCancellationTokenNative>& val);
+
+    int get_priority() const;
+    void set_priority(int val);
+
+    int get_max_workers() const;
+    void set_max_workers(int val);
+};
+
+} // namespace godot
+
+#endif // WFC_BLOCK_SOLVER_NATIVE_H
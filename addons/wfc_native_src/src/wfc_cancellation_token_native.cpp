@@ -0,0 +1,18 @@
+#include "wfc_cancellation_token_native.h"
+#include <godot_cpp/core/class_db.hpp>
+
+namespace godot {
+
+void WFCCancellationTokenNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("cancel"), &WFCCancellationTokenNative::cancel);
+    ClassDB::bind_method(D_METHOD("reset"), &WFCCancellationTokenNative::reset);
+    ClassDB::bind_method(D_METHOD("is_cancelled"), &WFCCancellationTokenNative::is_cancelled);
+}
+
+WFCCancellationTokenNative::WFCCancellationTokenNative() {
+}
+
+WFCCancellationTokenNative::~WFCCancellationTokenNative() {
+}
+
+} // namespace godot
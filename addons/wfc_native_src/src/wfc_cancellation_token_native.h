@@ -0,0 +1,33 @@
+#ifndef WFC_CANCELLATION_TOKEN_NATIVE_H
+#define WFC_CANCELLATION_TOKEN_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+
+#include <atomic>
+
+namespace godot {
+
+// Cooperative cancellation flag shared between a controlling thread and solvers.
+// Solvers poll it inside propagation and backtracking loops, so a cancel()
+// takes effect in the middle of a solve step rather than after it.
+class WFCCancellationTokenNative : public RefCounted {
+    GDCLASS(WFCCancellationTokenNative, RefCounted)
+
+private:
+    std::atomic<bool> cancelled_{false};
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCCancellationTokenNative();
+    ~WFCCancellationTokenNative();
+
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    bool is_cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+};
+
+} // namespace godot
+
+#endif // WFC_CANCELLATION_TOKEN_NATIVE_H
@@ -0,0 +1,65 @@
+#include "wfc_cell_status_native.h"
+
+namespace godot {
+
+void WFCCellStatusArray::widen() {
+    wide_.resize(narrow_.size());
+    for (size_t i = 0; i < narrow_.size(); i++) {
+        wide_[i] = narrow_[i] == NARROW_FAILED ? WIDE_FAILED : narrow_[i];
+    }
+    narrow_ = std::vector<int16_t>();
+    is_wide_ = true;
+}
+
+void WFCCellStatusArray::assign(const PackedInt64Array& values) {
+    const int64_t* src = values.ptr();
+    int64_t count = values.size();
+
+    bool narrow = true;
+    for (int64_t i = 0; i < count && narrow; i++) {
+        narrow = fits_narrow(src[i]);
+    }
+
+    is_wide_ = !narrow;
+    narrow_.clear();
+    wide_.clear();
+
+    if (is_wide_) {
+        wide_.resize(count);
+        for (int64_t i = 0; i < count; i++) {
+            wide_[i] = src[i] == FAILED ? WIDE_FAILED : static_cast<int32_t>(src[i]);
+        }
+    } else {
+        narrow_.resize(count);
+        for (int64_t i = 0; i < count; i++) {
+            narrow_[i] = src[i] == FAILED ? NARROW_FAILED : static_cast<int16_t>(src[i]);
+        }
+    }
+}
+
+void WFCCellStatusArray::fill(int size, int64_t value) {
+    is_wide_ = !fits_narrow(value);
+    narrow_.clear();
+    wide_.clear();
+
+    if (is_wide_) {
+        wide_.assign(size, value == FAILED ? WIDE_FAILED : static_cast<int32_t>(value));
+    } else {
+        narrow_.assign(size, value == FAILED ? NARROW_FAILED : static_cast<int16_t>(value));
+    }
+}
+
+PackedInt64Array WFCCellStatusArray::to_packed() const {
+    PackedInt64Array result;
+    int count = size();
+    result.resize(count);
+    int64_t* dst = result.ptrw();
+
+    for (int i = 0; i < count; i++) {
+        dst[i] = get(i);
+    }
+
+    return result;
+}
+
+} // namespace godot
@@ -0,0 +1,68 @@
+#ifndef WFC_CELL_STATUS_NATIVE_H
+#define WFC_CELL_STATUS_NATIVE_H
+
+#include <godot_cpp/variant/packed_int64_array.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace godot {
+
+// Compact per-cell solution or entropy, see WFCSolverStateNative::get_cell_solution_or_entropy().
+//
+// Values are kept as int16 while every tile id and entropy fits, and the whole array is
+// widened to int32 the first time one does not. The failed marker is stored as the largest
+// value of the element type. Plain copyable value type, copied with every solver state.
+class WFCCellStatusArray {
+public:
+    static const int64_t FAILED = 9223372036854775807LL;
+
+private:
+    static const int16_t NARROW_FAILED = INT16_MAX;
+    static const int32_t WIDE_FAILED = INT32_MAX;
+
+    std::vector<int16_t> narrow_;
+    std::vector<int32_t> wide_;
+    bool is_wide_ = false;
+
+    static bool fits_narrow(int64_t value) {
+        return value == FAILED || (value > INT16_MIN && value < NARROW_FAILED);
+    }
+
+    void widen();
+
+public:
+    void assign(const PackedInt64Array& values);
+    void fill(int size, int64_t value);
+    PackedInt64Array to_packed() const;
+
+    int size() const { return static_cast<int>(is_wide_ ? wide_.size() : narrow_.size()); }
+    bool is_wide() const { return is_wide_; }
+
+    // Bytes per cell, 2 or 4
+    int get_element_size() const { return is_wide_ ? 4 : 2; }
+
+    int64_t get(int index) const {
+        if (is_wide_) {
+            int32_t value = wide_[index];
+            return value == WIDE_FAILED ? FAILED : value;
+        }
+        int16_t value = narrow_[index];
+        return value == NARROW_FAILED ? FAILED : value;
+    }
+
+    void set(int index, int64_t value) {
+        if (!is_wide_) {
+            if (fits_narrow(value)) {
+                narrow_[index] = value == FAILED ? NARROW_FAILED : static_cast<int16_t>(value);
+                return;
+            }
+            widen();
+        }
+        wide_[index] = value == FAILED ? WIDE_FAILED : static_cast<int32_t>(value);
+    }
+};
+
+} // namespace godot
+
+#endif // WFC_CELL_STATUS_NATIVE_H
@@ -0,0 +1,261 @@
+#include "wfc_generation_scheduler_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <algorithm>
+
+namespace godot {
+
+WFCGenerationSchedulerNative* WFCGenerationSchedulerNative::singleton_ = nullptr;
+thread_local bool WFCGenerationSchedulerNative::is_worker_thread_ = false;
+
+void WFCGenerationSchedulerNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_max_workers"), &WFCGenerationSchedulerNative::get_max_workers);
+    ClassDB::bind_method(D_METHOD("set_max_workers", "val"), &WFCGenerationSchedulerNative::set_max_workers);
+    ClassDB::bind_method(D_METHOD("get_slice_usec"), &WFCGenerationSchedulerNative::get_slice_usec);
+    ClassDB::bind_method(D_METHOD("set_slice_usec", "val"), &WFCGenerationSchedulerNative::set_slice_usec);
+    ClassDB::bind_method(D_METHOD("get_active_job_count"), &WFCGenerationSchedulerNative::get_active_job_count);
+    ClassDB::bind_method(D_METHOD("get_queued_job_count"), &WFCGenerationSchedulerNative::get_queued_job_count);
+    ClassDB::bind_method(D_METHOD("submit_callable", "run_slice", "abandon", "priority"), &WFCGenerationSchedulerNative::submit_callable,
+                         DEFVAL(Callable()), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("shutdown"), &WFCGenerationSchedulerNative::shutdown);
+    ClassDB::bind_static_method(get_class_static(), D_METHOD("get_default_max_workers"), &WFCGenerationSchedulerNative::get_default_max_workers);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_workers"), "set_max_workers", "get_max_workers");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "slice_usec"), "set_slice_usec", "get_slice_usec");
+}
+
+WFCGenerationSchedulerNative::WFCGenerationSchedulerNative() {
+    max_workers_ = get_default_max_workers();
+
+    // Created once, as the engine singleton
+    singleton_ = this;
+}
+
+WFCGenerationSchedulerNative::~WFCGenerationSchedulerNative() {
+    shutdown();
+
+    if (singleton_ == this) {
+        singleton_ = nullptr;
+    }
+}
+
+int WFCGenerationSchedulerNative::get_default_max_workers() {
+    int hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(hw_threads - 1, 1);
+}
+
+void WFCGenerationSchedulerNative::worker_main() {
+    is_worker_thread_ = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        work_available_.wait(lock, [this]() {
+            return stopping_ || (!queue_.empty() && active_workers_ < max_workers_);
+        });
+
+        if (stopping_) {
+            return;
+        }
+
+        JobPtr job = pop_best_locked();
+        active_workers_++;
+        lock.unlock();
+
+        job->slice_start = std::chrono::steady_clock::now();
+        bool finished = job->run_slice(*job);
+
+        lock.lock();
+        active_workers_--;
+
+        if (!finished && stopping_) {
+            lock.unlock();
+            if (job->abandon) {
+                job->abandon(*job);
+            }
+            lock.lock();
+        } else if (!finished) {
+            enqueue_locked(job);
+        }
+
+        work_available_.notify_one();
+    }
+}
+
+void WFCGenerationSchedulerNative::ensure_workers_locked() {
+    // Workers are never stopped when the limit decreases, surplus ones just stay idle
+    while (static_cast<int>(workers_.size()) < max_workers_) {
+        workers_.emplace_back(&WFCGenerationSchedulerNative::worker_main, this);
+    }
+}
+
+void WFCGenerationSchedulerNative::enqueue_locked(const JobPtr& job) {
+    // Re-queued jobs get a new sequence number, so equal jobs take turns
+    job->sequence = next_sequence_++;
+    queue_.push_back(job);
+    update_queue_stats_locked();
+}
+
+WFCGenerationSchedulerNative::JobPtr WFCGenerationSchedulerNative::pop_best_locked() {
+    size_t best = 0;
+
+    for (size_t i = 1; i < queue_.size(); i++) {
+        const Job& a = *queue_[i];
+        const Job& b = *queue_[best];
+
+        int priority_a = a.priority.load();
+        int priority_b = b.priority.load();
+        if (priority_a != priority_b) {
+            if (priority_a > priority_b) best = i;
+            continue;
+        }
+
+        // No deadline sorts after any deadline
+        uint64_t deadline_a = static_cast<uint64_t>(a.deadline.load() - 1);
+        uint64_t deadline_b = static_cast<uint64_t>(b.deadline.load() - 1);
+        if (deadline_a != deadline_b) {
+            if (deadline_a < deadline_b) best = i;
+            continue;
+        }
+
+        if (a.sequence < b.sequence) best = i;
+    }
+
+    JobPtr job = queue_[best];
+    queue_.erase(queue_.begin() + best);
+    update_queue_stats_locked();
+    return job;
+}
+
+void WFCGenerationSchedulerNative::update_queue_stats_locked() {
+    int highest = INT_MIN;
+    for (const JobPtr& job : queue_) {
+        highest = std::max(highest, job->priority.load());
+    }
+
+    highest_queued_priority_.store(highest);
+    queued_count_.store(static_cast<int>(queue_.size()));
+}
+
+bool WFCGenerationSchedulerNative::submit(const JobPtr& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (stopping_) {
+        return false;
+    }
+
+    ensure_workers_locked();
+    enqueue_locked(job);
+    work_available_.notify_one();
+    return true;
+}
+
+bool WFCGenerationSchedulerNative::submit_callable(const Callable& run_slice, const Callable& abandon, int priority) {
+    ERR_FAIL_COND_V(!run_slice.is_valid(), false);
+
+    auto job = std::make_shared<Job>();
+    job->priority.store(priority);
+    job->run_slice = [run_slice](Job&) {
+        return bool(run_slice.call());
+    };
+    if (abandon.is_valid()) {
+        job->abandon = [abandon](Job&) {
+            abandon.call();
+        };
+    }
+    return submit(job);
+}
+
+bool WFCGenerationSchedulerNative::remove(const JobPtr& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = std::find(queue_.begin(), queue_.end(), job);
+    if (it == queue_.end()) {
+        return false;
+    }
+
+    queue_.erase(it);
+    update_queue_stats_locked();
+    return true;
+}
+
+bool WFCGenerationSchedulerNative::should_yield(const Job& job) const {
+    if (stopping_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    if (queued_count_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    int highest_queued = highest_queued_priority_.load(std::memory_order_relaxed);
+    int priority = job.priority.load(std::memory_order_relaxed);
+
+    if (highest_queued > priority) {
+        return true;
+    }
+
+    if (highest_queued < priority) {
+        return false;
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - job.slice_start;
+    return elapsed >= std::chrono::microseconds(slice_usec_.load(std::memory_order_relaxed));
+}
+
+void WFCGenerationSchedulerNative::notify_priorities_changed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    update_queue_stats_locked();
+}
+
+void WFCGenerationSchedulerNative::shutdown() {
+    std::vector<std::thread> workers;
+    std::vector<JobPtr> dropped;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        dropped.swap(queue_);
+        update_queue_stats_locked();
+        workers.swap(workers_);
+    }
+
+    work_available_.notify_all();
+
+    // Running jobs see stopping_ in should_yield() and are abandoned by their workers
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // Outside the lock: abandon callbacks may try to submit follow-up jobs
+    for (const JobPtr& job : dropped) {
+        if (job->abandon) {
+            job->abandon(*job);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+}
+
+int WFCGenerationSchedulerNative::get_max_workers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_workers_;
+}
+
+void WFCGenerationSchedulerNative::set_max_workers(int val) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_workers_ = val > 0 ? val : get_default_max_workers();
+
+    if (!queue_.empty()) {
+        ensure_workers_locked();
+    }
+    work_available_.notify_all();
+}
+
+int WFCGenerationSchedulerNative::get_active_job_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_workers_;
+}
+
+} // namespace godot
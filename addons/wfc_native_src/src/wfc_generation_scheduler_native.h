@@ -0,0 +1,126 @@
+#ifndef WFC_GENERATION_SCHEDULER_NATIVE_H
+#define WFC_GENERATION_SCHEDULER_NATIVE_H
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/callable.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+// Process-wide pool of worker threads shared by all native runners, registered as the
+// engine singleton. Scripts can't create further instances.
+//
+// Jobs run in slices: a job works until it is finished or should_yield() tells it
+// to give the worker up, then it goes back to the queue. Each free worker takes
+// the queued job with the highest priority, then the earliest deadline, then the
+// one waiting longest. A running job yields as soon as a higher priority job is
+// queued, after slice_usec when a job of the same priority is waiting, and on shutdown.
+class WFCGenerationSchedulerNative : public Object {
+    GDCLASS(WFCGenerationSchedulerNative, Object)
+
+public:
+    struct Job {
+        // Runs one slice. Returns true when the job is finished.
+        std::function<bool(Job&)> run_slice;
+
+        // Called instead of further slices when the scheduler drops an unfinished job on
+        // shutdown, so whoever waits for the job is released. Not called for remove().
+        std::function<void(Job&)> abandon;
+
+        // Higher runs first. May be changed while the job is queued or running.
+        std::atomic<int> priority{0};
+
+        // Earlier runs first among equal priorities, in caller defined units
+        // (e.g. Time.get_ticks_msec()). 0 = no deadline.
+        std::atomic<int64_t> deadline{0};
+
+        // Maintained by the scheduler
+        uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point slice_start;
+    };
+
+    using JobPtr = std::shared_ptr<Job>;
+
+private:
+    static WFCGenerationSchedulerNative* singleton_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::vector<std::thread> workers_;
+    std::vector<JobPtr> queue_;
+    int max_workers_ = 1;
+    int active_workers_ = 0;
+    uint64_t next_sequence_ = 0;
+
+    // Read by running jobs in should_yield() without taking the lock
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> slice_usec_{2000};
+    std::atomic<int> queued_count_{0};
+    std::atomic<int> highest_queued_priority_{INT_MIN};
+
+    void worker_main();
+    void ensure_workers_locked();
+    void enqueue_locked(const JobPtr& job);
+    JobPtr pop_best_locked();
+    void update_queue_stats_locked();
+
+    static thread_local bool is_worker_thread_;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCGenerationSchedulerNative();
+    ~WFCGenerationSchedulerNative();
+
+    static WFCGenerationSchedulerNative* get_singleton() { return singleton_; }
+
+    // max(hardware threads - 1, 1)
+    static int get_default_max_workers();
+
+    // Queue a job. It stays scheduled until run_slice returns true, it is removed or the
+    // scheduler shuts down. Returns false when shutting down, the job is not queued then.
+    bool submit(const JobPtr& job);
+
+    // Script counterpart of submit(): run_slice returns true when finished, abandon is
+    // called without arguments when the job is dropped
+    bool submit_callable(const Callable& run_slice, const Callable& abandon = Callable(), int priority = 0);
+
+    // Remove a queued job. Returns false if the job is currently running or not queued.
+    bool remove(const JobPtr& job);
+
+    // Checked by running jobs between solver steps
+    bool should_yield(const Job& job) const;
+
+    // Must be called after priorities of queued jobs were changed
+    void notify_priorities_changed();
+
+    // Stop and join workers. Running jobs are asked to yield, unfinished jobs are dropped
+    // and abandoned. Jobs submitted afterwards start new workers.
+    void shutdown();
+
+    // Jobs waiting for other jobs must not block a worker, they run their work inline
+    static bool is_worker_thread() { return is_worker_thread_; }
+
+    int get_max_workers() const;
+    void set_max_workers(int val);
+
+    int get_slice_usec() const { return slice_usec_.load(); }
+    void set_slice_usec(int val) { slice_usec_.store(val > 0 ? val : 1); }
+
+    int get_active_job_count() const;
+    int get_queued_job_count() const { return queued_count_.load(); }
+};
+
+} // namespace godot
+
+#endif // WFC_GENERATION_SCHEDULER_NATIVE_H
@@ -0,0 +1,704 @@
+#include "wfc_graph_problem_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+
+namespace godot {
+
+// WFCGraphAC4BinaryConstraintNative implementation
+
+void WFCGraphAC4BinaryConstraintNative::_bind_methods() {
+}
+
+WFCGraphAC4BinaryConstraintNative::WFCGraphAC4BinaryConstraintNative() {
+}
+
+WFCGraphAC4BinaryConstraintNative::~WFCGraphAC4BinaryConstraintNative() {
+}
+
+void WFCGraphAC4BinaryConstraintNative::initialize(int cell_count, const TypedArray<PackedInt64Array>& supports) {
+    dependencies_.assign(cell_count, -1);
+    dependents_.assign(cell_count, -1);
+    allowed_tiles_ = supports;
+}
+
+bool WFCGraphAC4BinaryConstraintNative::try_add(int cell_id, int dependency) {
+    if (dependencies_[cell_id] >= 0 || dependents_[dependency] >= 0) {
+        return false;
+    }
+
+    dependencies_[cell_id] = dependency;
+    dependents_[dependency] = cell_id;
+    return true;
+}
+
+int WFCGraphAC4BinaryConstraintNative::get_dependent(int cell_id) {
+    return dependents_[cell_id];
+}
+
+int WFCGraphAC4BinaryConstraintNative::get_dependency(int cell_id) {
+    return dependencies_[cell_id];
+}
+
+PackedInt64Array WFCGraphAC4BinaryConstraintNative::get_allowed(int dependency_variant) {
+    if (dependency_variant >= 0 && dependency_variant < allowed_tiles_.size()) {
+        return allowed_tiles_[dependency_variant];
+    }
+    return PackedInt64Array();
+}
+
+// WFCGraphProblemNative implementation
+
+void WFCGraphProblemNative::Graph::build_incoming() {
+    int node_count = this->node_count();
+
+    in_offsets.assign(node_count + 1, 0);
+    for (int32_t target : targets) {
+        in_offsets[target + 1]++;
+    }
+    for (int i = 0; i < node_count; i++) {
+        in_offsets[i + 1] += in_offsets[i];
+    }
+
+    in_sources.resize(targets.size());
+    std::vector<int32_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+    for (int source = 0; source < node_count; source++) {
+        for (int32_t e = offsets[source]; e < offsets[source + 1]; e++) {
+            in_sources[fill[targets[e]]++] = source;
+        }
+    }
+}
+
+void WFCGraphProblemNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize", "rules", "offsets", "targets", "relations"), &WFCGraphProblemNative::initialize);
+
+    ClassDB::bind_method(D_METHOD("get_rules"), &WFCGraphProblemNative::get_rules);
+    ClassDB::bind_method(D_METHOD("get_node_count"), &WFCGraphProblemNative::get_node_count);
+    ClassDB::bind_method(D_METHOD("get_offsets"), &WFCGraphProblemNative::get_offsets);
+    ClassDB::bind_method(D_METHOD("get_targets"), &WFCGraphProblemNative::get_targets);
+    ClassDB::bind_method(D_METHOD("get_relations"), &WFCGraphProblemNative::get_relations);
+    ClassDB::bind_method(D_METHOD("get_node_ids"), &WFCGraphProblemNative::get_node_ids);
+    ClassDB::bind_method(D_METHOD("get_renderable_mask"), &WFCGraphProblemNative::get_renderable_mask);
+    ClassDB::bind_method(D_METHOD("write_solutions_to", "target_solutions", "solutions"), &WFCGraphProblemNative::write_solutions_to);
+    ClassDB::bind_method(D_METHOD("split", "concurrency_limit"), &WFCGraphProblemNative::split);
+
+    ClassDB::bind_method(D_METHOD("set_precondition_domain", "cell_id", "domain"), &WFCGraphProblemNative::set_precondition_domain);
+    ClassDB::bind_method(D_METHOD("set_precondition_solution", "cell_id", "solution"), &WFCGraphProblemNative::set_precondition_solution);
+    ClassDB::bind_method(D_METHOD("clear_preconditions"), &WFCGraphProblemNative::clear_preconditions);
+    ClassDB::bind_method(D_METHOD("set_precondition_solutions", "solutions"), &WFCGraphProblemNative::set_precondition_solutions);
+    ClassDB::bind_method(D_METHOD("set_precondition_domains", "palette_words", "domain_classes", "class_count"), &WFCGraphProblemNative::set_precondition_domains);
+}
+
+WFCGraphProblemNative::WFCGraphProblemNative() {
+}
+
+WFCGraphProblemNative::~WFCGraphProblemNative() {
+}
+
+bool WFCGraphProblemNative::initialize(const Ref<WFCRules2DNative>& rules, const PackedInt32Array& offsets,
+                                       const PackedInt32Array& targets, const PackedInt32Array& relations) {
+    ERR_FAIL_COND_V(rules.is_null(), false);
+    ERR_FAIL_COND_V_MSG(offsets.is_empty() || offsets[0] != 0, false, "offsets must start with 0");
+    ERR_FAIL_COND_V_MSG(offsets[offsets.size() - 1] != targets.size(), false, "Last offset must be the number of targets");
+    ERR_FAIL_COND_V_MSG(relations.size() != targets.size(), false, "Expected one relation per target");
+
+    int node_count = static_cast<int>(offsets.size()) - 1;
+    int relation_count = static_cast<int>(rules->get_axis_matrices().size()) * 2;
+
+    const int32_t* offsets_ptr = offsets.ptr();
+    for (int i = 0; i < node_count; i++) {
+        ERR_FAIL_COND_V_MSG(offsets_ptr[i + 1] < offsets_ptr[i], false, "offsets must not decrease");
+    }
+
+    const int32_t* targets_ptr = targets.ptr();
+    const int32_t* relations_ptr = relations.ptr();
+    for (int64_t e = 0; e < targets.size(); e++) {
+        ERR_FAIL_COND_V_MSG(targets_ptr[e] < 0 || targets_ptr[e] >= node_count, false, "Edge target out of range");
+        ERR_FAIL_COND_V_MSG(relations_ptr[e] < 0 || relations_ptr[e] >= relation_count, false, "Relation id out of range");
+    }
+
+    std::shared_ptr<Graph> graph = std::make_shared<Graph>();
+    graph->offsets.assign(offsets_ptr, offsets_ptr + offsets.size());
+    graph->targets.assign(targets_ptr, targets_ptr + targets.size());
+    graph->relations.assign(relations_ptr, relations_ptr + relations.size());
+    graph->build_incoming();
+
+    rules_ = rules;
+    graph_ = graph;
+    tile_count_ = rules->get_tile_count();
+
+    // Relation r: forward matrix of axis r / 2 for even r, transposed one for odd r
+    TypedArray<WFCBitMatrixNative> rule_matrices = rules->get_axis_matrices();
+    relation_matrices_.clear();
+    for (int a = 0; a < rule_matrices.size(); a++) {
+        relation_matrices_.push_back(rule_matrices[a]);
+        relation_matrices_.push_back(rules->get_transposed_matrix(a));
+    }
+
+    node_ids_ = PackedInt32Array();
+    renderable_ = PackedByteArray();
+    init_reads_.clear();
+    ac4_constraints_cache_ = TypedArray<WFCProblemAC4BinaryConstraintNative>();
+    ac4_constraints_built_ = false;
+    clear_preconditions();
+    return true;
+}
+
+PackedInt32Array WFCGraphProblemNative::get_offsets() const {
+    PackedInt32Array res;
+    if (graph_) {
+        res.resize(graph_->offsets.size());
+        std::copy(graph_->offsets.begin(), graph_->offsets.end(), res.ptrw());
+    }
+    return res;
+}
+
+PackedInt32Array WFCGraphProblemNative::get_targets() const {
+    PackedInt32Array res;
+    if (graph_) {
+        res.resize(graph_->targets.size());
+        std::copy(graph_->targets.begin(), graph_->targets.end(), res.ptrw());
+    }
+    return res;
+}
+
+PackedInt32Array WFCGraphProblemNative::get_relations() const {
+    PackedInt32Array res;
+    if (graph_) {
+        res.resize(graph_->relations.size());
+        std::copy(graph_->relations.begin(), graph_->relations.end(), res.ptrw());
+    }
+    return res;
+}
+
+PackedInt64Array WFCGraphProblemNative::write_solutions_to(const PackedInt64Array& target_solutions, const PackedInt64Array& solutions) const {
+    PackedInt64Array res = target_solutions;
+    int node_count = get_node_count();
+    ERR_FAIL_COND_V_MSG(solutions.size() != node_count, res, "Expected one solution per node");
+
+    const int64_t* src = solutions.ptr();
+    const uint8_t* renderable = renderable_.is_empty() ? nullptr : renderable_.ptr();
+    int64_t* dst = res.ptrw();
+
+    for (int i = 0; i < node_count; i++) {
+        int64_t solution = src[i];
+        if (solution < 0 || solution == WFCSolverStateNative::CELL_SOLUTION_FAILED || (renderable && !renderable[i])) {
+            continue;
+        }
+
+        int64_t target = node_ids_.is_empty() ? i : node_ids_[i];
+        if (target >= 0 && target < res.size()) {
+            dst[target] = solution;
+        }
+    }
+
+    return res;
+}
+
+int WFCGraphProblemNative::get_cell_count() {
+    return get_node_count();
+}
+
+Ref<WFCBitSetNative> WFCGraphProblemNative::get_default_domain() {
+    Ref<WFCBitSetNative> domain;
+    domain.instantiate();
+    domain->initialize(tile_count_, true);
+    return domain;
+}
+
+void WFCGraphProblemNative::ensure_precondition_arrays() {
+    int cell_count = get_cell_count();
+
+    if (precondition_domains_.size() != cell_count) {
+        precondition_domains_.resize(cell_count);
+    }
+    if (precondition_solutions_.size() != cell_count) {
+        precondition_solutions_.resize(cell_count);
+        precondition_solutions_.fill(-1);
+    }
+}
+
+void WFCGraphProblemNative::set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain) {
+    ensure_precondition_arrays();
+    ERR_FAIL_INDEX(cell_id, precondition_domains_.size());
+    precondition_domains_[cell_id] = domain;
+}
+
+void WFCGraphProblemNative::set_precondition_solution(int cell_id, int solution) {
+    ensure_precondition_arrays();
+    ERR_FAIL_INDEX(cell_id, precondition_solutions_.size());
+    precondition_solutions_[cell_id] = solution;
+}
+
+void WFCGraphProblemNative::clear_preconditions() {
+    precondition_domains_.clear();
+    precondition_solutions_.clear();
+}
+
+void WFCGraphProblemNative::set_precondition_solutions(const PackedInt32Array& solutions) {
+    ERR_FAIL_COND_MSG(solutions.size() != get_cell_count(), "Expected one solution per node");
+
+    ensure_precondition_arrays();
+
+    const int32_t* src = solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+    for (int64_t i = 0; i < solutions.size(); i++) {
+        dst[i] = src[i] >= 0 && src[i] < tile_count_ ? src[i] : -1;
+    }
+}
+
+void WFCGraphProblemNative::set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count) {
+    ERR_FAIL_COND_MSG(domain_classes.size() != get_cell_count(), "Expected one domain class per node");
+    ERR_FAIL_COND(class_count < 0);
+
+    int words_per_domain = class_count > 0 ? palette_words.size() / class_count : 0;
+    int required_words = (tile_count_ + WFCBitSetNative::BITS_PER_INT - 1) / WFCBitSetNative::BITS_PER_INT;
+    ERR_FAIL_COND_MSG(class_count > 0 && (words_per_domain < required_words || words_per_domain * class_count != palette_words.size()),
+                      "Palette does not hold class_count domains of tile_count bits");
+
+    std::vector<Ref<WFCBitSetNative>> palette(class_count);
+    const int64_t* words = palette_words.ptr();
+    for (int c = 0; c < class_count; c++) {
+        palette[c].instantiate();
+        palette[c]->initialize(tile_count_);
+        for (int w = 0; w < required_words; w++) {
+            palette[c]->set_elem(w, words[(int64_t)c * words_per_domain + w]);
+        }
+    }
+
+    ensure_precondition_arrays();
+
+    const int32_t* src = domain_classes.ptr();
+    for (int64_t cell_id = 0; cell_id < domain_classes.size(); cell_id++) {
+        int32_t domain_class = src[cell_id];
+        if (domain_class >= 0 && domain_class < class_count) {
+            precondition_domains_[cell_id] = palette[domain_class];
+        } else {
+            precondition_domains_[cell_id] = Ref<WFCBitSetNative>();
+        }
+    }
+}
+
+void WFCGraphProblemNative::populate_initial_state(const Ref<WFCSolverStateNative>& state) {
+    // A graph has no outside, so there are no edge domains to apply
+    int solution_count = precondition_solutions_.size();
+    int domain_count = precondition_domains_.size();
+
+    for (int cell_id = 0; cell_id < solution_count || cell_id < domain_count; cell_id++) {
+        if (cell_id < solution_count && precondition_solutions_[cell_id] >= 0) {
+            state->set_solution(cell_id, precondition_solutions_[cell_id]);
+            continue;
+        }
+
+        if (cell_id < domain_count) {
+            Ref<WFCBitSetNative> domain = precondition_domains_[cell_id];
+            if (domain.is_null()) {
+                continue;
+            }
+
+            // Conflicting preconditions, the cell is marked failed
+            if (domain->is_empty()) {
+                ERR_PRINT("Precondition yielded an empty domain at node " + String::num_int64(cell_id));
+            }
+            state->set_domain(cell_id, domain);
+        }
+    }
+}
+
+Ref<WFCBitSetNative> WFCGraphProblemNative::compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) {
+    TypedArray<WFCBitSetNative> cell_domains = state->get_cell_domains();
+    Ref<WFCBitSetNative> current_domain = cell_domains[cell_id];
+    Ref<WFCBitSetNative> res = current_domain->copy();
+
+    const Graph& graph = *graph_;
+
+    for (int32_t e = graph.offsets[cell_id]; e < graph.offsets[cell_id + 1]; e++) {
+        int other_id = graph.targets[e];
+
+        if (state->get_cell_solution(other_id) == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+            continue;
+        }
+
+        Ref<WFCBitSetNative> other_domain = cell_domains[other_id];
+        res->intersect_in_place(relation_matrices_[graph.relations[e]]->transform(other_domain));
+    }
+
+    return res;
+}
+
+void WFCGraphProblemNative::mark_related_cells(int changed_cell_id, const Callable& mark_cell) {
+    const Graph& graph = *graph_;
+
+    for (int32_t e = graph.in_offsets[changed_cell_id]; e < graph.in_offsets[changed_cell_id + 1]; e++) {
+        mark_cell.call(graph.in_sources[e]);
+    }
+}
+
+PackedInt64Array WFCGraphProblemNative::get_related_cells(int changed_cell_id) {
+    const Graph& graph = *graph_;
+    int32_t begin = graph.in_offsets[changed_cell_id];
+    int32_t end = graph.in_offsets[changed_cell_id + 1];
+
+    PackedInt64Array result;
+    result.resize(end - begin);
+    std::copy(graph.in_sources.begin() + begin, graph.in_sources.begin() + end, result.ptrw());
+    return result;
+}
+
+int WFCGraphProblemNative::pick_divergence_option(TypedArray<int> options) {
+    if (rules_.is_null() || !rules_->get_probabilities_enabled() || get_uniform_divergence_options()) {
+        return WFCProblemNative::pick_divergence_option(options);
+    }
+
+    return pick_weighted_option(options, rules_->get_probabilities());
+}
+
+bool WFCGraphProblemNative::supports_ac4() {
+    build_ac4_constraints();
+    return !ac4_constraints_cache_.is_empty();
+}
+
+TypedArray<WFCProblemAC4BinaryConstraintNative> WFCGraphProblemNative::get_ac4_binary_constraints() {
+    build_ac4_constraints();
+    return ac4_constraints_cache_;
+}
+
+void WFCGraphProblemNative::build_ac4_constraints() {
+    if (ac4_constraints_built_ || !graph_) {
+        return;
+    }
+    ac4_constraints_built_ = true;
+
+    // The solver needs a single dependency and dependent per cell and constraint, so edges of
+    // each relation are packed greedily into as few one-to-one constraints as they fit
+    const Graph& graph = *graph_;
+    int node_count = graph.node_count();
+    std::vector<std::vector<Ref<WFCGraphAC4BinaryConstraintNative>>> relation_constraints(relation_matrices_.size());
+    int constraint_count = 0;
+
+    for (int cell_id = 0; cell_id < node_count; cell_id++) {
+        for (int32_t e = graph.offsets[cell_id]; e < graph.offsets[cell_id + 1]; e++) {
+            std::vector<Ref<WFCGraphAC4BinaryConstraintNative>>& slots = relation_constraints[graph.relations[e]];
+
+            bool added = false;
+            for (const Ref<WFCGraphAC4BinaryConstraintNative>& constraint : slots) {
+                if (constraint->try_add(cell_id, graph.targets[e])) {
+                    added = true;
+                    break;
+                }
+            }
+
+            if (added) {
+                continue;
+            }
+
+            if (++constraint_count > MAX_AC4_CONSTRAINTS) {
+                UtilityFunctions::print_verbose("Graph needs more than ", MAX_AC4_CONSTRAINTS, " AC4 constraints, using AC3");
+                return;
+            }
+
+            Ref<WFCGraphAC4BinaryConstraintNative> constraint;
+            constraint.instantiate();
+            constraint->initialize(node_count, rules_->get_supports(relation_matrices_[graph.relations[e]]));
+            constraint->try_add(cell_id, graph.targets[e]);
+            slots.push_back(constraint);
+        }
+    }
+
+    for (const std::vector<Ref<WFCGraphAC4BinaryConstraintNative>>& slots : relation_constraints) {
+        for (const Ref<WFCGraphAC4BinaryConstraintNative>& constraint : slots) {
+            ac4_constraints_cache_.append(constraint);
+        }
+    }
+}
+
+Ref<WFCProblemNative> WFCGraphProblemNative::clone_problem() {
+    Ref<WFCGraphProblemNative> clone;
+    clone.instantiate();
+    clone->rules_ = rules_;
+    clone->graph_ = graph_;
+    clone->relation_matrices_ = relation_matrices_;
+    clone->tile_count_ = tile_count_;
+    clone->node_ids_ = node_ids_;
+    clone->renderable_ = renderable_;
+    clone->init_reads_ = init_reads_;
+    clone->ac4_constraints_cache_ = ac4_constraints_cache_;
+    clone->ac4_constraints_built_ = ac4_constraints_built_;
+    clone->precondition_domains_ = precondition_domains_.duplicate();
+    clone->precondition_solutions_ = precondition_solutions_;
+    return clone;
+}
+
+void WFCGraphProblemNative::prepare_dependency_reads() {
+    ensure_precondition_arrays();
+}
+
+void WFCGraphProblemNative::read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                                      const PackedInt64Array& solutions) {
+    if (dependency_index < 0 || dependency_index >= static_cast<int>(init_reads_.size())) {
+        return;
+    }
+
+    ensure_precondition_arrays();
+
+    const PackedInt32Array& own = init_reads_[dependency_index].first;
+    const PackedInt32Array& theirs = init_reads_[dependency_index].second;
+    const int32_t* own_ptr = own.ptr();
+    const int32_t* theirs_ptr = theirs.ptr();
+    const int64_t* src = solutions.ptr();
+    int64_t* dst = precondition_solutions_.ptrw();
+
+    for (int64_t i = 0; i < own.size(); i++) {
+        if (theirs_ptr[i] >= solutions.size()) {
+            continue;
+        }
+
+        int64_t solution = src[theirs_ptr[i]];
+        // Skip unsolved (negative entropy) and failed cells
+        if (solution >= 0 && solution != WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+            dst[own_ptr[i]] = solution;
+        }
+    }
+}
+
+std::vector<int32_t> WFCGraphProblemNative::compute_layers(int& layer_count) const {
+    const Graph& graph = *graph_;
+    int node_count = graph.node_count();
+
+    std::vector<int32_t> layers(node_count, -1);
+    std::vector<uint8_t> seen(node_count, 0);
+    std::vector<int32_t> queue;
+    queue.reserve(node_count);
+
+    // Edges count in both directions, so every edge joins equal or adjacent layers
+    auto for_each_neighbour = [&graph](int node, auto&& fn) {
+        for (int32_t e = graph.offsets[node]; e < graph.offsets[node + 1]; e++) {
+            fn(graph.targets[e]);
+        }
+        for (int32_t e = graph.in_offsets[node]; e < graph.in_offsets[node + 1]; e++) {
+            fn(graph.in_sources[e]);
+        }
+    };
+
+    int first_layer = 0;
+
+    for (int seed = 0; seed < node_count; seed++) {
+        if (layers[seed] >= 0) {
+            continue;
+        }
+
+        // Last node reached from the seed is far from it, which makes long, thin layers
+        queue.clear();
+        queue.push_back(seed);
+        seen[seed] = 1;
+        for (size_t q = 0; q < queue.size(); q++) {
+            for_each_neighbour(queue[q], [&](int32_t other) {
+                if (!seen[other]) {
+                    seen[other] = 1;
+                    queue.push_back(other);
+                }
+            });
+        }
+
+        int start = queue.back();
+        int last_layer = first_layer;
+
+        queue.clear();
+        queue.push_back(start);
+        layers[start] = first_layer;
+        for (size_t q = 0; q < queue.size(); q++) {
+            int node = queue[q];
+            for_each_neighbour(node, [&](int32_t other) {
+                if (layers[other] < 0) {
+                    layers[other] = layers[node] + 1;
+                    last_layer = std::max(last_layer, static_cast<int>(layers[other]));
+                    queue.push_back(other);
+                }
+            });
+        }
+
+        first_layer = last_layer + 1;
+    }
+
+    layer_count = first_layer;
+    return layers;
+}
+
+Ref<WFCGraphProblemNative> WFCGraphProblemNative::make_sub_problem(const std::vector<int32_t>& nodes, const PackedByteArray& renderable) const {
+    const Graph& graph = *graph_;
+    std::vector<int32_t> local_ids(graph.node_count(), -1);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        local_ids[nodes[i]] = static_cast<int32_t>(i);
+    }
+
+    // Edges leaving the node set are dropped, as cells outside the rect are for sub-rects
+    std::shared_ptr<Graph> sub_graph = std::make_shared<Graph>();
+    sub_graph->offsets.reserve(nodes.size() + 1);
+    sub_graph->offsets.push_back(0);
+    for (int32_t node : nodes) {
+        for (int32_t e = graph.offsets[node]; e < graph.offsets[node + 1]; e++) {
+            int32_t target = local_ids[graph.targets[e]];
+            if (target >= 0) {
+                sub_graph->targets.push_back(target);
+                sub_graph->relations.push_back(graph.relations[e]);
+            }
+        }
+        sub_graph->offsets.push_back(static_cast<int32_t>(sub_graph->targets.size()));
+    }
+    sub_graph->build_incoming();
+
+    Ref<WFCGraphProblemNative> problem;
+    problem.instantiate();
+    problem->rules_ = rules_;
+    problem->graph_ = sub_graph;
+    problem->relation_matrices_ = relation_matrices_;
+    problem->tile_count_ = tile_count_;
+    problem->renderable_ = renderable;
+
+    problem->node_ids_.resize(nodes.size());
+    std::copy(nodes.begin(), nodes.end(), problem->node_ids_.ptrw());
+
+    if (!precondition_solutions_.is_empty() || !precondition_domains_.is_empty()) {
+        problem->ensure_precondition_arrays();
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i] < precondition_solutions_.size()) {
+                problem->precondition_solutions_[i] = precondition_solutions_[nodes[i]];
+            }
+            if (nodes[i] < precondition_domains_.size()) {
+                problem->precondition_domains_[i] = precondition_domains_[nodes[i]];
+            }
+        }
+    }
+
+    return problem;
+}
+
+TypedArray<WFCProblemSubProblemNative> WFCGraphProblemNative::split(int concurrency_limit) {
+    // Single sub-problem with no dependencies
+    auto single = [this]() {
+        Ref<WFCProblemSubProblemNative> sub;
+        sub.instantiate();
+        sub->initialize(clone_problem(), PackedInt64Array());
+        TypedArray<WFCProblemSubProblemNative> res;
+        res.append(sub);
+        return res;
+    };
+
+    if (concurrency_limit < 2 || rules_.is_null() || !graph_) {
+        return single();
+    }
+
+    // Longest path of any relation bounds how far a solved cell can constrain others
+    int influence_range = 0;
+    for (const Ref<WFCBitMatrixNative>& matrix : relation_matrices_) {
+        int path = matrix->get_longest_path();
+        if (path <= 0) {
+            UtilityFunctions::print_verbose("Could not split the problem. Rules have unbounded influence");
+            return single();
+        }
+        influence_range = std::max(influence_range, path);
+    }
+
+    int layer_count = 0;
+    std::vector<int32_t> layers = compute_layers(layer_count);
+
+    // Nodes grouped by layer, layer_start[l] is the position of the first node of layer l
+    int node_count = get_node_count();
+    std::vector<int32_t> layer_start(layer_count + 1, 0);
+    for (int32_t layer : layers) {
+        layer_start[layer + 1]++;
+    }
+    for (int l = 0; l < layer_count; l++) {
+        layer_start[l + 1] += layer_start[l];
+    }
+    std::vector<int32_t> ordered(node_count);
+    std::vector<int32_t> position(node_count);
+    {
+        std::vector<int32_t> fill(layer_start.begin(), layer_start.end() - 1);
+        for (int node = 0; node < node_count; node++) {
+            position[node] = fill[layers[node]]++;
+            ordered[position[node]] = node;
+        }
+    }
+
+    // Layers play the role of the split axis of WFC2DProblemNative, edges span at most one
+    const int dependency_range = 1;
+    int extra_overlap = influence_range * 2;
+    int overlap_min = dependency_range / 2;
+    int overlap_max = overlap_min + dependency_range % 2;
+
+    PackedInt64Array partitions = split_range(0, layer_count, concurrency_limit * 2, dependency_range + extra_overlap * 2);
+
+    int band_count = static_cast<int>(partitions.size()) - 1;
+    if (band_count < 3) {
+        UtilityFunctions::print_verbose("Could not split problem. produced_bands=", band_count);
+        return single();
+    }
+
+    std::vector<Ref<WFCGraphProblemNative>> problems;
+    std::vector<std::pair<int, int>> problem_layers;
+    std::vector<std::pair<int, int>> renderable_layers;
+    TypedArray<WFCProblemSubProblemNative> result;
+
+    for (int i = 0; i < band_count; i++) {
+        int render_begin = std::max(0, static_cast<int>(partitions[i]) - overlap_min);
+        int render_end = std::min(layer_count, static_cast<int>(partitions[i + 1]) + overlap_max);
+
+        // Even-indexed sub-problems get extended bands
+        int begin = render_begin;
+        int end = render_end;
+        if ((i & 1) == 0) {
+            begin = std::max(0, begin - extra_overlap);
+            end = std::min(layer_count, end + extra_overlap);
+        }
+
+        std::vector<int32_t> nodes(ordered.begin() + layer_start[begin], ordered.begin() + layer_start[end]);
+        PackedByteArray renderable;
+        renderable.resize(nodes.size());
+        uint8_t* renderable_ptr = renderable.ptrw();
+        for (size_t k = 0; k < nodes.size(); k++) {
+            int layer = layers[nodes[k]];
+            bool in_band = layer >= render_begin && layer < render_end;
+            renderable_ptr[k] = in_band && (renderable_.is_empty() || renderable_[nodes[k]]) ? 1 : 0;
+        }
+
+        Ref<WFCGraphProblemNative> sub_problem = make_sub_problem(nodes, renderable);
+        problems.push_back(sub_problem);
+        problem_layers.push_back(std::make_pair(begin, end));
+        renderable_layers.push_back(std::make_pair(render_begin, render_end));
+
+        PackedInt64Array dependencies;
+        if ((i & 1) == 1) {
+            dependencies.append(i - 1);
+            if (i < band_count - 1) {
+                dependencies.append(i + 1);
+            }
+        }
+
+        Ref<WFCProblemSubProblemNative> sub;
+        sub.instantiate();
+        sub->initialize(sub_problem, dependencies);
+        result.append(sub);
+    }
+
+    // Odd sub-problems read what their neighbours rendered inside their own band. Nodes of
+    // a band are consecutive in `ordered`, so local ids follow from positions.
+    for (int i = 1; i < band_count; i += 2) {
+        for (int j = i - 1; j <= i + 1 && j < band_count; j += 2) {
+            int begin = std::max(problem_layers[i].first, renderable_layers[j].first);
+            int end = std::min(problem_layers[i].second, renderable_layers[j].second);
+
+            PackedInt32Array own;
+            PackedInt32Array theirs;
+            for (int p = layer_start[std::min(begin, end)]; p < layer_start[end]; p++) {
+                own.append(p - layer_start[problem_layers[i].first]);
+                theirs.append(p - layer_start[problem_layers[j].first]);
+            }
+            problems[i]->init_reads_.push_back(std::make_pair(own, theirs));
+        }
+    }
+
+    return result;
+}
+
+} // namespace godot
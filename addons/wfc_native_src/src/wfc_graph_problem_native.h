@@ -0,0 +1,153 @@
+#ifndef WFC_GRAPH_PROBLEM_NATIVE_H
+#define WFC_GRAPH_PROBLEM_NATIVE_H
+
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include "wfc_problem_native.h"
+#include "wfc_rules_2d_native.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace godot {
+
+// AC4 Binary Constraint over an explicit cell-to-cell mapping. Each cell has at most one
+// dependency and one dependent per constraint.
+class WFCGraphAC4BinaryConstraintNative : public WFCProblemAC4BinaryConstraintNative {
+    GDCLASS(WFCGraphAC4BinaryConstraintNative, WFCProblemAC4BinaryConstraintNative)
+
+private:
+    std::vector<int32_t> dependencies_;
+    std::vector<int32_t> dependents_;
+    TypedArray<PackedInt64Array> allowed_tiles_;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCGraphAC4BinaryConstraintNative();
+    ~WFCGraphAC4BinaryConstraintNative();
+
+    void initialize(int cell_count, const TypedArray<PackedInt64Array>& supports);
+
+    // False when cell already has a dependency or dependency already has a dependent
+    bool try_add(int cell_id, int dependency);
+
+    virtual int get_dependent(int cell_id) override;
+    virtual int get_dependency(int cell_id) override;
+    virtual PackedInt64Array get_allowed(int dependency_variant) override;
+};
+
+// WFC problem over an arbitrary graph of cells given in CSR form: edges of cell i are
+// targets[offsets[i]..offsets[i + 1]), each with a relation id from relations.
+//
+// Relation r constrains a cell by its target as direction r of the rules does in
+// WFC2DProblemNative: matrix of axis r / 2, transposed for odd r. Axis vectors of the
+// rules are not used. Constraints are one-way, so list each edge in both directions
+// (with relations r and r ^ 1) for the usual symmetric adjacency.
+class WFCGraphProblemNative : public WFCProblemNative {
+    GDCLASS(WFCGraphProblemNative, WFCProblemNative)
+
+public:
+    // Nodes with many edges of one relation need as many AC4 constraints, and the solver
+    // keeps counters per cell, constraint and tile. Graphs needing more use AC3.
+    static constexpr int MAX_AC4_CONSTRAINTS = 16;
+
+private:
+    struct Graph {
+        std::vector<int32_t> offsets;
+        std::vector<int32_t> targets;
+        std::vector<int32_t> relations;
+        // Incoming edges, for cells affected by a change
+        std::vector<int32_t> in_offsets;
+        std::vector<int32_t> in_sources;
+
+        int node_count() const { return static_cast<int>(offsets.size()) - 1; }
+        void build_incoming();
+    };
+
+    Ref<WFCRules2DNative> rules_;
+    std::shared_ptr<const Graph> graph_;
+    std::vector<Ref<WFCBitMatrixNative>> relation_matrices_;
+    int tile_count_ = 0;
+
+    // Set on sub-problems: ids of the nodes in the problem this one was split from, nodes
+    // the sub-problem is responsible for and nodes read from each dependency (own, theirs)
+    PackedInt32Array node_ids_;
+    PackedByteArray renderable_;
+    std::vector<std::pair<PackedInt32Array, PackedInt32Array>> init_reads_;
+
+    TypedArray<WFCBitSetNative> precondition_domains_;
+    PackedInt64Array precondition_solutions_;
+
+    TypedArray<WFCProblemAC4BinaryConstraintNative> ac4_constraints_cache_;
+    bool ac4_constraints_built_ = false;
+
+    // Packs edges into constraints, gives up (leaving the cache empty) past the limit
+    void build_ac4_constraints();
+
+    // Breadth-first distance from a peripheral node of each connected component, ignoring
+    // edge direction; components are numbered one after another
+    std::vector<int32_t> compute_layers(int& layer_count) const;
+
+    // Induced sub-graph over nodes (ids of this problem), preconditions carried over
+    Ref<WFCGraphProblemNative> make_sub_problem(const std::vector<int32_t>& nodes, const PackedByteArray& renderable) const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCGraphProblemNative();
+    ~WFCGraphProblemNative();
+
+    // offsets has node_count + 1 entries, relations one per target, each below 2 * axis count
+    bool initialize(const Ref<WFCRules2DNative>& rules, const PackedInt32Array& offsets,
+                    const PackedInt32Array& targets, const PackedInt32Array& relations);
+
+    Ref<WFCRules2DNative> get_rules() const { return rules_; }
+    int get_node_count() const { return graph_ ? graph_->node_count() : 0; }
+    PackedInt32Array get_offsets() const;
+    PackedInt32Array get_targets() const;
+    PackedInt32Array get_relations() const;
+
+    PackedInt32Array get_node_ids() const { return node_ids_; }
+    // One byte per node, empty when all nodes are renderable
+    PackedByteArray get_renderable_mask() const { return renderable_; }
+
+    // Copies solved renderable cells of solutions (this problem's cell order) into
+    // target_solutions, indexed by node ids of the problem this one was split from
+    PackedInt64Array write_solutions_to(const PackedInt64Array& target_solutions, const PackedInt64Array& solutions) const;
+
+    // Preconditions (call before solver initialize), one entry per node
+    void set_precondition_domain(int cell_id, const Ref<WFCBitSetNative>& domain);
+    void set_precondition_solution(int cell_id, int solution);
+    void clear_preconditions();
+    void set_precondition_solutions(const PackedInt32Array& solutions);
+    void set_precondition_domains(const PackedInt64Array& palette_words, const PackedInt32Array& domain_classes, int class_count);
+    void ensure_precondition_arrays();
+
+    // Cuts breadth-first layers of the graph into bands solved as the strips of
+    // WFC2DProblemNative: even bands first, odd bands from the boundaries of both neighbours
+    virtual TypedArray<WFCProblemSubProblemNative> split(int concurrency_limit) override;
+
+    // WFCProblemNative overrides
+    virtual int get_cell_count() override;
+    virtual Ref<WFCBitSetNative> get_default_domain() override;
+    virtual void populate_initial_state(const Ref<WFCSolverStateNative>& state) override;
+    virtual Ref<WFCBitSetNative> compute_cell_domain(const Ref<WFCSolverStateNative>& state, int cell_id) override;
+    virtual void mark_related_cells(int changed_cell_id, const Callable& mark_cell) override;
+    virtual PackedInt64Array get_related_cells(int changed_cell_id) override;
+    virtual int pick_divergence_option(TypedArray<int> options) override;
+    // False when the edges do not fit into MAX_AC4_CONSTRAINTS constraints
+    virtual bool supports_ac4() override;
+    virtual TypedArray<WFCProblemAC4BinaryConstraintNative> get_ac4_binary_constraints() override;
+    virtual Ref<WFCProblemNative> clone_problem() override;
+    virtual void prepare_dependency_reads() override;
+    virtual void read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                           const PackedInt64Array& solutions) override;
+};
+
+} // namespace godot
+
+#endif // WFC_GRAPH_PROBLEM_NATIVE_H
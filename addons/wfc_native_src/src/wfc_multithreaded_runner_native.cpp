@@ -12,43 +12,70 @@ void WFCMultithreadedRunnerNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("start", "sub_problems", "settings", "max_threads"), &WFCMultithreadedRunnerNative::start, DEFVAL(0));
     ClassDB::bind_method(D_METHOD("update"), &WFCMultithreadedRunnerNative::update);
     ClassDB::bind_method(D_METHOD("interrupt"), &WFCMultithreadedRunnerNative::interrupt);
+    ClassDB::bind_method(D_METHOD("interrupt_async"), &WFCMultithreadedRunnerNative::interrupt_async);
     ClassDB::bind_method(D_METHOD("get_progress"), &WFCMultithreadedRunnerNative::get_progress);
     ClassDB::bind_method(D_METHOD("is_running"), &WFCMultithreadedRunnerNative::is_running);
     ClassDB::bind_method(D_METHOD("is_started"), &WFCMultithreadedRunnerNative::is_started);
+    ClassDB::bind_method(D_METHOD("is_task_failed", "task_index"), &WFCMultithreadedRunnerNative::is_task_failed);
     ClassDB::bind_method(D_METHOD("get_task_snapshot", "task_index"), &WFCMultithreadedRunnerNative::get_task_snapshot);
     ClassDB::bind_method(D_METHOD("request_snapshots"), &WFCMultithreadedRunnerNative::request_snapshots);
     ClassDB::bind_method(D_METHOD("get_task_count"), &WFCMultithreadedRunnerNative::get_task_count);
 
     ClassDB::bind_method(D_METHOD("get_max_threads"), &WFCMultithreadedRunnerNative::get_max_threads);
     ClassDB::bind_method(D_METHOD("set_max_threads", "val"), &WFCMultithreadedRunnerNative::set_max_threads);
+    ClassDB::bind_method(D_METHOD("get_priority"), &WFCMultithreadedRunnerNative::get_priority);
+    ClassDB::bind_method(D_METHOD("set_priority", "val"), &WFCMultithreadedRunnerNative::set_priority);
+    ClassDB::bind_method(D_METHOD("get_deadline"), &WFCMultithreadedRunnerNative::get_deadline);
+    ClassDB::bind_method(D_METHOD("set_deadline", "val"), &WFCMultithreadedRunnerNative::set_deadline);
+    ClassDB::bind_method(D_METHOD("get_output_store"), &WFCMultithreadedRunnerNative::get_output_store);
+    ClassDB::bind_method(D_METHOD("set_output_store", "val"), &WFCMultithreadedRunnerNative::set_output_store);
 
     ADD_PROPERTY(PropertyInfo(Variant::INT, "max_threads"), "set_max_threads", "get_max_threads");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "deadline"), "set_deadline", "get_deadline");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "output_store", PROPERTY_HINT_RESOURCE_TYPE, "WFCTileStoreNative"), "set_output_store", "get_output_store");
+
+    ADD_SIGNAL(MethodInfo("task_completed", PropertyInfo(Variant::INT, "task_index")));
+    ADD_SIGNAL(MethodInfo("task_failed", PropertyInfo(Variant::INT, "task_index")));
+    ADD_SIGNAL(MethodInfo("all_completed"));
 }
 
 WFCMultithreadedRunnerNative::WFCMultithreadedRunnerNative() {
-    // Default to number of hardware threads minus 1, capped at 4
-    int hw_threads = std::thread::hardware_concurrency();
-    max_threads_ = std::min(std::max(hw_threads - 1, 1), 4);
+    // Per-runner cap on tasks in flight, the global limit is enforced by the scheduler
+    max_threads_ = std::min(WFCGenerationSchedulerNative::get_default_max_workers(), 4);
 }
 
 WFCMultithreadedRunnerNative::~WFCMultithreadedRunnerNative() {
     interrupt();
 }
 
-void WFCMultithreadedRunnerNative::thread_main(int task_index) {
+bool WFCMultithreadedRunnerNative::run_task_slice(int task_index, WFCGenerationSchedulerNative::Job& job) {
     Task* task = tasks_[task_index].get();
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+
+    // Create solver for this task on its first slice
+    if (task->solver.is_null()) {
+        task->solver.instantiate();
+        task->solver->set_cancellation_token(cancellation_token_);
+        task->solver->initialize(task->problem, task->settings);
+        task->state = task->solver->get_current_state();
+    }
 
-    // Create solver for this task
-    task->solver.instantiate();
-    task->solver->initialize(task->problem, task->settings);
-
-    Ref<WFCSolverStateNative> state = task->solver->get_current_state();
+    Ref<WFCSolverStateNative> state = task->state;
+    bool failed = false;
 
-    // Solver loop
+    // Solver loop, gives the worker up between steps when the scheduler asks for it
     while (!interrupted_.load() && state->get_unsolved_cells() > 0) {
         bool done = task->solver->solve_step();
 
-        state = task->solver->get_current_state();
+        // Solver drops its state when backtracking is required but exhausted
+        Ref<WFCSolverStateNative> next_state = task->solver->get_current_state();
+        if (next_state.is_null()) {
+            failed = true;
+            break;
+        }
+
+        state = next_state;
         task->unsolved_cells.store(state->get_unsolved_cells());
 
         // Handle snapshot requests
@@ -61,8 +88,15 @@ void WFCMultithreadedRunnerNative::thread_main(int task_index) {
         if (done || state->get_unsolved_cells() == 0) {
             break;
         }
+
+        if (scheduler && scheduler->should_yield(job)) {
+            task->state = state;
+            return false;
+        }
     }
 
+    task->state = Ref<WFCSolverStateNative>();
+
     // Store final state snapshot before unlinking
     {
         std::lock_guard<std::mutex> lock(task->snapshot_mutex);
@@ -72,7 +106,44 @@ void WFCMultithreadedRunnerNative::thread_main(int task_index) {
     // Free backtracking history
     state->unlink_from_previous();
 
+    // Dependents are started only after completed is set, so they see the copied boundaries
+    if (!failed && !interrupted_.load()) {
+        export_boundary_solutions(task_index, state);
+    }
+
+    if (!interrupted_.load() && output_store_.is_valid()) {
+        Ref<WFC2DProblemNative> problem_2d = Object::cast_to<WFC2DProblemNative>(task->problem.ptr());
+        if (problem_2d.is_valid()) {
+            output_store_->write_problem_state(problem_2d, state);
+        }
+    }
+
+    finish_task(task_index, failed);
+    return true;
+}
+
+void WFCMultithreadedRunnerNative::finish_task(int task_index, bool failed) {
+    Task* task = tasks_[task_index].get();
+    task->failed.store(failed);
+
+    // Everything touching this runner happens under the lock: once in_flight_count_
+    // drops to zero, interrupt() may return and the runner may be destroyed
+    std::lock_guard<std::mutex> lock(task_mutex_);
     task->completed.store(true);
+    completed_count_++;
+    start_available_tasks();
+
+    if (!interrupted_.load()) {
+        call_deferred("emit_signal", failed ? "task_failed" : "task_completed", task_index);
+
+        if (completed_count_ == static_cast<int>(tasks_.size())) {
+            all_done_.store(true);
+            call_deferred("emit_signal", "all_completed");
+        }
+    }
+
+    in_flight_count_--;
+    tasks_idle_.notify_all();
 }
 
 bool WFCMultithreadedRunnerNative::is_task_blocked(int task_index) const {
@@ -90,94 +161,84 @@ bool WFCMultithreadedRunnerNative::is_task_blocked(int task_index) const {
     return false;
 }
 
-void WFCMultithreadedRunnerNative::copy_boundary_solutions(
-    WFC2DProblemNative* target_problem,
-    WFC2DProblemNative* source_problem,
-    const Ref<WFCSolverStateNative>& source_state,
-    const Rect2i& read_rect) {
-
-    if (!read_rect.has_area()) return;
-
-    PackedInt64Array solutions = source_state->get_cell_solution_or_entropy();
-    Rect2i source_rect = source_problem->get_rect();
-    Rect2i target_rect = target_problem->get_rect();
-
-    // Copy solutions within the read_rect
-    for (int x = read_rect.position.x; x < read_rect.position.x + read_rect.size.x; x++) {
-        for (int y = read_rect.position.y; y < read_rect.position.y + read_rect.size.y; y++) {
-            Vector2i pos(x, y);
-
-            // Check if this point is within source problem's rect
-            if (!source_rect.has_point(pos)) continue;
+void WFCMultithreadedRunnerNative::export_boundary_solutions(int task_index, const Ref<WFCSolverStateNative>& state) {
+    Task* task = tasks_[task_index].get();
 
-            // Convert absolute coord to source cell_id
-            int source_local_x = x - source_rect.position.x;
-            int source_local_y = y - source_rect.position.y;
-            int source_cell_id = source_local_y * source_rect.size.x + source_local_x;
+    if (task->problem.is_null() || state.is_null() || task->dependents.empty()) {
+        return;
+    }
 
-            if (source_cell_id < 0 || source_cell_id >= solutions.size()) continue;
+    PackedInt64Array solutions = state->get_cell_solution_or_entropy();
 
-            int solution = solutions[source_cell_id];
-            if (solution >= 0) {  // Has a valid solution
-                // Check if point is within target rect
-                if (!target_rect.has_point(pos)) continue;
+    for (int dependent_index : task->dependents) {
+        Task* dependent = tasks_[dependent_index].get();
+        if (dependent->problem.is_null()) continue;
 
-                // Convert to target cell_id
-                int target_local_x = x - target_rect.position.x;
-                int target_local_y = y - target_rect.position.y;
-                int target_cell_id = target_local_y * target_rect.size.x + target_local_x;
+        // The dependent may list this task more than once, each with its own read region
+        for (int j = 0; j < dependent->dependencies.size(); j++) {
+            if (dependent->dependencies[j] != task_index) continue;
 
-                target_problem->set_precondition_solution(target_cell_id, solution);
-            }
+            std::lock_guard<std::mutex> lock(dependent->precondition_mutex);
+            dependent->problem->read_dependency_solutions(j, task->problem, solutions);
         }
     }
 }
 
 int WFCMultithreadedRunnerNative::start_available_tasks() {
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
     int started = 0;
-    int running_count = 0;
 
-    // Count currently running tasks
-    for (const auto& task : tasks_) {
-        if (task->started.load() && !task->completed.load()) {
-            running_count++;
-        }
+    if (interrupted_.load() || !scheduler) {
+        return 0;
     }
 
-    // Start tasks up to max_threads
-    for (size_t i = 0; i < tasks_.size(); i++) {
-        if (running_count >= max_threads_) {
-            break;
-        }
+    // Submit tasks up to max_threads. A task the scheduler refuses fails right away, which
+    // may unblock tasks listed before it, so the scan repeats until nothing changes.
+    bool rescan = true;
+    while (rescan) {
+        rescan = false;
 
-        Task* task = tasks_[i].get();
+        for (size_t i = 0; i < tasks_.size(); i++) {
+            if (max_threads_ > 0 && in_flight_count_ >= max_threads_) {
+                break;
+            }
 
-        if (!task->started.load() && !is_task_blocked(static_cast<int>(i))) {
-            // Copy boundary solutions from completed dependencies before starting
-            WFC2DProblemNative* problem_2d = Object::cast_to<WFC2DProblemNative>(task->problem.ptr());
-            if (problem_2d) {
-                TypedArray<Rect2i> read_rects = problem_2d->get_init_read_rects();
-
-                for (int j = 0; j < task->dependencies.size(); j++) {
-                    int dep_index = task->dependencies[j];
-                    if (dep_index >= 0 && dep_index < static_cast<int>(tasks_.size())) {
-                        Task* dep_task = tasks_[dep_index].get();
-                        WFC2DProblemNative* dep_problem = Object::cast_to<WFC2DProblemNative>(dep_task->problem.ptr());
-
-                        std::lock_guard<std::mutex> lock(dep_task->snapshot_mutex);
-                        if (dep_problem && dep_task->state_snapshot.is_valid() && j < read_rects.size()) {
-                            // read_rects[j] corresponds to dependencies[j]
-                            Rect2i read_rect = read_rects[j];
-                            copy_boundary_solutions(problem_2d, dep_problem, dep_task->state_snapshot, read_rect);
-                        }
-                    }
+            Task* task = tasks_[i].get();
+
+            if (!task->started.load() && !is_task_blocked(static_cast<int>(i))) {
+                task->started.store(true);
+
+                int task_index = static_cast<int>(i);
+                task->job = std::make_shared<WFCGenerationSchedulerNative::Job>();
+                task->job->priority.store(priority_);
+                task->job->deadline.store(deadline_);
+                task->job->run_slice = [this, task_index](WFCGenerationSchedulerNative::Job& job) {
+                    return run_task_slice(task_index, job);
+                };
+                // Dropped by a shutting down scheduler
+                task->job->abandon = [this, task_index](WFCGenerationSchedulerNative::Job&) {
+                    tasks_[task_index]->state = Ref<WFCSolverStateNative>();
+                    finish_task(task_index, true);
+                };
+
+                in_flight_count_++;
+                if (scheduler->submit(task->job)) {
+                    started++;
+                    continue;
                 }
-            }
 
-            task->started.store(true);
-            task->thread = std::make_unique<std::thread>(&WFCMultithreadedRunnerNative::thread_main, this, static_cast<int>(i));
-            started++;
-            running_count++;
+                in_flight_count_--;
+                task->failed.store(true);
+                task->completed.store(true);
+                completed_count_++;
+                rescan = true;
+
+                call_deferred("emit_signal", "task_failed", task_index);
+                if (completed_count_ == static_cast<int>(tasks_.size())) {
+                    all_done_.store(true);
+                    call_deferred("emit_signal", "all_completed");
+                }
+            }
         }
     }
 
@@ -194,6 +255,11 @@ void WFCMultithreadedRunnerNative::start(const TypedArray<WFCProblemSubProblemNa
     tasks_.clear();
     interrupted_.store(false);
     all_done_.store(false);
+    completed_count_ = 0;
+    in_flight_count_ = 0;
+
+    // Fresh token: jobs of a previous run may still hold the cancelled one
+    cancellation_token_.instantiate();
 
     if (max_threads > 0) {
         max_threads_ = max_threads;
@@ -220,7 +286,30 @@ void WFCMultithreadedRunnerNative::start(const TypedArray<WFCProblemSubProblemNa
         tasks_.push_back(std::move(task));
     }
 
-    // Start initial batch of tasks
+    // Build reverse dependency lists and allocate preconditions of dependent problems up front,
+    // so that worker threads only ever write into already sized arrays
+    for (size_t i = 0; i < tasks_.size(); i++) {
+        Task* task = tasks_[i].get();
+        for (int j = 0; j < task->dependencies.size(); j++) {
+            int dep_index = task->dependencies[j];
+            if (dep_index >= 0 && dep_index < static_cast<int>(tasks_.size())) {
+                tasks_[dep_index]->dependents.push_back(static_cast<int>(i));
+            }
+        }
+
+        if (task->problem.is_valid() && !task->dependencies.is_empty()) {
+            task->problem->prepare_dependency_reads();
+        }
+    }
+
+    if (tasks_.empty()) {
+        all_done_.store(true);
+        call_deferred("emit_signal", "all_completed");
+        return;
+    }
+
+    // Submit initial batch of tasks; the rest are submitted by workers as dependencies complete
+    std::lock_guard<std::mutex> lock(task_mutex_);
     start_available_tasks();
 }
 
@@ -229,42 +318,60 @@ bool WFCMultithreadedRunnerNative::update() {
         return true;
     }
 
-    // Check for completed tasks and join their threads
-    bool any_just_completed = false;
+    return all_done_.load();
+}
+
+void WFCMultithreadedRunnerNative::interrupt_async() {
+    interrupted_.store(true);
+
+    if (cancellation_token_.is_valid()) {
+        cancellation_token_->cancel();
+    }
+
+    // Jobs still waiting in the scheduler queue are dropped right away
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    std::lock_guard<std::mutex> lock(task_mutex_);
+
     for (auto& task : tasks_) {
-        if (task->started.load() && task->completed.load() && task->thread && task->thread->joinable()) {
-            task->thread->join();
-            task->thread.reset();
-            any_just_completed = true;
+        if (task->job && task->started.load() && !task->completed.load()) {
+            if (!scheduler || scheduler->remove(task->job)) {
+                task->completed.store(true);
+                in_flight_count_--;
+            }
         }
     }
 
-    // If any tasks just completed, try to start more
-    if (any_just_completed) {
-        start_available_tasks();
-    }
+    tasks_idle_.notify_all();
+}
 
-    // Check if all tasks are complete
-    bool all_complete = true;
-    for (const auto& task : tasks_) {
-        if (!task->completed.load()) {
-            all_complete = false;
-            break;
+void WFCMultithreadedRunnerNative::interrupt() {
+    interrupt_async();
+
+    // Running jobs stop at their next cancellation check
+    std::unique_lock<std::mutex> lock(task_mutex_);
+    tasks_idle_.wait(lock, [this]() { return in_flight_count_ <= 0; });
+}
+
+void WFCMultithreadedRunnerNative::set_priority(int val) {
+    priority_ = val;
+
+    for (auto& task : tasks_) {
+        if (task->job) {
+            task->job->priority.store(val);
         }
     }
 
-    all_done_.store(all_complete);
-    return all_complete;
+    if (WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton()) {
+        scheduler->notify_priorities_changed();
+    }
 }
 
-void WFCMultithreadedRunnerNative::interrupt() {
-    interrupted_.store(true);
+void WFCMultithreadedRunnerNative::set_deadline(int64_t val) {
+    deadline_ = val;
 
-    // Wait for all threads to finish
     for (auto& task : tasks_) {
-        if (task->thread && task->thread->joinable()) {
-            task->thread->join();
-            task->thread.reset();
+        if (task->job) {
+            task->job->deadline.store(val);
         }
     }
 }
@@ -309,6 +416,14 @@ bool WFCMultithreadedRunnerNative::is_started() const {
     return !tasks_.empty();
 }
 
+bool WFCMultithreadedRunnerNative::is_task_failed(int task_index) const {
+    if (task_index < 0 || task_index >= static_cast<int>(tasks_.size())) {
+        return false;
+    }
+
+    return tasks_[task_index]->failed.load();
+}
+
 Ref<WFCSolverStateNative> WFCMultithreadedRunnerNative::get_task_snapshot(int task_index) {
     if (task_index < 0 || task_index >= static_cast<int>(tasks_.size())) {
         return Ref<WFCSolverStateNative>();
@@ -8,9 +8,12 @@
 #include "wfc_solver_native.h"
 #include "wfc_solver_state_native.h"
 #include "wfc_solver_settings_native.h"
+#include "wfc_cancellation_token_native.h"
+#include "wfc_generation_scheduler_native.h"
+#include "wfc_tile_store_native.h"
 
-#include <thread>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <vector>
 #include <memory>
@@ -20,23 +23,37 @@ namespace godot {
 // Forward declaration
 class WFC2DProblemNative;
 
-// Multithreaded runner using std::thread
+// Multithreaded runner. Sub-problems are submitted as jobs to the process-wide
+// WFCGenerationSchedulerNative, which shares one worker pool between all runners.
+// Scheduling happens on worker threads: a finishing task submits the tasks it unblocks.
+// Progress is reported through task_completed/task_failed/all_completed signals,
+// emitted on the main thread via call_deferred.
 class WFCMultithreadedRunnerNative : public RefCounted {
     GDCLASS(WFCMultithreadedRunnerNative, RefCounted)
 
 private:
-    // Task structure for thread management
+    // Task structure for job management
     struct Task {
         Ref<WFCProblemNative> problem;
         Ref<WFCSolverNative> solver;
         Ref<WFCSolverSettingsNative> settings;
         PackedInt64Array dependencies;
 
-        std::unique_ptr<std::thread> thread;
+        // Indices of tasks that list this task in their dependencies
+        std::vector<int> dependents;
+
+        // Guards writes of dependencies' solutions into this task's preconditions
+        std::mutex precondition_mutex;
+
+        WFCGenerationSchedulerNative::JobPtr job;
         std::atomic<bool> started{false};
         std::atomic<bool> completed{false};
+        std::atomic<bool> failed{false};
         std::atomic<int> unsolved_cells{0};
 
+        // Last valid solver state, kept across job slices
+        Ref<WFCSolverStateNative> state;
+
         // Thread-safe state snapshot
         std::mutex snapshot_mutex;
         Ref<WFCSolverStateNative> state_snapshot;
@@ -59,23 +76,36 @@ private:
     std::atomic<bool> interrupted_{false};
     std::atomic<bool> all_done_{false};
     int max_threads_ = 4;
+    int priority_ = 0;
+    int64_t deadline_ = 0;
     Ref<WFCSolverSettingsNative> solver_settings_;
+    Ref<WFCTileStoreNative> output_store_;
 
-    // Thread main function
-    void thread_main(int task_index);
+    // Shared by solvers of all tasks, cancels them in the middle of a solve step
+    Ref<WFCCancellationTokenNative> cancellation_token_;
+
+    // Guards started flags, completed_count_ and in_flight_count_
+    std::mutex task_mutex_;
+    std::condition_variable tasks_idle_;
+    int completed_count_ = 0;
+    int in_flight_count_ = 0;
+
+    // Run one scheduler slice of a task. Returns true when the task is finished.
+    bool run_task_slice(int task_index, WFCGenerationSchedulerNative::Job& job);
 
     // Check if task dependencies are satisfied
     bool is_task_blocked(int task_index) const;
 
-    // Start tasks that can run
+    // Submit tasks that can run. Caller must hold task_mutex_.
     int start_available_tasks();
 
-    // Copy boundary solutions from source to target problem's preconditions
-    void copy_boundary_solutions(
-        WFC2DProblemNative* target_problem,
-        WFC2DProblemNative* source_problem,
-        const Ref<WFCSolverStateNative>& source_state,
-        const Rect2i& read_rect);
+    // Mark task as completed, submit unblocked tasks and emit signals.
+    // Runs on the worker thread of the finished task.
+    void finish_task(int task_index, bool failed);
+
+    // Copy solved boundary of a finished task into preconditions of tasks depending on it.
+    // Runs on the finished task's worker thread, before the task is marked as completed.
+    void export_boundary_solutions(int task_index, const Ref<WFCSolverStateNative>& state);
 
 protected:
     static void _bind_methods();
@@ -89,13 +119,17 @@ public:
                const Ref<WFCSolverSettingsNative>& settings,
                int max_threads = 0);
 
-    // Update - call each frame to check progress and start new tasks
-    // Returns true when all tasks are complete
+    // Update - returns true when all tasks are complete.
+    // Optional: scheduling does not depend on it, kept for polling callers.
     bool update();
 
-    // Interrupt all running tasks
+    // Interrupt all running tasks and wait until none of them runs anymore
     void interrupt();
 
+    // Interrupt all running tasks without waiting.
+    // Queued tasks are dropped, running ones stop at the next cancellation check.
+    void interrupt_async();
+
     // Get overall progress (0.0 to 1.0)
     float get_progress() const;
 
@@ -103,6 +137,9 @@ public:
     bool is_running() const;
     bool is_started() const;
 
+    // Check if a task finished without a solution
+    bool is_task_failed(int task_index) const;
+
     // Get state snapshot for a specific task (thread-safe)
     Ref<WFCSolverStateNative> get_task_snapshot(int task_index);
 
@@ -115,6 +152,18 @@ public:
     // Settings
     int get_max_threads() const { return max_threads_; }
     void set_max_threads(int val) { max_threads_ = val; }
+
+    // Scheduling priority of this runner's tasks, higher runs first. Applies to running tasks too.
+    int get_priority() const { return priority_; }
+    void set_priority(int val);
+
+    // Tasks with earlier deadline run first among equal priorities. 0 = no deadline.
+    int64_t get_deadline() const { return deadline_; }
+    void set_deadline(int64_t val);
+
+    // When set, the solution of every finished 2D task is written to this store from its worker thread
+    Ref<WFCTileStoreNative> get_output_store() const { return output_store_; }
+    void set_output_store(const Ref<WFCTileStoreNative>& val) { output_store_ = val; }
 };
 
 } // namespace godot
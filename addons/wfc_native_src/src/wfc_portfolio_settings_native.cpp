@@ -0,0 +1,33 @@
+#include "wfc_portfolio_settings_native.h"
+#include <godot_cpp/core/class_db.hpp>
+
+namespace godot {
+
+void WFCPortfolioSettingsNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_racers"), &WFCPortfolioSettingsNative::get_racers);
+    ClassDB::bind_method(D_METHOD("set_racers", "val"), &WFCPortfolioSettingsNative::set_racers);
+
+    ClassDB::bind_method(D_METHOD("get_heuristics"), &WFCPortfolioSettingsNative::get_heuristics);
+    ClassDB::bind_method(D_METHOD("set_heuristics", "val"), &WFCPortfolioSettingsNative::set_heuristics);
+
+    ClassDB::bind_method(D_METHOD("get_base_seed"), &WFCPortfolioSettingsNative::get_base_seed);
+    ClassDB::bind_method(D_METHOD("set_base_seed", "val"), &WFCPortfolioSettingsNative::set_base_seed);
+
+    // Properties
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "racers"), "set_racers", "get_racers");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "heuristics", PROPERTY_HINT_FLAGS, "Default,Uniform Values,Full History"), "set_heuristics", "get_heuristics");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "base_seed"), "set_base_seed", "get_base_seed");
+
+    // Constants
+    BIND_CONSTANT(HEURISTIC_DEFAULT);
+    BIND_CONSTANT(HEURISTIC_UNIFORM_VALUES);
+    BIND_CONSTANT(HEURISTIC_FULL_HISTORY);
+}
+
+WFCPortfolioSettingsNative::WFCPortfolioSettingsNative() {
+}
+
+WFCPortfolioSettingsNative::~WFCPortfolioSettingsNative() {
+}
+
+} // namespace godot
@@ -0,0 +1,46 @@
+#ifndef WFC_PORTFOLIO_SETTINGS_NATIVE_H
+#define WFC_PORTFOLIO_SETTINGS_NATIVE_H
+
+#include <godot_cpp/classes/resource.hpp>
+
+namespace godot {
+
+// Settings for WFCPortfolioSolverNative
+class WFCPortfolioSettingsNative : public Resource {
+    GDCLASS(WFCPortfolioSettingsNative, Resource)
+
+public:
+    // Solver configurations racers are drawn from, combined as flags
+    enum Heuristic {
+        HEURISTIC_DEFAULT = 1,       // Solver settings as given, only the seed differs
+        HEURISTIC_UNIFORM_VALUES = 2,  // Tiles picked uniformly instead of by probability (same as default without probabilities)
+        HEURISTIC_FULL_HISTORY = 4,  // Sparse history disabled, backtracking never skips states
+    };
+
+private:
+    int racers_ = 0;
+    int heuristics_ = HEURISTIC_DEFAULT | HEURISTIC_UNIFORM_VALUES | HEURISTIC_FULL_HISTORY;
+    int64_t base_seed_ = -1;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCPortfolioSettingsNative();
+    ~WFCPortfolioSettingsNative();
+
+    // Number of concurrent racers, 0 = number of scheduler workers
+    int get_racers() const { return racers_; }
+    void set_racers(int val) { racers_ = val; }
+
+    int get_heuristics() const { return heuristics_; }
+    void set_heuristics(int val) { heuristics_ = val; }
+
+    // Racer i uses base_seed + i. Negative = seed drawn from the global RNG.
+    int64_t get_base_seed() const { return base_seed_; }
+    void set_base_seed(int64_t val) { base_seed_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_PORTFOLIO_SETTINGS_NATIVE_H
@@ -0,0 +1,265 @@
+#include "wfc_portfolio_solver_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+namespace godot {
+
+void WFCPortfolioSolverNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("start", "problem", "settings", "portfolio_settings"), &WFCPortfolioSolverNative::start, DEFVAL(Ref<WFCSolverSettingsNative>()), DEFVAL(Ref<WFCPortfolioSettingsNative>()));
+    ClassDB::bind_method(D_METHOD("wait"), &WFCPortfolioSolverNative::wait);
+    ClassDB::bind_method(D_METHOD("solve", "problem", "settings", "portfolio_settings"), &WFCPortfolioSolverNative::solve, DEFVAL(Ref<WFCSolverSettingsNative>()), DEFVAL(Ref<WFCPortfolioSettingsNative>()));
+    ClassDB::bind_method(D_METHOD("interrupt"), &WFCPortfolioSolverNative::interrupt);
+    ClassDB::bind_method(D_METHOD("is_running"), &WFCPortfolioSolverNative::is_running);
+    ClassDB::bind_method(D_METHOD("get_best_index"), &WFCPortfolioSolverNative::get_best_index);
+    ClassDB::bind_method(D_METHOD("is_solved"), &WFCPortfolioSolverNative::is_solved);
+    ClassDB::bind_method(D_METHOD("get_best_state"), &WFCPortfolioSolverNative::get_best_state);
+    ClassDB::bind_method(D_METHOD("get_racer_seed", "racer_index"), &WFCPortfolioSolverNative::get_racer_seed);
+    ClassDB::bind_method(D_METHOD("get_racer_count"), &WFCPortfolioSolverNative::get_racer_count);
+
+    ClassDB::bind_method(D_METHOD("get_priority"), &WFCPortfolioSolverNative::get_priority);
+    ClassDB::bind_method(D_METHOD("set_priority", "val"), &WFCPortfolioSolverNative::set_priority);
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+
+    ADD_SIGNAL(MethodInfo("finished"));
+}
+
+WFCPortfolioSolverNative::WFCPortfolioSolverNative() {
+}
+
+WFCPortfolioSolverNative::~WFCPortfolioSolverNative() {
+    interrupt();
+}
+
+Ref<WFCSolverSettingsNative> WFCPortfolioSolverNative::make_racer_settings(const Ref<WFCSolverSettingsNative>& base, int heuristic) const {
+    Ref<WFCSolverSettingsNative> settings = base->duplicate();
+
+    switch (heuristic) {
+        case WFCPortfolioSettingsNative::HEURISTIC_FULL_HISTORY:
+            settings->set_sparse_history_start(0);
+            break;
+        default:
+            break;
+    }
+
+    return settings;
+}
+
+void WFCPortfolioSolverNative::start(const Ref<WFCProblemNative>& problem,
+                                     const Ref<WFCSolverSettingsNative>& settings,
+                                     const Ref<WFCPortfolioSettingsNative>& portfolio_settings) {
+    ERR_FAIL_COND(problem.is_null());
+
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    ERR_FAIL_COND_MSG(!scheduler, "WFCGenerationSchedulerNative is not available");
+
+    interrupt();
+
+    Ref<WFCSolverSettingsNative> base_settings = settings;
+    if (base_settings.is_null()) {
+        base_settings.instantiate();
+    }
+
+    Ref<WFCPortfolioSettingsNative> portfolio = portfolio_settings;
+    if (portfolio.is_null()) {
+        portfolio.instantiate();
+    }
+
+    int racer_count = portfolio->get_racers() > 0 ? portfolio->get_racers() : scheduler->get_max_workers();
+
+    std::vector<int> heuristics;
+    for (int flag : { WFCPortfolioSettingsNative::HEURISTIC_DEFAULT,
+                      WFCPortfolioSettingsNative::HEURISTIC_UNIFORM_VALUES,
+                      WFCPortfolioSettingsNative::HEURISTIC_FULL_HISTORY }) {
+        if (portfolio->get_heuristics() & flag) {
+            heuristics.push_back(flag);
+        }
+    }
+    if (heuristics.empty()) {
+        heuristics.push_back(WFCPortfolioSettingsNative::HEURISTIC_DEFAULT);
+    }
+
+    int64_t base_seed = portfolio->get_base_seed();
+    if (base_seed < 0) {
+        base_seed = UtilityFunctions::randi();
+    }
+
+    racers_.clear();
+    cancellation_token_.instantiate();
+    winner_index_ = -1;
+    best_index_ = -1;
+    best_failed_cells_ = 0;
+    best_state_ = Ref<WFCSolverStateNative>();
+
+    for (int i = 0; i < racer_count; i++) {
+        auto racer = std::make_unique<Racer>();
+        racer->problem = problem->clone_problem();
+        ERR_FAIL_COND_MSG(racer->problem.is_null(), "Problem does not support clone_problem(), cannot race it");
+
+        int heuristic = heuristics[i % heuristics.size()];
+        racer->seed = base_seed + i;
+        racer->problem->set_seed(racer->seed);
+        racer->problem->set_uniform_divergence_options(problem->get_uniform_divergence_options() ||
+                                                       heuristic == WFCPortfolioSettingsNative::HEURISTIC_UNIFORM_VALUES);
+        racer->settings = make_racer_settings(base_settings, heuristic);
+
+        racers_.push_back(std::move(racer));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_count_ = static_cast<int>(racers_.size());
+
+    for (int i = 0; i < static_cast<int>(racers_.size()); i++) {
+        Racer* racer = racers_[i].get();
+        racer->job = std::make_shared<WFCGenerationSchedulerNative::Job>();
+        racer->job->priority.store(priority_);
+        racer->job->run_slice = [this, i](WFCGenerationSchedulerNative::Job& job) {
+            return run_racer_slice(i, job);
+        };
+        // Dropped by a shutting down scheduler, the racer ends without a result
+        racer->job->abandon = [this, i](WFCGenerationSchedulerNative::Job&) {
+            finish_racer(i, Ref<WFCSolverStateNative>());
+        };
+
+        if (!scheduler->submit(racer->job)) {
+            racer->job.reset();
+            running_count_--;
+        }
+    }
+
+    if (running_count_ == 0) {
+        call_deferred("emit_signal", "finished");
+        finished_condition_.notify_all();
+    }
+}
+
+bool WFCPortfolioSolverNative::run_racer_slice(int racer_index, WFCGenerationSchedulerNative::Job& job) {
+    Racer* racer = racers_[racer_index].get();
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+
+    if (racer->solver.is_null()) {
+        racer->solver.instantiate();
+        racer->solver->set_cancellation_token(cancellation_token_);
+        racer->solver->initialize(racer->problem, racer->settings);
+    }
+
+    while (true) {
+        bool done = racer->solver->solve_step();
+
+        // Lost the race (or interrupted)
+        if (racer->solver->is_cancelled()) {
+            finish_racer(racer_index, Ref<WFCSolverStateNative>());
+            return true;
+        }
+
+        Ref<WFCSolverStateNative> state = racer->solver->get_current_state();
+        if (state.is_null() || done || state->is_all_solved()) {
+            finish_racer(racer_index, state);
+            return true;
+        }
+
+        if (scheduler && scheduler->should_yield(job)) {
+            return false;
+        }
+    }
+}
+
+void WFCPortfolioSolverNative::finish_racer(int racer_index, const Ref<WFCSolverStateNative>& state) {
+    int64_t failed_cells = 0;
+
+    if (state.is_valid()) {
+        // Solutions without backtracking may leave failed cells behind
+        PackedInt64Array solutions = state->get_cell_solution_or_entropy();
+        const int64_t* ptr = solutions.ptr();
+        for (int64_t i = 0; i < solutions.size(); i++) {
+            if (ptr[i] == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                failed_cells++;
+            }
+        }
+        state->unlink_from_previous();
+    }
+
+    // Everything touching this object happens under the lock, see interrupt()
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (state.is_valid() && winner_index_ < 0) {
+        if (failed_cells == 0) {
+            winner_index_ = racer_index;
+            cancellation_token_->cancel();
+        }
+
+        if (winner_index_ == racer_index || best_index_ < 0 || failed_cells < best_failed_cells_) {
+            best_index_ = racer_index;
+            best_failed_cells_ = failed_cells;
+            best_state_ = state;
+        }
+    }
+
+    running_count_--;
+    if (running_count_ == 0) {
+        call_deferred("emit_signal", "finished");
+    }
+    finished_condition_.notify_all();
+}
+
+Ref<WFCSolverStateNative> WFCPortfolioSolverNative::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_condition_.wait(lock, [this]() { return running_count_ <= 0; });
+    return best_state_;
+}
+
+Ref<WFCSolverStateNative> WFCPortfolioSolverNative::solve(const Ref<WFCProblemNative>& problem,
+                                                          const Ref<WFCSolverSettingsNative>& settings,
+                                                          const Ref<WFCPortfolioSettingsNative>& portfolio_settings) {
+    start(problem, settings, portfolio_settings);
+    return wait();
+}
+
+void WFCPortfolioSolverNative::interrupt() {
+    if (cancellation_token_.is_valid()) {
+        cancellation_token_->cancel();
+    }
+
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // Racers still waiting in the scheduler queue never run
+    for (auto& racer : racers_) {
+        if (racer->job && (!scheduler || scheduler->remove(racer->job))) {
+            running_count_--;
+        }
+        racer->job.reset();
+    }
+
+    finished_condition_.wait(lock, [this]() { return running_count_ <= 0; });
+}
+
+bool WFCPortfolioSolverNative::is_running() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_count_ > 0;
+}
+
+int WFCPortfolioSolverNative::get_best_index() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return best_index_;
+}
+
+bool WFCPortfolioSolverNative::is_solved() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return winner_index_ >= 0;
+}
+
+Ref<WFCSolverStateNative> WFCPortfolioSolverNative::get_best_state() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return best_state_;
+}
+
+int64_t WFCPortfolioSolverNative::get_racer_seed(int racer_index) const {
+    if (racer_index < 0 || racer_index >= static_cast<int>(racers_.size())) {
+        return -1;
+    }
+    return racers_[racer_index]->seed;
+}
+
+} // namespace godot
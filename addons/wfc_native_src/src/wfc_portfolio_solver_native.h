@@ -0,0 +1,98 @@
+#ifndef WFC_PORTFOLIO_SOLVER_NATIVE_H
+#define WFC_PORTFOLIO_SOLVER_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include "wfc_problem_native.h"
+#include "wfc_solver_native.h"
+#include "wfc_solver_settings_native.h"
+#include "wfc_solver_state_native.h"
+#include "wfc_portfolio_settings_native.h"
+#include "wfc_cancellation_token_native.h"
+#include "wfc_generation_scheduler_native.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace godot {
+
+// Races several solvers on copies of one problem, each with its own seed and
+// heuristic, on the workers of WFCGenerationSchedulerNative. The first racer
+// reaching a solution without failed cells wins and all others are cancelled.
+// If none does, the result with the fewest failed cells is kept.
+class WFCPortfolioSolverNative : public RefCounted {
+    GDCLASS(WFCPortfolioSolverNative, RefCounted)
+
+private:
+    struct Racer {
+        Ref<WFCProblemNative> problem;
+        Ref<WFCSolverSettingsNative> settings;
+        Ref<WFCSolverNative> solver;
+        int64_t seed = 0;
+        WFCGenerationSchedulerNative::JobPtr job;
+    };
+
+    std::vector<std::unique_ptr<Racer>> racers_;
+    Ref<WFCCancellationTokenNative> cancellation_token_;
+    int priority_ = 0;
+
+    // Guards everything below
+    std::mutex mutex_;
+    std::condition_variable finished_condition_;
+    int running_count_ = 0;
+    int winner_index_ = -1;
+    int best_index_ = -1;
+    int64_t best_failed_cells_ = 0;
+    Ref<WFCSolverStateNative> best_state_;
+
+    Ref<WFCSolverSettingsNative> make_racer_settings(const Ref<WFCSolverSettingsNative>& base, int heuristic) const;
+    bool run_racer_slice(int racer_index, WFCGenerationSchedulerNative::Job& job);
+    void finish_racer(int racer_index, const Ref<WFCSolverStateNative>& state);
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCPortfolioSolverNative();
+    ~WFCPortfolioSolverNative();
+
+    // Start racing. The problem is cloned per racer (see WFCProblemNative::clone_problem()),
+    // so it must be fully set up, including preconditions. Emits `finished` when done.
+    void start(const Ref<WFCProblemNative>& problem,
+               const Ref<WFCSolverSettingsNative>& settings = Ref<WFCSolverSettingsNative>(),
+               const Ref<WFCPortfolioSettingsNative>& portfolio_settings = Ref<WFCPortfolioSettingsNative>());
+
+    // Block until all racers stopped, returns best state (null if every racer failed)
+    Ref<WFCSolverStateNative> wait();
+
+    // start() followed by wait()
+    Ref<WFCSolverStateNative> solve(const Ref<WFCProblemNative>& problem,
+                                    const Ref<WFCSolverSettingsNative>& settings = Ref<WFCSolverSettingsNative>(),
+                                    const Ref<WFCPortfolioSettingsNative>& portfolio_settings = Ref<WFCPortfolioSettingsNative>());
+
+    // Cancel all racers and wait for them
+    void interrupt();
+
+    bool is_running();
+
+    // Racer whose state is returned, -1 while none has finished
+    int get_best_index();
+
+    // True when the best state has no failed cells
+    bool is_solved();
+
+    Ref<WFCSolverStateNative> get_best_state();
+
+    // Seed used by a racer, to reproduce a winning run with a single solver
+    int64_t get_racer_seed(int racer_index) const;
+
+    int get_racer_count() const { return static_cast<int>(racers_.size()); }
+
+    int get_priority() const { return priority_; }
+    void set_priority(int val) { priority_ = val; }
+};
+
+} // namespace godot
+
+#endif // WFC_PORTFOLIO_SOLVER_NATIVE_H
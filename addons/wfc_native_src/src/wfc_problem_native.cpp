@@ -2,6 +2,8 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <unordered_set>
+
 namespace godot {
 
 // AC4BinaryConstraint implementation
@@ -64,8 +66,19 @@ void WFCProblemNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("supports_ac4"), &WFCProblemNative::supports_ac4);
     ClassDB::bind_method(D_METHOD("get_ac4_binary_constraints"), &WFCProblemNative::get_ac4_binary_constraints);
     ClassDB::bind_method(D_METHOD("get_related_cells", "changed_cell_id"), &WFCProblemNative::get_related_cells);
+    ClassDB::bind_method(D_METHOD("get_cells_in_radius", "cell_id", "radius"), &WFCProblemNative::get_cells_in_radius);
+    ClassDB::bind_method(D_METHOD("clone_problem"), &WFCProblemNative::clone_problem);
     ClassDB::bind_method(D_METHOD("debug_randi_range", "from", "to"), &WFCProblemNative::debug_randi_range);
     ClassDB::bind_method(D_METHOD("debug_array_contents", "arr"), &WFCProblemNative::debug_array_contents);
+
+    ClassDB::bind_method(D_METHOD("get_rng"), &WFCProblemNative::get_rng);
+    ClassDB::bind_method(D_METHOD("set_rng", "val"), &WFCProblemNative::set_rng);
+    ClassDB::bind_method(D_METHOD("set_seed", "seed"), &WFCProblemNative::set_seed);
+    ClassDB::bind_method(D_METHOD("get_uniform_divergence_options"), &WFCProblemNative::get_uniform_divergence_options);
+    ClassDB::bind_method(D_METHOD("set_uniform_divergence_options", "val"), &WFCProblemNative::set_uniform_divergence_options);
+
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "rng", PROPERTY_HINT_RESOURCE_TYPE, "RandomNumberGenerator"), "set_rng", "get_rng");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "uniform_divergence_options"), "set_uniform_divergence_options", "get_uniform_divergence_options");
 }
 
 WFCProblemNative::WFCProblemNative() {
@@ -74,6 +87,27 @@ WFCProblemNative::WFCProblemNative() {
 WFCProblemNative::~WFCProblemNative() {
 }
 
+void WFCProblemNative::set_seed(int64_t seed) {
+    if (rng_.is_null()) {
+        rng_.instantiate();
+    }
+    rng_->set_seed(static_cast<uint64_t>(seed));
+}
+
+int64_t WFCProblemNative::random_index(int64_t size) {
+    if (rng_.is_valid()) {
+        return rng_->randi_range(0, static_cast<int32_t>(size - 1));
+    }
+    return UtilityFunctions::randi_range(0, size - 1);
+}
+
+double WFCProblemNative::random_range(double from, double to) {
+    if (rng_.is_valid()) {
+        return rng_->randf_range(static_cast<float>(from), static_cast<float>(to));
+    }
+    return UtilityFunctions::randf_range(from, to);
+}
+
 int WFCProblemNative::get_cell_count() {
     return -1; // To be overridden
 }
@@ -109,6 +143,36 @@ PackedInt64Array WFCProblemNative::get_related_cells(int changed_cell_id) {
     return PackedInt64Array();
 }
 
+PackedInt64Array WFCProblemNative::get_cells_in_radius(int cell_id, int radius) {
+    PackedInt64Array result;
+    result.append(cell_id);
+
+    std::unordered_set<int64_t> visited;
+    visited.insert(cell_id);
+
+    // Breadth-first, one ring per step
+    int64_t ring_start = 0;
+    for (int step = 0; step < radius; step++) {
+        int64_t ring_end = result.size();
+        if (ring_start == ring_end) {
+            break;
+        }
+
+        for (int64_t i = ring_start; i < ring_end; i++) {
+            PackedInt64Array related = get_related_cells(static_cast<int>(result[i]));
+            for (int64_t j = 0; j < related.size(); j++) {
+                if (visited.insert(related[j]).second) {
+                    result.append(related[j]);
+                }
+            }
+        }
+
+        ring_start = ring_end;
+    }
+
+    return result;
+}
+
 TypedArray<WFCProblemSubProblemNative> WFCProblemNative::split(int concurrency_limit) {
     TypedArray<WFCProblemSubProblemNative> result;
     Ref<WFCProblemSubProblemNative> sub;
@@ -121,7 +185,7 @@ TypedArray<WFCProblemSubProblemNative> WFCProblemNative::split(int concurrency_l
 int WFCProblemNative::pick_divergence_option(TypedArray<int> options) {
     if (options.size() == 0) return -1;
 
-    int index = UtilityFunctions::randi_range(0, options.size() - 1);
+    int index = static_cast<int>(random_index(options.size()));
     // Explicit Variant conversion to avoid issues with TypedArray operator[]
     Variant v = options[index];
     int result = static_cast<int>(static_cast<int64_t>(v));
@@ -129,6 +193,74 @@ int WFCProblemNative::pick_divergence_option(TypedArray<int> options) {
     return result;
 }
 
+int WFCProblemNative::pick_weighted_option(TypedArray<int> options, const PackedFloat32Array& probabilities) {
+    if (options.size() == 0) return -1;
+    if (options.size() == 1) {
+        // Explicit Variant conversion to avoid issues with TypedArray operator[]
+        Variant v = options[0];
+        int result = static_cast<int>(static_cast<int64_t>(v));
+        options.remove_at(0);
+        return result;
+    }
+
+    float probabilities_sum = 0.0f;
+
+    for (int i = 0; i < options.size(); i++) {
+        Variant v = options[i];
+        int option = static_cast<int>(static_cast<int64_t>(v));
+        if (option >= 0 && option < probabilities.size()) {
+            probabilities_sum += probabilities[option];
+        }
+    }
+
+    float value = static_cast<float>(random_range(0.0f, probabilities_sum));
+    probabilities_sum = 0.0f;
+    int chosen_index = 0;
+
+    for (int i = 0; i < options.size(); i++) {
+        Variant v = options[i];
+        int option = static_cast<int>(static_cast<int64_t>(v));
+        if (option >= 0 && option < probabilities.size()) {
+            probabilities_sum += probabilities[option];
+        }
+        if (probabilities_sum > value) {
+            chosen_index = i;
+            break;
+        }
+    }
+
+    Variant v = options[chosen_index];
+    int result = static_cast<int>(static_cast<int64_t>(v));
+    options.remove_at(chosen_index);
+    return result;
+}
+
+PackedInt64Array WFCProblemNative::split_range(int first, int size, int partitions, int min_partition_size) {
+    if (partitions <= 0) {
+        return PackedInt64Array();
+    }
+
+    int approx_partition_size = size / partitions;
+
+    if (approx_partition_size < min_partition_size) {
+        if (partitions <= 2) {
+            PackedInt64Array res;
+            res.append(first);
+            res.append(first + size);
+            return res;
+        }
+        return split_range(first, size, partitions - 1, min_partition_size);
+    }
+
+    PackedInt64Array res;
+    for (int partition = 0; partition < partitions; partition++) {
+        res.append(first + (size * partition) / partitions);
+    }
+    res.append(first + size);
+
+    return res;
+}
+
 // Debug methods
 int WFCProblemNative::debug_randi_range(int from, int to) {
     return UtilityFunctions::randi_range(from, to);
@@ -145,6 +277,10 @@ String WFCProblemNative::debug_array_contents(TypedArray<int> arr) {
     return s;
 }
 
+Ref<WFCProblemNative> WFCProblemNative::clone_problem() {
+    return Ref<WFCProblemNative>(); // To be overridden
+}
+
 bool WFCProblemNative::supports_ac4() {
     return false;
 }
@@ -153,4 +289,11 @@ TypedArray<WFCProblemAC4BinaryConstraintNative> WFCProblemNative::get_ac4_binary
     return TypedArray<WFCProblemAC4BinaryConstraintNative>(); // To be overridden
 }
 
+void WFCProblemNative::prepare_dependency_reads() {
+}
+
+void WFCProblemNative::read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                                 const PackedInt64Array& solutions) {
+}
+
 } // namespace godot
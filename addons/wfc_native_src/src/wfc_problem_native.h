@@ -3,7 +3,9 @@
 
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
 #include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/classes/random_number_generator.hpp>
 #include <functional>
 #include "wfc_bitset_native.h"
 #include "wfc_solver_state_native.h"
@@ -55,13 +57,40 @@ public:
 class WFCProblemNative : public RefCounted {
     GDCLASS(WFCProblemNative, RefCounted)
 
+private:
+    // Random source for solver decisions. When null, the global RNG is used (matches GDScript seed()).
+    Ref<RandomNumberGenerator> rng_;
+
+    bool uniform_divergence_options_ = false;
+
 protected:
     static void _bind_methods();
 
+    // Pops an option drawn with weights given per tile (options without weight count as 0)
+    int pick_weighted_option(TypedArray<int> options, const PackedFloat32Array& probabilities);
+
+    // Bounds of up to `partitions` ranges covering [first, first + size), none shorter than
+    // min_partition_size; fewer partitions are used when the ranges would be too short
+    static PackedInt64Array split_range(int first, int size, int partitions, int min_partition_size);
+
 public:
     WFCProblemNative();
     virtual ~WFCProblemNative();
 
+    Ref<RandomNumberGenerator> get_rng() const { return rng_; }
+    void set_rng(const Ref<RandomNumberGenerator>& val) { rng_ = val; }
+
+    // Uses own RNG seeded with given value instead of the global one
+    void set_seed(int64_t seed);
+
+    // Draw divergence options uniformly, ignoring tile probabilities of the rules
+    bool get_uniform_divergence_options() const { return uniform_divergence_options_; }
+    void set_uniform_divergence_options(bool val) { uniform_divergence_options_ = val; }
+
+    // Random helpers used for divergence decisions, backed by rng_ or the global RNG
+    int64_t random_index(int64_t size);
+    double random_range(double from, double to);
+
     // Virtual methods to be overridden
     virtual int get_cell_count();
     virtual Ref<WFCBitSetNative> get_default_domain();
@@ -73,9 +102,25 @@ public:
     virtual bool supports_ac4();
     virtual TypedArray<WFCProblemAC4BinaryConstraintNative> get_ac4_binary_constraints();
 
+    // Independent copy that can be solved concurrently with this problem (own preconditions
+    // and RNG, shared immutable rule data). Returns null when not supported.
+    virtual Ref<WFCProblemNative> clone_problem();
+
     // Returns cell IDs that depend on the changed cell (for AC3 propagation)
     virtual PackedInt64Array get_related_cells(int changed_cell_id);
 
+    // Cells within `radius` steps of the given cell, including it. Used to reset the
+    // neighbourhood of failed cells. Default walks get_related_cells().
+    virtual PackedInt64Array get_cells_in_radius(int cell_id, int radius);
+
+    // Multithreaded solving: a sub-problem starts from the cells its dependencies solved.
+    // prepare_dependency_reads() runs before any worker starts; read_dependency_solutions()
+    // receives get_cell_solution_or_entropy() of dependencies[dependency_index] (in the cell
+    // order of that problem) once it is complete. Both are no-ops by default.
+    virtual void prepare_dependency_reads();
+    virtual void read_dependency_solutions(int dependency_index, const Ref<WFCProblemNative>& dependency,
+                                           const PackedInt64Array& solutions);
+
     // C++ specific: Internal version with std::function for performance
     void mark_related_cells_internal(int changed_cell_id, std::function<void(int)> mark_cell);
 
@@ -1,6 +1,17 @@
 #include "wfc_rules_2d_native.h"
+#include "wfc_generation_scheduler_native.h"
+#include "wfc_2d_hex_layout_native.h"
+#include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace godot {
 
 void WFCRules2DNative::_bind_methods() {
@@ -33,6 +44,20 @@ void WFCRules2DNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("is_ready"), &WFCRules2DNative::is_ready);
     ClassDB::bind_method(D_METHOD("get_influence_range"), &WFCRules2DNative::get_influence_range);
     ClassDB::bind_method(D_METHOD("format"), &WFCRules2DNative::format);
+    ClassDB::bind_method(D_METHOD("learn_from_grid", "tiles", "size", "positive"), &WFCRules2DNative::learn_from_grid, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("learn_from_hex_grid", "tiles", "rect", "offset_axis", "offset_parity", "positive"), &WFCRules2DNative::learn_from_hex_grid, DEFVAL(true));
+    ClassDB::bind_method(D_METHOD("get_tile_frequencies"), &WFCRules2DNative::get_tile_frequencies);
+    ClassDB::bind_method(D_METHOD("set_tile_frequencies", "val"), &WFCRules2DNative::set_tile_frequencies);
+    ClassDB::bind_method(D_METHOD("set_axis_matrix_words", "axis_index", "words"), &WFCRules2DNative::set_axis_matrix_words);
+    ClassDB::bind_method(D_METHOD("get_axis_matrix_words", "axis_index"), &WFCRules2DNative::get_axis_matrix_words);
+    ClassDB::bind_method(D_METHOD("invalidate_derived"), &WFCRules2DNative::invalidate_derived);
+    ClassDB::bind_method(D_METHOD("get_transposed_matrix", "axis_index"), &WFCRules2DNative::get_transposed_matrix);
+    ClassDB::bind_method(D_METHOD("get_supports", "matrix"), &WFCRules2DNative::get_supports);
+    ClassDB::bind_method(D_METHOD("to_binary"), &WFCRules2DNative::to_binary);
+    ClassDB::bind_method(D_METHOD("from_binary", "bytes"), &WFCRules2DNative::from_binary);
+    ClassDB::bind_method(D_METHOD("save_binary", "path"), &WFCRules2DNative::save_binary);
+    ClassDB::bind_static_method(get_class_static(), D_METHOD("load_binary", "path"), &WFCRules2DNative::load_binary);
+    ClassDB::bind_static_method(get_class_static(), D_METHOD("clear_binary_cache"), &WFCRules2DNative::clear_binary_cache);
 
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "complete_matrices"), "set_complete_matrices", "get_complete_matrices");
     ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "axes"), "set_axes", "get_axes");
@@ -41,6 +66,7 @@ void WFCRules2DNative::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "edge_domain", PROPERTY_HINT_RESOURCE_TYPE, "WFCBitSetNative"), "set_edge_domain", "get_edge_domain");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "probabilities_enabled"), "set_probabilities_enabled", "get_probabilities_enabled");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "tile_count"), "set_tile_count", "get_tile_count");
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT64_ARRAY, "tile_frequencies"), "set_tile_frequencies", "get_tile_frequencies");
 }
 
 WFCRules2DNative::WFCRules2DNative() {
@@ -56,6 +82,9 @@ void WFCRules2DNative::initialize(int tile_count, const TypedArray<Vector2i>& ax
     tile_count_ = tile_count;
     axes_ = axes;
 
+    tile_frequencies_.resize(tile_count);
+    tile_frequencies_.fill(0);
+
     axis_matrices_.clear();
     for (int i = 0; i < axes_.size(); i++) {
         Ref<WFCBitMatrixNative> matrix;
@@ -63,12 +92,50 @@ void WFCRules2DNative::initialize(int tile_count, const TypedArray<Vector2i>& ax
         matrix->initialize(tile_count, tile_count);
         axis_matrices_.append(matrix);
     }
+
+    invalidate_derived();
+}
+
+void WFCRules2DNative::invalidate_derived() {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    derived_valid_ = false;
+    transposed_matrices_ = TypedArray<WFCBitMatrixNative>();
+    supports_.clear();
+}
+
+void WFCRules2DNative::ensure_derived() const {
+    // Called with derived_mutex_ held
+    if (derived_valid_) {
+        return;
+    }
+
+    transposed_matrices_ = TypedArray<WFCBitMatrixNative>();
+    supports_.clear();
+
+    for (int a = 0; a < axis_matrices_.size(); a++) {
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[a];
+        Ref<WFCBitMatrixNative> transposed = matrix->transpose();
+        transposed_matrices_.append(transposed);
+
+        for (const Ref<WFCBitMatrixNative>& m : { matrix, transposed }) {
+            TypedArray<PackedInt64Array> supports;
+            for (int i = 0; i < m->get_height(); i++) {
+                Ref<WFCBitSetNative> row = m->get_row(i);
+                supports.append(row.is_valid() ? row->to_array() : PackedInt64Array());
+            }
+            supports_.push_back(supports);
+        }
+    }
+
+    influence_range_ = compute_influence_range();
+    derived_valid_ = true;
 }
 
 void WFCRules2DNative::set_rule(int axis_index, int tile1, int tile2, bool allowed) {
     if (axis_index >= 0 && axis_index < axis_matrices_.size()) {
         Ref<WFCBitMatrixNative> matrix = axis_matrices_[axis_index];
         matrix->set_bit(tile1, tile2, allowed);
+        invalidate_derived();
     }
 }
 
@@ -85,6 +152,7 @@ void WFCRules2DNative::complete_all_matrices() {
         Ref<WFCBitMatrixNative> matrix = axis_matrices_[i];
         matrix->complete();
     }
+    invalidate_derived();
 }
 
 bool WFCRules2DNative::is_ready() const {
@@ -94,6 +162,12 @@ bool WFCRules2DNative::is_ready() const {
 }
 
 Vector2i WFCRules2DNative::get_influence_range() const {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    ensure_derived();
+    return influence_range_;
+}
+
+Vector2i WFCRules2DNative::compute_influence_range() const {
     Vector2i res(0, 0);
 
     for (int a = 0; a < axes_.size(); a++) {
@@ -108,7 +182,7 @@ Vector2i WFCRules2DNative::get_influence_range() const {
             continue;
         }
 
-        Ref<WFCBitMatrixNative> transposed = matrix->transpose();
+        Ref<WFCBitMatrixNative> transposed = transposed_matrices_[a];
         int backward_path = transposed->get_longest_path();
 
         if (backward_path <= 0) {
@@ -143,4 +217,512 @@ String WFCRules2DNative::format() const {
     return res;
 }
 
+void WFCRules2DNative::learn_from_grid(const PackedInt32Array& tiles, const Vector2i& size, bool positive) {
+    ERR_FAIL_COND_MSG(tiles.size() != (int64_t)size.x * size.y, "Expected one tile id per cell of the sample");
+    ERR_FAIL_COND_MSG(axis_matrices_.size() != axes_.size(), "WFCRules2DNative is not initialized");
+
+    // Variants are unpacked on the calling thread, workers only touch plain vectors
+    std::vector<Vector2i> axes(axes_.size());
+    for (int a = 0; a < axes_.size(); a++) {
+        axes[a] = axes_[a];
+    }
+
+    learn_pairs(tiles, size, positive, [&axes](const Vector2i& pos, int axis_index) {
+        return pos + axes[axis_index];
+    });
+}
+
+void WFCRules2DNative::learn_from_hex_grid(const PackedInt32Array& tiles, const Rect2i& rect, int offset_axis,
+                                           int offset_parity, bool positive) {
+    ERR_FAIL_COND_MSG(tiles.size() != rect.get_area(), "Expected one tile id per cell of the sample");
+    ERR_FAIL_COND_MSG(axes_.size() != WFC2DHexLayout::AXIS_COUNT || axis_matrices_.size() != axes_.size(),
+                      "Hex rules need WFC2DHexLayout::AXIS_COUNT initialized axes");
+
+    WFC2DHexLayout hex;
+    hex.configure(static_cast<WFC2DHexLayout::OffsetAxis>(offset_axis), offset_parity);
+    const Vector2i origin = rect.position;
+
+    // Parity is taken from absolute coordinates, axis a is the forward direction a * 2
+    learn_pairs(tiles, rect.size, positive, [&hex, origin](const Vector2i& pos, int axis_index) {
+        return hex.get_neighbour(pos + origin, axis_index * 2) - origin;
+    });
+}
+
+template <typename NeighbourFn>
+void WFCRules2DNative::learn_pairs(const PackedInt32Array& tiles, const Vector2i& size, bool positive, const NeighbourFn& neighbour) {
+    const int axis_count = static_cast<int>(axes_.size());
+    const int words_per_row = (tile_count_ + 63) / 64;
+    const int64_t matrix_words = (int64_t)tile_count_ * words_per_row;
+    const int32_t* grid = tiles.ptr();
+
+    // Seen pairs per worker: bit `cell` of row `other_cell`, as set_rule(axis, cell, other_cell)
+    struct Partial {
+        std::vector<uint64_t> pairs;
+        std::vector<int64_t> frequencies;
+    };
+
+    auto learn_rows = [&](Partial& partial, int y_begin, int y_end) {
+        partial.pairs.assign(matrix_words * axis_count, 0);
+        partial.frequencies.assign(tile_count_, 0);
+
+        for (int y = y_begin; y < y_end; y++) {
+            for (int x = 0; x < size.x; x++) {
+                int32_t cell = grid[(int64_t)y * size.x + x];
+                if (cell < 0 || cell >= tile_count_) {
+                    continue;
+                }
+                partial.frequencies[cell]++;
+
+                for (int a = 0; a < axis_count; a++) {
+                    Vector2i other = neighbour(Vector2i(x, y), a);
+                    if (other.x < 0 || other.y < 0 || other.x >= size.x || other.y >= size.y) {
+                        continue;
+                    }
+
+                    int32_t other_cell = grid[(int64_t)other.y * size.x + other.x];
+                    if (other_cell < 0 || other_cell >= tile_count_) {
+                        continue;
+                    }
+
+                    partial.pairs[a * matrix_words + (int64_t)other_cell * words_per_row + cell / 64] |= uint64_t(1) << (cell % 64);
+                }
+            }
+        }
+    };
+
+    WFCGenerationSchedulerNative* scheduler = WFCGenerationSchedulerNative::get_singleton();
+    int worker_count = 1;
+    // A worker waiting for other jobs could starve the pool, so workers learn inline
+    if (scheduler && tiles.size() >= PARALLEL_LEARNING_MIN_CELLS && !WFCGenerationSchedulerNative::is_worker_thread()) {
+        worker_count = std::max(1, std::min(scheduler->get_max_workers(), size.y));
+    }
+
+    std::vector<Partial> partials(worker_count);
+
+    if (worker_count == 1) {
+        learn_rows(partials[0], 0, size.y);
+    } else {
+        // Each worker takes one band of rows
+        std::mutex done_mutex;
+        std::condition_variable done_condition;
+        int running_jobs = worker_count;
+
+        auto learn_band = [&](int w) {
+            learn_rows(partials[w], (int)((int64_t)size.y * w / worker_count), (int)((int64_t)size.y * (w + 1) / worker_count));
+
+            // Notify under the lock: the waiting thread owns everything captured here
+            std::lock_guard<std::mutex> lock(done_mutex);
+            running_jobs--;
+            done_condition.notify_all();
+        };
+
+        for (int w = 0; w < worker_count; w++) {
+            auto job = std::make_shared<WFCGenerationSchedulerNative::Job>();
+            job->run_slice = [&, w](WFCGenerationSchedulerNative::Job&) {
+                learn_band(w);
+                return true;
+            };
+            // Bands the scheduler drops or refuses are learned by the calling thread
+            job->abandon = [&, w](WFCGenerationSchedulerNative::Job&) {
+                learn_band(w);
+            };
+
+            if (!scheduler->submit(job)) {
+                learn_band(w);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_condition.wait(lock, [&]() { return running_jobs == 0; });
+    }
+
+    for (int w = 1; w < worker_count; w++) {
+        for (int64_t i = 0; i < (int64_t)partials[0].pairs.size(); i++) {
+            partials[0].pairs[i] |= partials[w].pairs[i];
+        }
+        for (int t = 0; t < tile_count_; t++) {
+            partials[0].frequencies[t] += partials[w].frequencies[t];
+        }
+    }
+
+    const Partial& learned = partials[0];
+    for (int a = 0; a < axis_count; a++) {
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[a];
+        for (int row_index = 0; row_index < tile_count_; row_index++) {
+            const uint64_t* src = learned.pairs.data() + a * matrix_words + (int64_t)row_index * words_per_row;
+            Ref<WFCBitSetNative> row;
+
+            for (int w = 0; w < words_per_row; w++) {
+                if (src[w] == 0) {
+                    continue;
+                }
+                if (row.is_null()) {
+                    row = matrix->get_row(row_index);
+                }
+
+                uint64_t current = static_cast<uint64_t>(row->get_elem(w));
+                row->set_elem(w, static_cast<int64_t>(positive ? (current | src[w]) : (current & ~src[w])));
+            }
+        }
+    }
+
+    invalidate_derived();
+
+    if (positive) {
+        if (tile_frequencies_.size() != tile_count_) {
+            tile_frequencies_.resize(tile_count_);
+            tile_frequencies_.fill(0);
+        }
+        int64_t* frequencies = tile_frequencies_.ptrw();
+        for (int t = 0; t < tile_count_; t++) {
+            frequencies[t] += learned.frequencies[t];
+        }
+    }
+}
+
+void WFCRules2DNative::set_axis_matrix_words(int axis_index, const PackedInt64Array& words) {
+    ERR_FAIL_INDEX(axis_index, axis_matrices_.size());
+
+    Ref<WFCBitMatrixNative> matrix = axis_matrices_[axis_index];
+    matrix->set_words(words);
+    invalidate_derived();
+}
+
+PackedInt64Array WFCRules2DNative::get_axis_matrix_words(int axis_index) const {
+    ERR_FAIL_INDEX_V(axis_index, axis_matrices_.size(), PackedInt64Array());
+
+    Ref<WFCBitMatrixNative> matrix = axis_matrices_[axis_index];
+    return matrix->get_words();
+}
+
+Ref<WFCBitMatrixNative> WFCRules2DNative::get_transposed_matrix(int axis_index) const {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    ensure_derived();
+    ERR_FAIL_INDEX_V(axis_index, transposed_matrices_.size(), Ref<WFCBitMatrixNative>());
+    return transposed_matrices_[axis_index];
+}
+
+TypedArray<PackedInt64Array> WFCRules2DNative::get_supports(const Ref<WFCBitMatrixNative>& matrix) const {
+    ERR_FAIL_COND_V(matrix.is_null(), TypedArray<PackedInt64Array>());
+
+    {
+        std::lock_guard<std::mutex> lock(derived_mutex_);
+        ensure_derived();
+
+        for (int a = 0; a < axis_matrices_.size(); a++) {
+            if (Ref<WFCBitMatrixNative>(axis_matrices_[a]) == matrix) {
+                return supports_[a * 2];
+            }
+            if (Ref<WFCBitMatrixNative>(transposed_matrices_[a]) == matrix) {
+                return supports_[a * 2 + 1];
+            }
+        }
+    }
+
+    TypedArray<PackedInt64Array> supports;
+    for (int i = 0; i < matrix->get_height(); i++) {
+        Ref<WFCBitSetNative> row = matrix->get_row(i);
+        supports.append(row.is_valid() ? row->to_array() : PackedInt64Array());
+    }
+    return supports;
+}
+
+namespace {
+
+struct RulesBinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t payload_size;
+    uint64_t content_hash;
+};
+
+uint64_t fnv1a_64(const uint8_t* data, uint64_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (uint64_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+class BinaryWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    template <typename T>
+    void put(const T& value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+
+    void put_words(const PackedInt64Array& words) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(words.ptr());
+        bytes.insert(bytes.end(), p, p + words.size() * sizeof(int64_t));
+    }
+};
+
+class BinaryReader {
+    const uint8_t* data_;
+    uint64_t size_;
+    uint64_t offset_ = 0;
+
+public:
+    BinaryReader(const uint8_t* data, uint64_t size) : data_(data), size_(size) {}
+
+    bool ok = true;
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (offset_ + sizeof(T) > size_) {
+            ok = false;
+            return value;
+        }
+        memcpy(&value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    PackedInt64Array get_words(int64_t count) {
+        PackedInt64Array words;
+        if (count < 0 || offset_ + count * sizeof(int64_t) > size_) {
+            ok = false;
+            return words;
+        }
+        words.resize(count);
+        memcpy(words.ptrw(), data_ + offset_, count * sizeof(int64_t));
+        offset_ += count * sizeof(int64_t);
+        return words;
+    }
+
+    bool at_end() const { return offset_ == size_; }
+};
+
+std::mutex binary_cache_mutex;
+std::map<std::string, std::pair<uint64_t, Ref<WFCRules2DNative>>> binary_cache;
+
+} // namespace
+
+PackedByteArray WFCRules2DNative::to_binary() const {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    ensure_derived();
+
+    const int axis_count = static_cast<int>(axes_.size());
+    const int words_per_row = (tile_count_ + 63) / 64;
+
+    BinaryWriter payload;
+    payload.put<int32_t>(tile_count_);
+    payload.put<int32_t>(axis_count);
+    payload.put<uint8_t>(complete_matrices_);
+    payload.put<uint8_t>(probabilities_enabled_);
+    payload.put<uint8_t>(edge_domain_.is_valid());
+    payload.put<uint8_t>(0);
+
+    for (int a = 0; a < axis_count; a++) {
+        Vector2i axis = axes_[a];
+        payload.put<int32_t>(axis.x);
+        payload.put<int32_t>(axis.y);
+    }
+
+    for (int a = 0; a < axis_count; a++) {
+        Ref<WFCBitMatrixNative> matrix = axis_matrices_[a];
+        payload.put_words(matrix->get_words());
+    }
+    for (int a = 0; a < axis_count; a++) {
+        Ref<WFCBitMatrixNative> transposed = transposed_matrices_[a];
+        payload.put_words(transposed->get_words());
+    }
+
+    payload.put<int32_t>(static_cast<int32_t>(probabilities_.size()));
+    for (int64_t i = 0; i < probabilities_.size(); i++) {
+        payload.put<float>(probabilities_[i]);
+    }
+
+    if (edge_domain_.is_valid()) {
+        for (int w = 0; w < words_per_row; w++) {
+            payload.put<int64_t>(edge_domain_->get_elem(w));
+        }
+    }
+
+    payload.put<int32_t>(influence_range_.x);
+    payload.put<int32_t>(influence_range_.y);
+
+    // Supports of each direction as tile_count + 1 offsets followed by the tile ids
+    for (const TypedArray<PackedInt64Array>& supports : supports_) {
+        int32_t offset = 0;
+        payload.put<int32_t>(offset);
+        for (int64_t t = 0; t < supports.size(); t++) {
+            offset += static_cast<int32_t>(PackedInt64Array(supports[t]).size());
+            payload.put<int32_t>(offset);
+        }
+        for (int64_t t = 0; t < supports.size(); t++) {
+            PackedInt64Array allowed = supports[t];
+            for (int64_t i = 0; i < allowed.size(); i++) {
+                payload.put<int32_t>(static_cast<int32_t>(allowed[i]));
+            }
+        }
+    }
+
+    RulesBinaryHeader header;
+    header.magic = BINARY_MAGIC;
+    header.version = BINARY_VERSION;
+    header.payload_size = payload.bytes.size();
+    header.content_hash = fnv1a_64(payload.bytes.data(), payload.bytes.size());
+
+    PackedByteArray bytes;
+    bytes.resize(sizeof(header) + payload.bytes.size());
+    memcpy(bytes.ptrw(), &header, sizeof(header));
+    memcpy(bytes.ptrw() + sizeof(header), payload.bytes.data(), payload.bytes.size());
+    return bytes;
+}
+
+bool WFCRules2DNative::from_binary(const PackedByteArray& bytes) {
+    RulesBinaryHeader header;
+    ERR_FAIL_COND_V_MSG(bytes.size() < (int64_t)sizeof(header), false, "Not a compiled rules file");
+    memcpy(&header, bytes.ptr(), sizeof(header));
+
+    ERR_FAIL_COND_V_MSG(header.magic != BINARY_MAGIC || header.version != BINARY_VERSION, false,
+            "Not a compiled rules file or unsupported version");
+    ERR_FAIL_COND_V_MSG(header.payload_size != bytes.size() - sizeof(header), false, "Compiled rules file is truncated");
+
+    const uint8_t* payload = bytes.ptr() + sizeof(header);
+    ERR_FAIL_COND_V_MSG(fnv1a_64(payload, header.payload_size) != header.content_hash, false,
+            "Compiled rules file does not match its content hash");
+
+    BinaryReader reader(payload, header.payload_size);
+
+    const int tile_count = reader.get<int32_t>();
+    const int axis_count = reader.get<int32_t>();
+    const bool complete_matrices = reader.get<uint8_t>();
+    const bool probabilities_enabled = reader.get<uint8_t>();
+    const bool has_edge_domain = reader.get<uint8_t>();
+    reader.get<uint8_t>();
+    ERR_FAIL_COND_V_MSG(!reader.ok || tile_count < 0 || axis_count < 0, false, "Compiled rules file is corrupt");
+
+    const int words_per_row = (tile_count + 63) / 64;
+
+    TypedArray<Vector2i> axes;
+    for (int a = 0; a < axis_count; a++) {
+        int32_t x = reader.get<int32_t>();
+        int32_t y = reader.get<int32_t>();
+        axes.append(Vector2i(x, y));
+    }
+
+    TypedArray<WFCBitMatrixNative> matrices[2];
+    for (TypedArray<WFCBitMatrixNative>& target : matrices) {
+        for (int a = 0; a < axis_count; a++) {
+            PackedInt64Array words = reader.get_words((int64_t)tile_count * words_per_row);
+            ERR_FAIL_COND_V_MSG(!reader.ok, false, "Compiled rules file is corrupt");
+
+            Ref<WFCBitMatrixNative> matrix;
+            matrix.instantiate();
+            matrix->initialize(tile_count, tile_count);
+            matrix->set_words(words);
+            target.append(matrix);
+        }
+    }
+
+    PackedFloat32Array probabilities;
+    probabilities.resize(std::max(reader.get<int32_t>(), 0));
+    for (int64_t i = 0; i < probabilities.size() && reader.ok; i++) {
+        probabilities.set(i, reader.get<float>());
+    }
+
+    Ref<WFCBitSetNative> edge_domain;
+    if (has_edge_domain) {
+        edge_domain.instantiate();
+        edge_domain->initialize(tile_count);
+        for (int w = 0; w < words_per_row; w++) {
+            edge_domain->set_elem(w, reader.get<int64_t>());
+        }
+    }
+
+    Vector2i influence_range;
+    influence_range.x = reader.get<int32_t>();
+    influence_range.y = reader.get<int32_t>();
+
+    std::vector<TypedArray<PackedInt64Array>> supports(axis_count * 2);
+    for (TypedArray<PackedInt64Array>& direction : supports) {
+        std::vector<int32_t> offsets(tile_count + 1);
+        for (int32_t& offset : offsets) {
+            offset = reader.get<int32_t>();
+        }
+        for (int t = 0; t < tile_count && reader.ok; t++) {
+            PackedInt64Array allowed;
+            allowed.resize(std::max(offsets[t + 1] - offsets[t], 0));
+            for (int64_t i = 0; i < allowed.size(); i++) {
+                allowed.set(i, reader.get<int32_t>());
+            }
+            direction.append(allowed);
+        }
+    }
+
+    ERR_FAIL_COND_V_MSG(!reader.ok || !reader.at_end(), false, "Compiled rules file is corrupt");
+
+    tile_count_ = tile_count;
+    axes_ = axes;
+    axis_matrices_ = matrices[0];
+    complete_matrices_ = complete_matrices;
+    probabilities_enabled_ = probabilities_enabled;
+    probabilities_ = probabilities;
+    edge_domain_ = edge_domain;
+    tile_frequencies_.resize(tile_count);
+    tile_frequencies_.fill(0);
+
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    transposed_matrices_ = matrices[1];
+    supports_ = supports;
+    influence_range_ = influence_range;
+    derived_valid_ = true;
+
+    return true;
+}
+
+bool WFCRules2DNative::save_binary(const String& path) const {
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+    ERR_FAIL_COND_V_MSG(file.is_null(), false, "Cannot write compiled rules file");
+
+    file->store_buffer(to_binary());
+    return true;
+}
+
+Ref<WFCRules2DNative> WFCRules2DNative::load_binary(const String& path) {
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    ERR_FAIL_COND_V_MSG(file.is_null(), Ref<WFCRules2DNative>(), "Cannot read compiled rules file");
+
+    // The header alone tells whether the cached instance is still current
+    PackedByteArray header_bytes = file->get_buffer(sizeof(RulesBinaryHeader));
+    ERR_FAIL_COND_V_MSG(header_bytes.size() != sizeof(RulesBinaryHeader), Ref<WFCRules2DNative>(), "Not a compiled rules file");
+
+    RulesBinaryHeader header;
+    memcpy(&header, header_bytes.ptr(), sizeof(header));
+
+    const std::string key = file->get_path_absolute().utf8().get_data();
+    {
+        std::lock_guard<std::mutex> lock(binary_cache_mutex);
+        auto found = binary_cache.find(key);
+        if (found != binary_cache.end() && found->second.first == header.content_hash) {
+            return found->second.second;
+        }
+    }
+
+    file->seek(0);
+    PackedByteArray bytes = file->get_buffer(file->get_length());
+
+    Ref<WFCRules2DNative> rules;
+    rules.instantiate();
+    if (!rules->from_binary(bytes)) {
+        return Ref<WFCRules2DNative>();
+    }
+
+    std::lock_guard<std::mutex> lock(binary_cache_mutex);
+    binary_cache[key] = { header.content_hash, rules };
+    return rules;
+}
+
+void WFCRules2DNative::clear_binary_cache() {
+    std::lock_guard<std::mutex> lock(binary_cache_mutex);
+    binary_cache.clear();
+}
+
 } // namespace godot
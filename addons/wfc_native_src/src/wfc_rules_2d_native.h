@@ -3,11 +3,18 @@
 
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/variant/typed_array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
 #include <godot_cpp/variant/vector2i.hpp>
 #include "wfc_bitset_native.h"
 #include "wfc_bitmatrix_native.h"
 
+#include <mutex>
+#include <vector>
+
 namespace godot {
 
 class WFCRules2DNative : public Resource {
@@ -16,6 +23,13 @@ class WFCRules2DNative : public Resource {
 public:
     static constexpr int MAX_INT_32 = 2147483647;
 
+    // Samples with fewer cells are learned on the calling thread
+    static constexpr int64_t PARALLEL_LEARNING_MIN_CELLS = 65536;
+
+    // Binary format, see to_binary()
+    static constexpr uint32_t BINARY_MAGIC = 0x52434657; // "WFCR"
+    static constexpr uint32_t BINARY_VERSION = 1;
+
 private:
     bool complete_matrices_ = true;
     TypedArray<Vector2i> axes_;
@@ -25,7 +39,24 @@ private:
     bool probabilities_enabled_ = false;
     int tile_count_ = 0;
 
+    // Derived from the matrices on first use or loaded from the binary format:
+    // transposed matrices, AC4 supports per direction (axis * 2 + reversed) and influence range.
+    mutable std::mutex derived_mutex_;
+    mutable bool derived_valid_ = false;
+    mutable TypedArray<WFCBitMatrixNative> transposed_matrices_;
+    mutable std::vector<TypedArray<PackedInt64Array>> supports_;
+    mutable Vector2i influence_range_;
+
+    void ensure_derived() const;
+    Vector2i compute_influence_range() const;
+
+    // Learns pairs (cell, neighbour(cell, axis_index)) of a row-major sample, see learn_from_grid()
+    template <typename NeighbourFn>
+    void learn_pairs(const PackedInt32Array& tiles, const Vector2i& size, bool positive, const NeighbourFn& neighbour);
+
 protected:
+    PackedInt64Array tile_frequencies_;
+
     static void _bind_methods();
 
 public:
@@ -34,15 +65,19 @@ public:
 
     void initialize(int tile_count, const TypedArray<Vector2i>& axes);
 
+    // Drops transposes, supports and influence range computed so far. Mutators of this class
+    // call it; call it after editing the matrices directly.
+    void invalidate_derived();
+
     // Property accessors
     bool get_complete_matrices() const { return complete_matrices_; }
     void set_complete_matrices(bool val) { complete_matrices_ = val; }
 
     TypedArray<Vector2i> get_axes() const { return axes_; }
-    void set_axes(const TypedArray<Vector2i>& val) { axes_ = val; }
+    void set_axes(const TypedArray<Vector2i>& val) { axes_ = val; invalidate_derived(); }
 
     TypedArray<WFCBitMatrixNative> get_axis_matrices() const { return axis_matrices_; }
-    void set_axis_matrices(const TypedArray<WFCBitMatrixNative>& val) { axis_matrices_ = val; }
+    void set_axis_matrices(const TypedArray<WFCBitMatrixNative>& val) { axis_matrices_ = val; invalidate_derived(); }
 
     PackedFloat32Array get_probabilities() const { return probabilities_; }
     void set_probabilities(const PackedFloat32Array& val) { probabilities_ = val; }
@@ -54,7 +89,7 @@ public:
     void set_probabilities_enabled(bool val) { probabilities_enabled_ = val; }
 
     int get_tile_count() const { return tile_count_; }
-    void set_tile_count(int val) { tile_count_ = val; }
+    void set_tile_count(int val) { tile_count_ = val; invalidate_derived(); }
 
     // Methods
     void set_rule(int axis_index, int tile1, int tile2, bool allowed = true);
@@ -63,6 +98,48 @@ public:
     bool is_ready() const;
     Vector2i get_influence_range() const;
     String format() const;
+
+    // Learns rules from a sample of size cells, tile ids laid out row-major (-1 = empty).
+    // Positive samples allow every adjacent pair and count tile frequencies, negative
+    // samples disallow them (WFCRules2D.learn_from / learn_negative_from).
+    void learn_from_grid(const PackedInt32Array& tiles, const Vector2i& size, bool positive = true);
+
+    // Same for a hex map in offset coordinates (see WFC2DHexLayout) covering rect, with
+    // the three axes of these rules taken as the hex directions 0, 2 and 4.
+    void learn_from_hex_grid(const PackedInt32Array& tiles, const Rect2i& rect, int offset_axis,
+                             int offset_parity, bool positive = true);
+
+    // Number of cells holding each tile in positive samples learned since initialize().
+    // Saved with the resource, but not part of the compiled binary format.
+    PackedInt64Array get_tile_frequencies() const { return tile_frequencies_; }
+    void set_tile_frequencies(const PackedInt64Array& val) { tile_frequencies_ = val; }
+
+    // Whole matrix of an axis as (tile_count + 63) / 64 words per row, rows one after another.
+    // Rows are the same as WFCBitMatrix rows, so GDScript matrices can be imported in one call.
+    void set_axis_matrix_words(int axis_index, const PackedInt64Array& words);
+    PackedInt64Array get_axis_matrix_words(int axis_index) const;
+
+    // Transpose of an axis matrix (the rules of the reversed axis), computed once
+    Ref<WFCBitMatrixNative> get_transposed_matrix(int axis_index) const;
+
+    // Allowed tiles per dependency tile for an AC4 constraint using matrix (to_array() of each
+    // row). Cached for this rules' own matrices and their transposes.
+    TypedArray<PackedInt64Array> get_supports(const Ref<WFCBitMatrixNative>& matrix) const;
+
+    // Versioned binary form of the rules together with derived data, loadable with a single
+    // read: a header with magic, version, payload size and an FNV-1a hash of the payload,
+    // then flat matrices, transposes, probabilities, edge domain, influence range and supports.
+    PackedByteArray to_binary() const;
+    bool from_binary(const PackedByteArray& bytes);
+
+    bool save_binary(const String& path) const;
+
+    // Rules loaded from a file written by save_binary(). Files already loaded with the same
+    // content hash return the same shared instance, duplicate it before editing.
+    static Ref<WFCRules2DNative> load_binary(const String& path);
+
+    // Releases instances kept by load_binary()
+    static void clear_binary_cache();
 };
 
 } // namespace godot
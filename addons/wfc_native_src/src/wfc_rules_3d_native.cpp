@@ -0,0 +1,155 @@
+#include "wfc_rules_3d_native.h"
+#include <godot_cpp/core/class_db.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace godot {
+
+void WFCRules3DNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("initialize_3d", "tile_count", "axes"), &WFCRules3DNative::initialize_3d);
+
+    ClassDB::bind_method(D_METHOD("get_axes_3d"), &WFCRules3DNative::get_axes_3d);
+    ClassDB::bind_method(D_METHOD("set_axes_3d", "val"), &WFCRules3DNative::set_axes_3d);
+
+    ClassDB::bind_method(D_METHOD("get_influence_range_3d"), &WFCRules3DNative::get_influence_range_3d);
+    ClassDB::bind_method(D_METHOD("learn_from_grid_3d", "tiles", "size", "positive"), &WFCRules3DNative::learn_from_grid_3d, DEFVAL(true));
+
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "axes_3d"), "set_axes_3d", "get_axes_3d");
+}
+
+WFCRules3DNative::WFCRules3DNative() {
+    // Default axes: (0,0,1), (0,1,0) and (1,0,0), as WFCRules3D
+    axes_3d_.append(Vector3i(0, 0, 1));
+    axes_3d_.append(Vector3i(0, 1, 0));
+    axes_3d_.append(Vector3i(1, 0, 0));
+    set_axes(project_axes(axes_3d_));
+}
+
+WFCRules3DNative::~WFCRules3DNative() {
+}
+
+TypedArray<Vector2i> WFCRules3DNative::project_axes(const TypedArray<Vector3i>& axes) {
+    TypedArray<Vector2i> res;
+    for (int i = 0; i < axes.size(); i++) {
+        Vector3i axis = axes[i];
+        res.append(Vector2i(axis.x, axis.y));
+    }
+    return res;
+}
+
+void WFCRules3DNative::initialize_3d(int tile_count, const TypedArray<Vector3i>& axes) {
+    axes_3d_ = axes;
+    initialize(tile_count, project_axes(axes));
+}
+
+void WFCRules3DNative::set_axes_3d(const TypedArray<Vector3i>& val) {
+    axes_3d_ = val;
+    set_axes(project_axes(val));
+}
+
+Vector3i WFCRules3DNative::get_influence_range_3d() const {
+    Vector3i res(0, 0, 0);
+    TypedArray<WFCBitMatrixNative> matrices = get_axis_matrices();
+
+    for (int a = 0; a < axes_3d_.size() && a < matrices.size(); a++) {
+        Vector3i axis = axes_3d_[a];
+        Ref<WFCBitMatrixNative> matrix = matrices[a];
+
+        int forward_path = matrix->get_longest_path();
+        int backward_path = forward_path > 0 ? get_transposed_matrix(a)->get_longest_path() : 0;
+
+        for (int c = 0; c < 3; c++) {
+            if (axis[c] == 0) {
+                continue;
+            }
+            if (forward_path <= 0 || backward_path <= 0) {
+                res[c] = MAX_INT_32;
+                continue;
+            }
+
+            int longest_path = forward_path > backward_path ? forward_path : backward_path;
+            if (res[c] != MAX_INT_32) {
+                res[c] = std::max(res[c], std::abs(axis[c]) * longest_path);
+            }
+        }
+    }
+
+    return res;
+}
+
+void WFCRules3DNative::learn_from_grid_3d(const PackedInt32Array& tiles, const Vector3i& size, bool positive) {
+    ERR_FAIL_COND_MSG(tiles.size() != (int64_t)size.x * size.y * size.z, "Expected one tile id per cell of the sample");
+    ERR_FAIL_COND_MSG(get_axis_matrices().size() != axes_3d_.size(), "WFCRules3DNative is not initialized");
+
+    const int tile_count = get_tile_count();
+    const int axis_count = static_cast<int>(axes_3d_.size());
+    const int words_per_row = (tile_count + 63) / 64;
+    const int64_t matrix_words = (int64_t)tile_count * words_per_row;
+    const int64_t layer = (int64_t)size.x * size.y;
+
+    std::vector<Vector3i> axes(axis_count);
+    for (int a = 0; a < axis_count; a++) {
+        axes[a] = axes_3d_[a];
+    }
+    const int32_t* grid = tiles.ptr();
+
+    // Seen pairs: bit `cell` of row `other_cell`, as set_rule(axis, cell, other_cell)
+    std::vector<uint64_t> pairs(matrix_words * axis_count, 0);
+    std::vector<int64_t> frequencies(tile_count, 0);
+
+    for (int z = 0; z < size.z; z++) {
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                int32_t cell = grid[z * layer + (int64_t)y * size.x + x];
+                if (cell < 0 || cell >= tile_count) {
+                    continue;
+                }
+                frequencies[cell]++;
+
+                for (int a = 0; a < axis_count; a++) {
+                    Vector3i other = Vector3i(x, y, z) + axes[a];
+                    if (other.x < 0 || other.y < 0 || other.z < 0 || other.x >= size.x || other.y >= size.y || other.z >= size.z) {
+                        continue;
+                    }
+
+                    int32_t other_cell = grid[other.z * layer + (int64_t)other.y * size.x + other.x];
+                    if (other_cell < 0 || other_cell >= tile_count) {
+                        continue;
+                    }
+
+                    pairs[a * matrix_words + (int64_t)other_cell * words_per_row + cell / 64] |= uint64_t(1) << (cell % 64);
+                }
+            }
+        }
+    }
+
+    for (int a = 0; a < axis_count; a++) {
+        PackedInt64Array words = get_axis_matrix_words(a);
+        if (words.size() != matrix_words) {
+            continue;
+        }
+
+        int64_t* dst = words.ptrw();
+        const uint64_t* src = pairs.data() + a * matrix_words;
+        for (int64_t i = 0; i < matrix_words; i++) {
+            uint64_t current = static_cast<uint64_t>(dst[i]);
+            dst[i] = static_cast<int64_t>(positive ? (current | src[i]) : (current & ~src[i]));
+        }
+        set_axis_matrix_words(a, words);
+    }
+
+    if (positive) {
+        if (tile_frequencies_.size() != tile_count) {
+            tile_frequencies_.resize(tile_count);
+            tile_frequencies_.fill(0);
+        }
+        int64_t* dst = tile_frequencies_.ptrw();
+        for (int t = 0; t < tile_count; t++) {
+            dst[t] += frequencies[t];
+        }
+    }
+}
+
+} // namespace godot
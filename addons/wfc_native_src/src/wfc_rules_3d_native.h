@@ -0,0 +1,43 @@
+#ifndef WFC_RULES_3D_NATIVE_H
+#define WFC_RULES_3D_NATIVE_H
+
+#include <godot_cpp/variant/vector3i.hpp>
+#include "wfc_rules_2d_native.h"
+
+namespace godot {
+
+// Rules over Vector3i axes. Matrices, probabilities, edge domain, transposes, AC4 supports
+// and compilation are those of WFCRules2DNative; the inherited `axes` hold the X/Y
+// projection of axes_3d and only matter to 2D code. The binary form stores the projected
+// axes, set axes_3d again after from_binary()/load_binary().
+class WFCRules3DNative : public WFCRules2DNative {
+    GDCLASS(WFCRules3DNative, WFCRules2DNative)
+
+private:
+    TypedArray<Vector3i> axes_3d_;
+
+    static TypedArray<Vector2i> project_axes(const TypedArray<Vector3i>& axes);
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCRules3DNative();
+    ~WFCRules3DNative();
+
+    void initialize_3d(int tile_count, const TypedArray<Vector3i>& axes);
+
+    TypedArray<Vector3i> get_axes_3d() const { return axes_3d_; }
+    void set_axes_3d(const TypedArray<Vector3i>& val);
+
+    // Longest distance along each axis a decision can propagate (MAX_INT_32 = unbounded)
+    Vector3i get_influence_range_3d() const;
+
+    // Learns rules from a sample of size cells, tile ids laid out x first, then y, then z
+    // (-1 = empty). Same semantics as WFCRules2DNative::learn_from_grid().
+    void learn_from_grid_3d(const PackedInt32Array& tiles, const Vector3i& size, bool positive = true);
+};
+
+} // namespace godot
+
+#endif // WFC_RULES_3D_NATIVE_H
@@ -0,0 +1,326 @@
+#include "wfc_rules_compilation_native.h"
+#include "wfc_rules_3d_native.h"
+#include <godot_cpp/classes/random_number_generator.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include <map>
+
+namespace godot {
+
+void WFCRulesCompilation2DNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("compile", "rules", "prune_dead_tiles", "keep_tiles"), &WFCRulesCompilation2DNative::compile,
+                         DEFVAL(true), DEFVAL(PackedInt32Array()));
+    ClassDB::bind_method(D_METHOD("get_rules"), &WFCRulesCompilation2DNative::get_rules);
+    ClassDB::bind_method(D_METHOD("get_source_rules"), &WFCRulesCompilation2DNative::get_source_rules);
+    ClassDB::bind_method(D_METHOD("get_tile_classes"), &WFCRulesCompilation2DNative::get_tile_classes);
+    ClassDB::bind_method(D_METHOD("get_class_tiles", "class_id"), &WFCRulesCompilation2DNative::get_class_tiles);
+    ClassDB::bind_method(D_METHOD("get_class_count"), &WFCRulesCompilation2DNative::get_class_count);
+    ClassDB::bind_method(D_METHOD("get_pruned_tile_count"), &WFCRulesCompilation2DNative::get_pruned_tile_count);
+    ClassDB::bind_method(D_METHOD("reduce_domain", "domain"), &WFCRulesCompilation2DNative::reduce_domain);
+    ClassDB::bind_method(D_METHOD("reduce_palette_words", "palette_words", "palette_size"), &WFCRulesCompilation2DNative::reduce_palette_words);
+    ClassDB::bind_method(D_METHOD("reduce_solutions", "solutions"), &WFCRulesCompilation2DNative::reduce_solutions);
+    ClassDB::bind_method(D_METHOD("expand_solutions", "solutions", "seed", "palette_words", "domain_classes"),
+                         &WFCRulesCompilation2DNative::expand_solutions, DEFVAL(PackedInt64Array()), DEFVAL(PackedInt32Array()));
+}
+
+WFCRulesCompilation2DNative::WFCRulesCompilation2DNative() {
+}
+
+WFCRulesCompilation2DNative::~WFCRulesCompilation2DNative() {
+}
+
+int WFCRulesCompilation2DNative::source_words_per_domain() const {
+    return (static_cast<int>(tile_classes_.size()) + 63) / 64;
+}
+
+bool WFCRulesCompilation2DNative::compile(const Ref<WFCRules2DNative>& rules, bool prune_dead_tiles,
+                                          const PackedInt32Array& keep_tiles) {
+    ERR_FAIL_COND_V(rules.is_null(), false);
+    ERR_FAIL_COND_V_MSG(rules->get_tile_count() <= 0 || rules->get_axis_matrices().size() != rules->get_axes().size(), false,
+                        "Rules are not initialized");
+
+    const int tile_count = rules->get_tile_count();
+    const int axis_count = static_cast<int>(rules->get_axes().size());
+    const int words_per_row = (tile_count + 63) / 64;
+
+    std::vector<PackedInt64Array> forward(axis_count);
+    std::vector<PackedInt64Array> backward(axis_count);
+    for (int a = 0; a < axis_count; a++) {
+        Ref<WFCBitMatrixNative> matrix = rules->get_axis_matrices()[a];
+        forward[a] = matrix->get_words();
+        backward[a] = rules->get_transposed_matrix(a)->get_words();
+    }
+
+    std::vector<uint64_t> alive(words_per_row, 0);
+    for (int t = 0; t < tile_count; t++) {
+        alive[t / 64] |= uint64_t(1) << (t % 64);
+    }
+
+    std::vector<uint64_t> kept(words_per_row, 0);
+    for (int64_t i = 0; i < keep_tiles.size(); i++) {
+        const int32_t t = keep_tiles[i];
+        ERR_FAIL_COND_V_MSG(t < 0 || t >= tile_count, false, "Kept tile out of range");
+        kept[t / 64] |= uint64_t(1) << (t % 64);
+    }
+
+    auto is_alive = [&](int t) { return (alive[t / 64] >> (t % 64)) & 1; };
+    auto is_kept = [&](int t) { return (kept[t / 64] >> (t % 64)) & 1; };
+    auto has_alive_neighbour = [&](const PackedInt64Array& words, int t) {
+        const int64_t* row = words.ptr() + (int64_t)t * words_per_row;
+        for (int w = 0; w < words_per_row; w++) {
+            if (static_cast<uint64_t>(row[w]) & alive[w]) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Arc consistency on the rule graph: removing a tile may leave its neighbours unsupported
+    bool changed = prune_dead_tiles;
+    while (changed) {
+        changed = false;
+        for (int t = 0; t < tile_count; t++) {
+            if (!is_alive(t) || is_kept(t)) {
+                continue;
+            }
+            for (int a = 0; a < axis_count; a++) {
+                if (!has_alive_neighbour(forward[a], t) || !has_alive_neighbour(backward[a], t)) {
+                    alive[t / 64] &= ~(uint64_t(1) << (t % 64));
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    Ref<WFCBitSetNative> edge_domain = rules->get_edge_domain();
+
+    // Tiles with equal rows and columns among live tiles share a class
+    std::map<std::vector<uint64_t>, int> class_by_signature;
+    tile_classes_.resize(tile_count);
+    tile_classes_.fill(-1);
+    class_tiles_.clear();
+
+    std::vector<uint64_t> signature;
+    for (int t = 0; t < tile_count; t++) {
+        if (!is_alive(t)) {
+            continue;
+        }
+
+        signature.clear();
+        for (int a = 0; a < axis_count; a++) {
+            for (const PackedInt64Array* words : { &forward[a], &backward[a] }) {
+                const int64_t* row = words->ptr() + (int64_t)t * words_per_row;
+                for (int w = 0; w < words_per_row; w++) {
+                    signature.push_back(static_cast<uint64_t>(row[w]) & alive[w]);
+                }
+            }
+        }
+        signature.push_back(edge_domain.is_valid() && edge_domain->get_bit(t));
+
+        auto found = class_by_signature.find(signature);
+        if (found == class_by_signature.end()) {
+            found = class_by_signature.emplace(signature, static_cast<int>(class_tiles_.size())).first;
+            class_tiles_.emplace_back();
+        }
+        tile_classes_.set(t, found->second);
+        class_tiles_[found->second].push_back(t);
+    }
+
+    ERR_FAIL_COND_V_MSG(class_tiles_.empty(), false, "No tile can be placed with these rules");
+
+    const int class_count = static_cast<int>(class_tiles_.size());
+    const int class_words_per_row = (class_count + 63) / 64;
+
+    // Rules over 3D axes stay 3D
+    const WFCRules3DNative* rules_3d = Object::cast_to<WFCRules3DNative>(rules.ptr());
+    if (rules_3d) {
+        Ref<WFCRules3DNative> class_rules;
+        class_rules.instantiate();
+        class_rules->initialize_3d(class_count, rules_3d->get_axes_3d());
+        rules_ = class_rules;
+    } else {
+        rules_.instantiate();
+        rules_->initialize(class_count, rules->get_axes());
+    }
+    rules_->set_complete_matrices(rules->get_complete_matrices());
+    rules_->set_probabilities_enabled(rules->get_probabilities_enabled());
+
+    // Classes behave as their first tile
+    for (int a = 0; a < axis_count; a++) {
+        PackedInt64Array class_words;
+        class_words.resize((int64_t)class_count * class_words_per_row);
+        class_words.fill(0);
+        int64_t* dst = class_words.ptrw();
+
+        for (int cy = 0; cy < class_count; cy++) {
+            const int64_t* row = forward[a].ptr() + (int64_t)class_tiles_[cy][0] * words_per_row;
+            for (int w = 0; w < words_per_row; w++) {
+                uint64_t bits = static_cast<uint64_t>(row[w]) & alive[w];
+                while (bits) {
+                    int x = w * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    int cx = tile_classes_[x];
+                    dst[(int64_t)cy * class_words_per_row + cx / 64] |= int64_t(uint64_t(1) << (cx % 64));
+                }
+            }
+        }
+
+        rules_->set_axis_matrix_words(a, class_words);
+    }
+
+    PackedFloat32Array probabilities = rules->get_probabilities();
+    const bool has_probabilities = probabilities.size() == tile_count;
+    tile_weights_.assign(tile_count, 1.0f);
+
+    if (has_probabilities) {
+        PackedFloat32Array class_probabilities;
+        class_probabilities.resize(class_count);
+        class_probabilities.fill(0.0f);
+        for (int t = 0; t < tile_count; t++) {
+            tile_weights_[t] = probabilities[t];
+            if (tile_classes_[t] >= 0) {
+                class_probabilities.set(tile_classes_[t], class_probabilities[tile_classes_[t]] + probabilities[t]);
+            }
+        }
+        rules_->set_probabilities(class_probabilities);
+    }
+
+    if (edge_domain.is_valid()) {
+        rules_->set_edge_domain(reduce_domain(edge_domain));
+    }
+
+    source_rules_ = rules;
+    return true;
+}
+
+PackedInt32Array WFCRulesCompilation2DNative::get_class_tiles(int class_id) const {
+    PackedInt32Array res;
+    ERR_FAIL_INDEX_V(class_id, get_class_count(), res);
+
+    for (int t : class_tiles_[class_id]) {
+        res.append(t);
+    }
+    return res;
+}
+
+int WFCRulesCompilation2DNative::get_pruned_tile_count() const {
+    return static_cast<int>(tile_classes_.count(-1));
+}
+
+Ref<WFCBitSetNative> WFCRulesCompilation2DNative::reduce_domain(const Ref<WFCBitSetNative>& domain) const {
+    ERR_FAIL_COND_V(domain.is_null(), Ref<WFCBitSetNative>());
+
+    Ref<WFCBitSetNative> res;
+    res.instantiate();
+    res->initialize(get_class_count());
+
+    PackedInt64Array tiles = domain->to_array();
+    for (int64_t i = 0; i < tiles.size(); i++) {
+        if (tiles[i] < tile_classes_.size() && tile_classes_[tiles[i]] >= 0) {
+            res->set_bit(tile_classes_[tiles[i]], true);
+        }
+    }
+    return res;
+}
+
+PackedInt64Array WFCRulesCompilation2DNative::reduce_palette_words(const PackedInt64Array& palette_words, int palette_size) const {
+    PackedInt64Array res;
+    ERR_FAIL_COND_V(palette_size <= 0 || palette_words.size() % palette_size != 0, res);
+
+    const int64_t words_per_domain = palette_words.size() / palette_size;
+    const int class_words = (get_class_count() + 63) / 64;
+    const int64_t tile_bits = std::min<int64_t>(tile_classes_.size(), words_per_domain * 64);
+
+    res.resize((int64_t)palette_size * class_words);
+    res.fill(0);
+    int64_t* dst = res.ptrw();
+
+    for (int p = 0; p < palette_size; p++) {
+        const int64_t* src = palette_words.ptr() + p * words_per_domain;
+        for (int64_t t = 0; t < tile_bits; t++) {
+            int c = tile_classes_[t];
+            if (c >= 0 && ((static_cast<uint64_t>(src[t / 64]) >> (t % 64)) & 1)) {
+                dst[(int64_t)p * class_words + c / 64] |= int64_t(uint64_t(1) << (c % 64));
+            }
+        }
+    }
+
+    return res;
+}
+
+PackedInt32Array WFCRulesCompilation2DNative::reduce_solutions(const PackedInt32Array& solutions) const {
+    PackedInt32Array res;
+    res.resize(solutions.size());
+
+    const int32_t* src = solutions.ptr();
+    int32_t* dst = res.ptrw();
+    for (int64_t i = 0; i < solutions.size(); i++) {
+        // Pruned tiles cannot be represented, such cells are left to the solver
+        dst[i] = (src[i] >= 0 && src[i] < tile_classes_.size()) ? tile_classes_[src[i]] : -1;
+    }
+    return res;
+}
+
+PackedInt64Array WFCRulesCompilation2DNative::expand_solutions(const PackedInt64Array& solutions, int64_t seed,
+                                                               const PackedInt64Array& palette_words,
+                                                               const PackedInt32Array& domain_classes) const {
+    PackedInt64Array res = solutions;
+    const int words_per_domain = source_words_per_domain();
+    const bool has_domains = words_per_domain > 0 && domain_classes.size() == solutions.size();
+    const int64_t palette_size = has_domains ? palette_words.size() / words_per_domain : 0;
+
+    Ref<RandomNumberGenerator> rng;
+    rng.instantiate();
+    rng->set_seed(static_cast<uint64_t>(seed));
+
+    std::vector<int> candidates;
+    int64_t* dst = res.ptrw();
+
+    for (int64_t i = 0; i < res.size(); i++) {
+        const int64_t class_id = dst[i];
+        if (class_id < 0 || class_id >= get_class_count()) {
+            continue;
+        }
+
+        const std::vector<int>& members = class_tiles_[class_id];
+        if (members.size() == 1) {
+            dst[i] = members[0];
+            continue;
+        }
+
+        candidates.clear();
+        const int32_t domain_class = has_domains ? domain_classes[i] : -1;
+        if (domain_class >= 0 && domain_class < palette_size) {
+            const int64_t* domain = palette_words.ptr() + (int64_t)domain_class * words_per_domain;
+            for (int t : members) {
+                if ((static_cast<uint64_t>(domain[t / 64]) >> (t % 64)) & 1) {
+                    candidates.push_back(t);
+                }
+            }
+        }
+        if (candidates.empty()) {
+            candidates = members;
+        }
+
+        float total = 0.0f;
+        for (int t : candidates) {
+            total += tile_weights_[t];
+        }
+
+        float r = rng->randf() * total;
+        int chosen = candidates.back();
+        for (int t : candidates) {
+            r -= tile_weights_[t];
+            if (r < 0.0f) {
+                chosen = t;
+                break;
+            }
+        }
+        dst[i] = chosen;
+    }
+
+    return res;
+}
+
+} // namespace godot
@@ -0,0 +1,71 @@
+#ifndef WFC_RULES_COMPILATION_NATIVE_H
+#define WFC_RULES_COMPILATION_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include "wfc_bitset_native.h"
+#include "wfc_rules_2d_native.h"
+
+#include <vector>
+
+namespace godot {
+
+// Reduced form of WFCRules2DNative for solving.
+//
+// Tiles with equal rows and columns in every axis matrix (and equal edge domain membership)
+// are merged into one class. With prune_dead_tiles, tiles lacking a compatible neighbour
+// along some direction are removed until no such tile is left. Problems are solved over
+// classes, solutions are expanded back to tiles by sampling class members by probability.
+// WFCRules3DNative compiles to WFCRules3DNative over the same axes.
+class WFCRulesCompilation2DNative : public RefCounted {
+    GDCLASS(WFCRulesCompilation2DNative, RefCounted)
+
+private:
+    Ref<WFCRules2DNative> source_rules_;
+    Ref<WFCRules2DNative> rules_;
+    PackedInt32Array tile_classes_;
+    std::vector<std::vector<int>> class_tiles_;
+    std::vector<float> tile_weights_;
+
+    int source_words_per_domain() const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCRulesCompilation2DNative();
+    ~WFCRulesCompilation2DNative();
+
+    // Builds the class rules. Pruning assumes every placed tile needs a neighbour in each
+    // direction, so tiles only valid on the border of a problem are removed as well.
+    // Tiles in keep_tiles (e.g. fixed by preconditions) are never pruned.
+    bool compile(const Ref<WFCRules2DNative>& rules, bool prune_dead_tiles = true,
+                 const PackedInt32Array& keep_tiles = PackedInt32Array());
+
+    // Rules over classes, to initialize problems with
+    Ref<WFCRules2DNative> get_rules() const { return rules_; }
+    Ref<WFCRules2DNative> get_source_rules() const { return source_rules_; }
+
+    // Class of each tile, -1 for pruned tiles
+    PackedInt32Array get_tile_classes() const { return tile_classes_; }
+    PackedInt32Array get_class_tiles(int class_id) const;
+    int get_class_count() const { return static_cast<int>(class_tiles_.size()); }
+    int get_pruned_tile_count() const;
+
+    // Tile space to class space: a class is allowed when any of its tiles is
+    Ref<WFCBitSetNative> reduce_domain(const Ref<WFCBitSetNative>& domain) const;
+    PackedInt64Array reduce_palette_words(const PackedInt64Array& palette_words, int palette_size) const;
+    PackedInt32Array reduce_solutions(const PackedInt32Array& solutions) const;
+
+    // Class space to tile space. Negative entries are kept. Tiles are drawn by probability
+    // among members of the class; with palette_words/domain_classes given in tile space (same
+    // cell order as solutions), only among members allowed in the cell.
+    PackedInt64Array expand_solutions(const PackedInt64Array& solutions, int64_t seed,
+                                      const PackedInt64Array& palette_words = PackedInt64Array(),
+                                      const PackedInt32Array& domain_classes = PackedInt32Array()) const;
+};
+
+} // namespace godot
+
+#endif // WFC_RULES_COMPILATION_NATIVE_H
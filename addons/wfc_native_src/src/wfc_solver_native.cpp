@@ -2,6 +2,8 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <algorithm>
+
 namespace godot {
 
 void WFCSolverNative::_bind_methods() {
@@ -19,6 +21,10 @@ void WFCSolverNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_backtracking_count"), &WFCSolverNative::get_backtracking_count);
     ClassDB::bind_method(D_METHOD("set_backtracking_count", "val"), &WFCSolverNative::set_backtracking_count);
 
+    ClassDB::bind_method(D_METHOD("get_restart_count"), &WFCSolverNative::get_restart_count);
+    ClassDB::bind_method(D_METHOD("get_backjump_count"), &WFCSolverNative::get_backjump_count);
+    ClassDB::bind_method(D_METHOD("get_recovery_count"), &WFCSolverNative::get_recovery_count);
+
     ClassDB::bind_method(D_METHOD("get_ac4_enabled"), &WFCSolverNative::get_ac4_enabled);
     ClassDB::bind_method(D_METHOD("set_ac4_enabled", "val"), &WFCSolverNative::set_ac4_enabled);
 
@@ -28,8 +34,13 @@ void WFCSolverNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_best_state"), &WFCSolverNative::get_best_state);
     ClassDB::bind_method(D_METHOD("set_best_state", "val"), &WFCSolverNative::set_best_state);
 
+    ClassDB::bind_method(D_METHOD("get_cancellation_token"), &WFCSolverNative::get_cancellation_token);
+    ClassDB::bind_method(D_METHOD("set_cancellation_token", "val"), &WFCSolverNative::set_cancellation_token);
+    ClassDB::bind_method(D_METHOD("is_cancelled"), &WFCSolverNative::is_cancelled);
+
     ClassDB::bind_method(D_METHOD("solve_step"), &WFCSolverNative::solve_step);
     ClassDB::bind_method(D_METHOD("solve"), &WFCSolverNative::solve);
+    ClassDB::bind_method(D_METHOD("resolve_region", "solution", "dirty_cells", "preconditions", "margin", "max_margin"), &WFCSolverNative::resolve_region, DEFVAL(Dictionary()), DEFVAL(1), DEFVAL(16));
 
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "settings", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverSettingsNative"), "set_settings", "get_settings");
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "problem", PROPERTY_HINT_RESOURCE_TYPE, "WFCProblemNative"), "set_problem", "get_problem");
@@ -38,6 +49,7 @@ void WFCSolverNative::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "ac4_enabled"), "set_ac4_enabled", "get_ac4_enabled");
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "current_state", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverStateNative"), "set_current_state", "get_current_state");
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "best_state", PROPERTY_HINT_RESOURCE_TYPE, "WFCSolverStateNative"), "set_best_state", "get_best_state");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "cancellation_token", PROPERTY_HINT_RESOURCE_TYPE, "WFCCancellationTokenNative"), "set_cancellation_token", "get_cancellation_token");
 }
 
 WFCSolverNative::WFCSolverNative() {
@@ -58,12 +70,7 @@ Ref<WFCSolverStateNative> WFCSolverNative::make_initial_state(int num_cells, con
     state->set_cell_domains(cell_domains);
 
     int64_t entropy = -(initial_domain->count_set_bits() - 1);
-    PackedInt64Array solution_or_entropy;
-    solution_or_entropy.resize(num_cells);
-    for (int i = 0; i < num_cells; i++) {
-        solution_or_entropy[i] = entropy;
-    }
-    state->set_cell_solution_or_entropy(solution_or_entropy);
+    state->fill_cell_solution_or_entropy(num_cells, entropy);
 
     state->set_unsolved_cells(num_cells);
     state->set_observations_count(0);
@@ -81,18 +88,38 @@ void WFCSolverNative::initialize(const Ref<WFCProblemNative>& problem, const Ref
     backtracking_enabled_ = settings_->get_allow_backtracking();
     problem_ = problem;
     ac4_enabled_ = (!settings_->get_force_ac3()) && problem_->supports_ac4();
+    backjumping_enabled_ = backtracking_enabled_ && settings_->get_backjumping();
+    conflict_level_ = -1;
+    backjump_count_ = 0;
 
     current_state_ = make_initial_state(
         problem_->get_cell_count(),
         problem_->get_default_domain()
     );
     best_state_ = current_state_;
+    backtrack_cursor_ = Ref<WFCSolverStateNative>();
+
+    root_state_ = Ref<WFCSolverStateNative>();
+    restart_count_ = 0;
+    conflicts_since_restart_ = 0;
+    phase_hints_ = PackedInt64Array();
+    if (problem_->get_rng().is_valid()) {
+        restart_seed_ = problem_->get_rng()->get_seed();
+    }
 
     if (ac4_enabled_) {
         ac4_constraints_ = problem_->get_ac4_binary_constraints();
     }
 
     problem_->populate_initial_state(current_state_);
+
+    failed_cells_.clear();
+    recovery_attempts_.clear();
+    recovery_count_ = 0;
+    initial_domains_ = TypedArray<WFCBitSetNative>();
+    if (settings_->get_failure_recovery_radius() > 0) {
+        initial_domains_ = current_state_->get_cell_domains().duplicate();
+    }
 }
 
 bool WFCSolverNative::propagate_constraints_ac3() {
@@ -101,6 +128,9 @@ bool WFCSolverNative::propagate_constraints_ac3() {
     PackedInt64Array related;
     int related_count = 0;
 
+    // With backjumping, the highest reason level among changed neighbours of each related cell
+    PackedInt32Array related_reasons;
+
     while (true) {
         PackedInt64Array changed = current_state_->extract_changed_cells();
 
@@ -114,6 +144,7 @@ bool WFCSolverNative::propagate_constraints_ac3() {
         // Use get_related_cells to find neighbors of changed cells
         for (int i = 0; i < changed.size(); i++) {
             int cell_id = changed[i];
+            int reason = backjumping_enabled_ ? current_state_->get_cell_reason_level(cell_id) : 0;
 
             PackedInt64Array related_cells = problem_->get_related_cells(cell_id);
 
@@ -125,12 +156,21 @@ bool WFCSolverNative::propagate_constraints_ac3() {
                     for (int k = 0; k < related_count; k++) {
                         if (related[k] == related_cell_id) {
                             found = true;
+                            if (backjumping_enabled_ && related_reasons[k] < reason) {
+                                related_reasons.set(k, reason);
+                            }
                             break;
                         }
                     }
                     if (!found) {
                         if (related_count >= related.size()) {
                             related.resize(related.size() + 16);
+                            if (backjumping_enabled_) {
+                                related_reasons.resize(related.size());
+                            }
+                        }
+                        if (backjumping_enabled_) {
+                            related_reasons.set(related_count, reason);
                         }
                         related.set(related_count++, related_cell_id);
                     }
@@ -140,8 +180,21 @@ bool WFCSolverNative::propagate_constraints_ac3() {
 
         // Process related cells directly without creating keys array
         for (int i = 0; i < related_count; i++) {
+            if (is_cancelled()) {
+                // Recomputing domains is idempotent, so the whole wave is simply re-queued
+                current_state_->requeue_changed_cells(changed);
+                return false;
+            }
+
             int related_cell_id = related[i];
 
+            // The recomputed domain depends on every neighbour, each of which queued this
+            // cell when it last changed, so raising on every revision keeps the level complete
+            int reason_level = 0;
+            if (backjumping_enabled_) {
+                reason_level = current_state_->raise_cell_reason_level(related_cell_id, related_reasons[i]);
+            }
+
             Ref<WFCBitSetNative> new_domain = problem_->compute_cell_domain(
                 current_state_, related_cell_id
             );
@@ -151,8 +204,12 @@ bool WFCSolverNative::propagate_constraints_ac3() {
                 new_domain
             );
 
-            if (should_backtrack && backtracking_enabled_) {
-                return true;
+            if (should_backtrack) {
+                if (backtracking_enabled_) {
+                    conflict_level_ = reason_level;
+                    return true;
+                }
+                record_failed_cell(related_cell_id);
             }
         }
     }
@@ -175,6 +232,12 @@ bool WFCSolverNative::propagate_constraints_ac4() {
         TypedArray<WFCBitSetNative> ac4_acknowledged_domains = state->get_ac4_acknowledged_domains();
 
         for (int c = 0; c < changed_cells.size(); c++) {
+            if (is_cancelled()) {
+                // Counters of cells before c are already updated, only the rest is re-queued
+                state->requeue_changed_cells(changed_cells, c);
+                return false;
+            }
+
             int cell_id = changed_cells[c];
             Ref<WFCBitSetNative> new_domain = cell_domains[cell_id];
             Ref<WFCBitSetNative> prev_acknowledged_domain = ac4_acknowledged_domains[cell_id];
@@ -218,11 +281,18 @@ bool WFCSolverNative::propagate_constraints_ac4() {
                 });
 
                 if (dependent_domain_changed) {
+                    // Removals through this constraint only depend on the history of cell_id
+                    int reason_level = 0;
+                    if (backjumping_enabled_) {
+                        reason_level = state->raise_cell_reason_level(dependent_cell, state->get_cell_reason_level(cell_id));
+                    }
+
                     if (dependent_domain->is_empty()) {
                         if (backtracking_enabled_) {
+                            conflict_level_ = reason_level;
                             return true;
                         }
-                        // TODO: Handle contradiction in non-backtracking mode
+                        record_failed_cell(dependent_cell);
                     }
 
                     state->set_domain(dependent_cell, dependent_domain);
@@ -252,13 +322,60 @@ void WFCSolverNative::continue_without_backtracking() {
 }
 
 bool WFCSolverNative::try_backtrack() {
-    if (settings_->get_backtracking_limit() > 0 && backtracking_count_ > settings_->get_backtracking_limit()) {
-        // Debug: Backtracking limit exceeded
-        continue_without_backtracking();
-        return false;
+    Ref<WFCSolverStateNative> ancestor = backtrack_cursor_;
+    backtrack_cursor_ = Ref<WFCSolverStateNative>();
+
+    if (ancestor.is_null()) {
+        if (settings_->get_backtracking_limit() > 0 && backtracking_count_ > settings_->get_backtracking_limit()) {
+            // Debug: Backtracking limit exceeded
+            continue_without_backtracking();
+            return false;
+        }
+
+        conflicts_since_restart_ += 1;
+        if (should_restart()) {
+            restart();
+            return false;
+        }
+
+        ancestor = current_state_->get_previous();
+
+        // Decisions above the conflict level did not contribute to the contradiction,
+        // retrying them would fail the same way
+        if (backjumping_enabled_ && conflict_level_ >= 0) {
+            Ref<WFCSolverStateNative> latest = ancestor;
+            while (ancestor.is_valid() && ancestor->get_observations_count() >= conflict_level_) {
+                ancestor = ancestor->get_previous();
+            }
+            if (ancestor != latest) {
+                backjump_count_ += 1;
+            }
+        }
+        conflict_level_ = -1;
     }
 
-    current_state_ = current_state_->backtrack(problem_);
+    // Same walk as WFCSolverStateNative::backtrack(), but it can be interrupted between
+    // ancestors and resumed by the next solve_step()
+    Ref<WFCSolverStateNative> next_state;
+    while (ancestor.is_valid()) {
+        if (is_cancelled()) {
+            backtrack_cursor_ = ancestor;
+            return true;
+        }
+
+        next_state = ancestor->diverge(problem_);
+        if (next_state.is_valid()) {
+            break;
+        }
+
+        ancestor = ancestor->get_previous();
+    }
+
+    if (next_state.is_valid() && backjumping_enabled_) {
+        next_state->raise_cell_reason_level(ancestor->get_divergence_cell(), next_state->get_observations_count());
+    }
+
+    current_state_ = next_state;
 
     if (current_state_.is_null()) {
         if (!settings_->get_require_backtracking()) {
@@ -274,6 +391,101 @@ bool WFCSolverNative::try_backtrack() {
     return false;
 }
 
+bool WFCSolverNative::should_restart() const {
+    if (root_state_.is_null() || !backtracking_enabled_) {
+        return false;
+    }
+
+    int max_restarts = settings_->get_max_restarts();
+    if (max_restarts >= 0 && restart_count_ >= max_restarts) {
+        return false;
+    }
+
+    int64_t interval = settings_->get_restart_interval(restart_count_);
+    return interval > 0 && conflicts_since_restart_ >= interval;
+}
+
+void WFCSolverNative::restart() {
+    if (settings_->get_restart_phase_hints()) {
+        phase_hints_ = best_state_->get_cell_solution_or_entropy();
+    }
+
+    restart_count_ += 1;
+    conflicts_since_restart_ = 0;
+    conflict_level_ = -1;
+
+    // Fresh random stream per restart, still reproducible from the problem's seed.
+    // Without own RNG the global one just keeps going.
+    Ref<RandomNumberGenerator> rng = problem_->get_rng();
+    if (rng.is_valid()) {
+        rng->set_seed(restart_seed_ + static_cast<uint64_t>(restart_count_) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    // Whole history is dropped, the root copy is kept untouched for the next restart
+    current_state_ = root_state_->make_copy();
+}
+
+int64_t WFCSolverNative::get_phase_hint(int cell_id) const {
+    if (cell_id < 0 || cell_id >= phase_hints_.size()) {
+        return -1;
+    }
+
+    int64_t hint = phase_hints_[cell_id];
+    return hint == WFCSolverStateNative::CELL_SOLUTION_FAILED ? -1 : hint;
+}
+
+bool WFCSolverNative::is_failure_recovery_enabled() const {
+    return !backtracking_enabled_ && !initial_domains_.is_empty();
+}
+
+void WFCSolverNative::record_failed_cell(int cell_id) {
+    if (is_failure_recovery_enabled()) {
+        failed_cells_.push_back(cell_id);
+    }
+}
+
+bool WFCSolverNative::recover_failed_cells() {
+    int base_radius = settings_->get_failure_recovery_radius();
+    int max_attempts = settings_->get_failure_recovery_attempts();
+    bool recovered = false;
+
+    if (recovery_attempts_.empty()) {
+        recovery_attempts_.resize(initial_domains_.size(), 0);
+    }
+
+    for (int cell_id : failed_cells_) {
+        // Already reset as part of an earlier area
+        if (current_state_->get_cell_solution(cell_id) != WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+            continue;
+        }
+
+        int attempts = recovery_attempts_[cell_id];
+        if (attempts >= max_attempts) {
+            continue;
+        }
+
+        // Every cell of the area remembers the attempt, so repeated failures nearby grow the area
+        PackedInt64Array area = problem_->get_cells_in_radius(cell_id, base_radius + attempts);
+        for (int64_t i = 0; i < area.size(); i++) {
+            int area_cell = static_cast<int>(area[i]);
+            current_state_->reset_cell_domain(area_cell, initial_domains_[area_cell]);
+            recovery_attempts_[area_cell] = std::max(recovery_attempts_[area_cell], attempts + 1);
+        }
+
+        recovery_count_ += 1;
+        recovered = true;
+    }
+
+    failed_cells_.clear();
+
+    // AC4 counters only support removals, rebuild them from the restored domains
+    if (recovered && ac4_enabled_) {
+        current_state_->set_ac4_counters(PackedInt32Array());
+    }
+
+    return recovered;
+}
+
 bool WFCSolverNative::should_keep_previous_state(const Ref<WFCSolverStateNative>& state) const {
     if (!backtracking_enabled_) {
         return false;
@@ -297,6 +509,14 @@ bool WFCSolverNative::should_keep_previous_state(const Ref<WFCSolverStateNative>
 }
 
 bool WFCSolverNative::solve_step() {
+    if (is_cancelled()) {
+        return true;
+    }
+
+    if (backtrack_cursor_.is_valid()) {
+        return try_backtrack();
+    }
+
     if (current_state_->is_all_solved()) {
         return true;
     }
@@ -307,16 +527,33 @@ bool WFCSolverNative::solve_step() {
         return try_backtrack();
     }
 
+    // Propagation stops early when cancelled, leaving the rest of the wave queued
+    if (is_cancelled()) {
+        return true;
+    }
+
+    if (!failed_cells_.empty() && recover_failed_cells()) {
+        // Restored areas are propagated by the next step
+        return false;
+    }
+
     if (current_state_->is_all_solved()) {
         return true;
     } else if (current_state_->get_unsolved_cells() < best_state_->get_unsolved_cells()) {
         best_state_ = current_state_;
     }
 
-    current_state_->prepare_divergence();
+    if (root_state_.is_null() && settings_->get_restart_policy() != WFCSolverSettingsNative::RESTART_NONE &&
+        current_state_->get_observations_count() == 0) {
+        root_state_ = current_state_->make_copy();
+    }
+
+    current_state_->prepare_divergence(problem_);
+    int divergence_cell = current_state_->get_divergence_cell();
+    int64_t hint = get_phase_hint(divergence_cell);
 
     if (should_keep_previous_state(current_state_)) {
-        Ref<WFCSolverStateNative> next_state = current_state_->diverge(problem_);
+        Ref<WFCSolverStateNative> next_state = current_state_->diverge(problem_, hint);
 
         if (next_state.is_null()) {
             return try_backtrack();
@@ -324,7 +561,11 @@ bool WFCSolverNative::solve_step() {
             current_state_ = next_state;
         }
     } else {
-        current_state_->diverge_in_place(problem_);
+        current_state_->diverge_in_place(problem_, hint);
+    }
+
+    if (backjumping_enabled_) {
+        current_state_->raise_cell_reason_level(divergence_cell, current_state_->get_observations_count());
     }
 
     return false;
@@ -338,4 +579,190 @@ Ref<WFCSolverStateNative> WFCSolverNative::solve() {
     return current_state_;
 }
 
+Ref<WFCSolverStateNative> WFCSolverNative::make_region_state(const PackedInt64Array& solution, const std::vector<uint8_t>& in_region, int region_size) {
+    const int num_cells = static_cast<int>(in_region.size());
+    Ref<WFCBitSetNative> default_domain = problem_->get_default_domain();
+    const int tile_count = default_domain->get_size();
+
+    // Fixed cells share one domain object per tile
+    std::vector<Ref<WFCBitSetNative>> tile_domains(tile_count);
+    Ref<WFCBitSetNative> failed_domain;
+    failed_domain.instantiate();
+    failed_domain->initialize(tile_count);
+
+    TypedArray<WFCBitSetNative> cell_domains;
+    cell_domains.resize(num_cells);
+    PackedInt64Array solution_or_entropy;
+    solution_or_entropy.resize(num_cells);
+    Dictionary candidates;
+    PackedInt64Array boundary;
+
+    int64_t entropy = -(default_domain->count_set_bits() - 1);
+    const int64_t* src = solution.ptr();
+
+    for (int cell_id = 0; cell_id < num_cells; cell_id++) {
+        if (in_region[cell_id]) {
+            cell_domains[cell_id] = default_domain;
+            solution_or_entropy.set(cell_id, entropy);
+            candidates[cell_id] = true;
+            continue;
+        }
+
+        int64_t tile = src[cell_id];
+        if (tile < 0 || tile >= tile_count) {
+            // Unsolved or failed outside the region: no constraint, same as a failed cell
+            cell_domains[cell_id] = failed_domain;
+            solution_or_entropy.set(cell_id, WFCSolverStateNative::CELL_SOLUTION_FAILED);
+            continue;
+        }
+
+        if (tile_domains[tile].is_null()) {
+            tile_domains[tile].instantiate();
+            tile_domains[tile]->initialize(tile_count);
+            tile_domains[tile]->set_bit(static_cast<int>(tile), true);
+        }
+        cell_domains[cell_id] = tile_domains[tile];
+        solution_or_entropy.set(cell_id, tile);
+    }
+
+    // Propagation starts from fixed cells next to the region
+    std::vector<uint8_t> queued(num_cells, 0);
+    for (int cell_id = 0; cell_id < num_cells; cell_id++) {
+        if (!in_region[cell_id]) {
+            continue;
+        }
+
+        PackedInt64Array related = problem_->get_related_cells(cell_id);
+        for (int64_t i = 0; i < related.size(); i++) {
+            int other_id = static_cast<int>(related[i]);
+            if (!in_region[other_id] && !queued[other_id]) {
+                queued[other_id] = 1;
+                boundary.append(other_id);
+            }
+        }
+    }
+
+    Ref<WFCSolverStateNative> state;
+    state.instantiate();
+    state->set_cell_domains(cell_domains);
+    state->set_cell_solution_or_entropy(solution_or_entropy);
+    state->set_unsolved_cells(region_size);
+    state->set_observations_count(0);
+    state->set_divergence_candidates(candidates);
+    state->set_changed_cells(boundary);
+
+    return state;
+}
+
+Ref<WFCSolverStateNative> WFCSolverNative::resolve_region(const PackedInt64Array& solution,
+                                                          const PackedInt64Array& dirty_cells,
+                                                          const Dictionary& preconditions,
+                                                          int margin,
+                                                          int max_margin) {
+    ERR_FAIL_COND_V_MSG(problem_.is_null() || settings_.is_null(), Ref<WFCSolverStateNative>(), "Solver is not initialized");
+
+    const int num_cells = problem_->get_cell_count();
+    ERR_FAIL_COND_V_MSG(solution.size() != num_cells, Ref<WFCSolverStateNative>(), "Solution does not match the problem");
+
+    PackedInt64Array seeds = dirty_cells.duplicate();
+    Array precondition_cells = preconditions.keys();
+    for (int64_t i = 0; i < precondition_cells.size(); i++) {
+        seeds.append(precondition_cells[i]);
+    }
+
+    // Region solves are local: AC4 counters would have to be built for the whole problem,
+    // failure recovery resets to initial domains of the whole problem
+    bool saved_ac4_enabled = ac4_enabled_;
+    TypedArray<WFCBitSetNative> saved_initial_domains = initial_domains_;
+    ac4_enabled_ = false;
+    initial_domains_ = TypedArray<WFCBitSetNative>();
+
+    Ref<WFCSolverStateNative> result;
+
+    for (int radius = std::max(margin, 0);; radius = std::min(std::max(radius * 2, 1), max_margin)) {
+        std::vector<uint8_t> in_region(num_cells, 0);
+        int region_size = 0;
+
+        for (int64_t i = 0; i < seeds.size(); i++) {
+            int cell_id = static_cast<int>(seeds[i]);
+            if (cell_id < 0 || cell_id >= num_cells) {
+                continue;
+            }
+
+            PackedInt64Array area = problem_->get_cells_in_radius(cell_id, radius);
+            for (int64_t j = 0; j < area.size(); j++) {
+                if (!in_region[area[j]]) {
+                    in_region[area[j]] = 1;
+                    region_size++;
+                }
+            }
+        }
+
+        current_state_ = make_region_state(solution, in_region, region_size);
+
+        for (int64_t i = 0; i < precondition_cells.size(); i++) {
+            int cell_id = precondition_cells[i];
+            Variant value = preconditions[precondition_cells[i]];
+            if (cell_id < 0 || cell_id >= num_cells) {
+                continue;
+            }
+
+            Ref<WFCBitSetNative> domain;
+            if (value.get_type() == Variant::INT) {
+                domain.instantiate();
+                domain->initialize(problem_->get_default_domain()->get_size());
+                domain->set_bit(static_cast<int>(value), true);
+            } else {
+                domain = value;
+            }
+
+            if (domain.is_valid()) {
+                current_state_->set_domain(cell_id, domain);
+            }
+        }
+
+        best_state_ = current_state_;
+        backtrack_cursor_ = Ref<WFCSolverStateNative>();
+        root_state_ = Ref<WFCSolverStateNative>();
+        backtracking_enabled_ = settings_->get_allow_backtracking();
+        backtracking_count_ = 0;
+        conflict_level_ = -1;
+        backjump_count_ = 0;
+        restart_count_ = 0;
+        conflicts_since_restart_ = 0;
+        failed_cells_.clear();
+
+        while (!solve_step()) {
+            // Continue solving
+        }
+
+        if (is_cancelled() || current_state_.is_null()) {
+            break;
+        }
+
+        bool solved = current_state_->is_all_solved();
+        PackedInt64Array solution_or_entropy = current_state_->get_cell_solution_or_entropy();
+        const int64_t* cells = solution_or_entropy.ptr();
+        for (int cell_id = 0; solved && cell_id < num_cells; cell_id++) {
+            if (in_region[cell_id] && cells[cell_id] == WFCSolverStateNative::CELL_SOLUTION_FAILED) {
+                solved = false;
+            }
+        }
+
+        if (solved) {
+            result = current_state_;
+            break;
+        }
+
+        if (radius >= max_margin || region_size >= num_cells) {
+            break;
+        }
+    }
+
+    ac4_enabled_ = saved_ac4_enabled;
+    initial_domains_ = saved_initial_domains;
+
+    return result;
+}
+
 } // namespace godot
@@ -6,6 +6,9 @@
 #include "wfc_solver_settings_native.h"
 #include "wfc_solver_state_native.h"
 #include "wfc_problem_native.h"
+#include "wfc_cancellation_token_native.h"
+
+#include <vector>
 
 namespace godot {
 
@@ -18,9 +21,32 @@ private:
     bool backtracking_enabled_ = true;
     int backtracking_count_ = 0;
     bool ac4_enabled_ = false;
+
+    // Backjumping: decision level the last contradiction depends on, -1 when unknown
+    bool backjumping_enabled_ = false;
+    int conflict_level_ = -1;
+    int backjump_count_ = 0;
     TypedArray<WFCProblemAC4BinaryConstraintNative> ac4_constraints_;
     Ref<WFCSolverStateNative> current_state_;
     Ref<WFCSolverStateNative> best_state_;
+    Ref<WFCCancellationTokenNative> cancellation_token_;
+
+    // Ancestor state where an interrupted backtracking walk continues
+    Ref<WFCSolverStateNative> backtrack_cursor_;
+
+    // Restarts (see WFCSolverSettingsNative::RestartPolicy)
+    Ref<WFCSolverStateNative> root_state_;
+    int restart_count_ = 0;
+    int64_t conflicts_since_restart_ = 0;
+    uint64_t restart_seed_ = 0;
+    PackedInt64Array phase_hints_;
+
+    // Failure recovery without backtracking: domains after populate_initial_state(),
+    // cells failed during the last propagation and recoveries per cell so far
+    TypedArray<WFCBitSetNative> initial_domains_;
+    std::vector<int> failed_cells_;
+    std::vector<int> recovery_attempts_;
+    int recovery_count_ = 0;
 
     Ref<WFCSolverStateNative> make_initial_state(int num_cells, const Ref<WFCBitSetNative>& initial_domain);
     bool propagate_constraints_ac3();
@@ -28,6 +54,16 @@ private:
     bool propagate_constraints();
     void continue_without_backtracking();
     bool try_backtrack();
+    bool should_restart() const;
+    void restart();
+    int64_t get_phase_hint(int cell_id) const;
+    bool is_failure_recovery_enabled() const;
+    void record_failed_cell(int cell_id);
+    bool recover_failed_cells();
+
+    // State with cells outside the region fixed to `solution`, region cells open
+    // and the boundary ring queued for propagation
+    Ref<WFCSolverStateNative> make_region_state(const PackedInt64Array& solution, const std::vector<uint8_t>& in_region, int region_size);
     bool should_keep_previous_state(const Ref<WFCSolverStateNative>& state) const;
 
 protected:
@@ -52,6 +88,13 @@ public:
     int get_backtracking_count() const { return backtracking_count_; }
     void set_backtracking_count(int val) { backtracking_count_ = val; }
 
+    int get_restart_count() const { return restart_count_; }
+
+    // Backtracks that skipped at least one decision unrelated to the contradiction
+    int get_backjump_count() const { return backjump_count_; }
+
+    int get_recovery_count() const { return recovery_count_; }
+
     bool get_ac4_enabled() const { return ac4_enabled_; }
     void set_ac4_enabled(bool val) { ac4_enabled_ = val; }
 
@@ -61,9 +104,26 @@ public:
     Ref<WFCSolverStateNative> get_best_state() const { return best_state_; }
     void set_best_state(const Ref<WFCSolverStateNative>& val) { best_state_ = val; }
 
+    Ref<WFCCancellationTokenNative> get_cancellation_token() const { return cancellation_token_; }
+    void set_cancellation_token(const Ref<WFCCancellationTokenNative>& val) { cancellation_token_ = val; }
+
+    bool is_cancelled() const { return cancellation_token_.is_valid() && cancellation_token_->is_cancelled(); }
+
     // Methods
     bool solve_step();
     Ref<WFCSolverStateNative> solve();
+
+    // Re-solves the neighbourhood of dirty cells in a finished solution of the problem
+    // given to initialize(). Cells within `margin` of a dirty cell are re-opened and
+    // solved against the fixed cells around them; when that fails, the margin is doubled
+    // up to max_margin. `preconditions` maps cell ids to a tile or a WFCBitSetNative domain,
+    // its cells are dirty too. Preconditions of the problem itself are not re-applied.
+    // Always propagates with AC3. Returns the new state, null when no margin worked.
+    Ref<WFCSolverStateNative> resolve_region(const PackedInt64Array& solution,
+                                             const PackedInt64Array& dirty_cells,
+                                             const Dictionary& preconditions = Dictionary(),
+                                             int margin = 1,
+                                             int max_margin = 16);
 };
 
 } // namespace godot
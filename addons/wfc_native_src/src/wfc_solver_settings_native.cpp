@@ -1,10 +1,14 @@
 #include "wfc_solver_settings_native.h"
 #include <godot_cpp/core/class_db.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace godot {
 
 void WFCSolverSettingsNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("is_sparse_history_enabled"), &WFCSolverSettingsNative::is_sparse_history_enabled);
+    ClassDB::bind_method(D_METHOD("get_restart_interval", "restart_index"), &WFCSolverSettingsNative::get_restart_interval);
 
     // Property getters/setters
     ClassDB::bind_method(D_METHOD("get_allow_backtracking"), &WFCSolverSettingsNative::get_allow_backtracking);
@@ -25,6 +29,30 @@ void WFCSolverSettingsNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_force_ac3"), &WFCSolverSettingsNative::get_force_ac3);
     ClassDB::bind_method(D_METHOD("set_force_ac3", "val"), &WFCSolverSettingsNative::set_force_ac3);
 
+    ClassDB::bind_method(D_METHOD("get_restart_policy"), &WFCSolverSettingsNative::get_restart_policy);
+    ClassDB::bind_method(D_METHOD("set_restart_policy", "val"), &WFCSolverSettingsNative::set_restart_policy);
+
+    ClassDB::bind_method(D_METHOD("get_restart_base"), &WFCSolverSettingsNative::get_restart_base);
+    ClassDB::bind_method(D_METHOD("set_restart_base", "val"), &WFCSolverSettingsNative::set_restart_base);
+
+    ClassDB::bind_method(D_METHOD("get_restart_growth"), &WFCSolverSettingsNative::get_restart_growth);
+    ClassDB::bind_method(D_METHOD("set_restart_growth", "val"), &WFCSolverSettingsNative::set_restart_growth);
+
+    ClassDB::bind_method(D_METHOD("get_max_restarts"), &WFCSolverSettingsNative::get_max_restarts);
+    ClassDB::bind_method(D_METHOD("set_max_restarts", "val"), &WFCSolverSettingsNative::set_max_restarts);
+
+    ClassDB::bind_method(D_METHOD("get_restart_phase_hints"), &WFCSolverSettingsNative::get_restart_phase_hints);
+    ClassDB::bind_method(D_METHOD("set_restart_phase_hints", "val"), &WFCSolverSettingsNative::set_restart_phase_hints);
+
+    ClassDB::bind_method(D_METHOD("get_backjumping"), &WFCSolverSettingsNative::get_backjumping);
+    ClassDB::bind_method(D_METHOD("set_backjumping", "val"), &WFCSolverSettingsNative::set_backjumping);
+
+    ClassDB::bind_method(D_METHOD("get_failure_recovery_radius"), &WFCSolverSettingsNative::get_failure_recovery_radius);
+    ClassDB::bind_method(D_METHOD("set_failure_recovery_radius", "val"), &WFCSolverSettingsNative::set_failure_recovery_radius);
+
+    ClassDB::bind_method(D_METHOD("get_failure_recovery_attempts"), &WFCSolverSettingsNative::get_failure_recovery_attempts);
+    ClassDB::bind_method(D_METHOD("set_failure_recovery_attempts", "val"), &WFCSolverSettingsNative::set_failure_recovery_attempts);
+
     // Properties
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_backtracking"), "set_allow_backtracking", "get_allow_backtracking");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "require_backtracking"), "set_require_backtracking", "get_require_backtracking");
@@ -32,6 +60,20 @@ void WFCSolverSettingsNative::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::INT, "sparse_history_start"), "set_sparse_history_start", "get_sparse_history_start");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "sparse_history_interval"), "set_sparse_history_interval", "get_sparse_history_interval");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "force_ac3"), "set_force_ac3", "get_force_ac3");
+
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "restart_policy", PROPERTY_HINT_ENUM, "None,Luby,Geometric,Failure Count"), "set_restart_policy", "get_restart_policy");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "restart_base"), "set_restart_base", "get_restart_base");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "restart_growth"), "set_restart_growth", "get_restart_growth");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_restarts"), "set_max_restarts", "get_max_restarts");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "restart_phase_hints"), "set_restart_phase_hints", "get_restart_phase_hints");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "backjumping"), "set_backjumping", "get_backjumping");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "failure_recovery_radius"), "set_failure_recovery_radius", "get_failure_recovery_radius");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "failure_recovery_attempts"), "set_failure_recovery_attempts", "get_failure_recovery_attempts");
+
+    BIND_CONSTANT(RESTART_NONE);
+    BIND_CONSTANT(RESTART_LUBY);
+    BIND_CONSTANT(RESTART_GEOMETRIC);
+    BIND_CONSTANT(RESTART_FAILURE_COUNT);
 }
 
 WFCSolverSettingsNative::WFCSolverSettingsNative() {
@@ -44,4 +86,35 @@ bool WFCSolverSettingsNative::is_sparse_history_enabled() const {
     return sparse_history_start_ > 0;
 }
 
+// Luby sequence, 1-based: 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+static int64_t luby(int64_t i) {
+    while (true) {
+        int k = 1;
+        while ((int64_t(1) << k) - 1 < i) {
+            k++;
+        }
+
+        if (i == (int64_t(1) << k) - 1) {
+            return int64_t(1) << (k - 1);
+        }
+
+        i -= (int64_t(1) << (k - 1)) - 1;
+    }
+}
+
+int64_t WFCSolverSettingsNative::get_restart_interval(int restart_index) const {
+    int64_t base = std::max(restart_base_, 1);
+
+    switch (restart_policy_) {
+        case RESTART_LUBY:
+            return base * luby(restart_index + 1);
+        case RESTART_GEOMETRIC:
+            return static_cast<int64_t>(std::min(base * std::pow(std::max(restart_growth_, 1.0), restart_index), 1e15));
+        case RESTART_FAILURE_COUNT:
+            return base;
+        default:
+            return -1;
+    }
+}
+
 } // namespace godot
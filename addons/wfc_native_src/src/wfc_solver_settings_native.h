@@ -8,6 +8,15 @@ namespace godot {
 class WFCSolverSettingsNative : public Resource {
     GDCLASS(WFCSolverSettingsNative, Resource)
 
+public:
+    // When the solver abandons the current search and restarts from the propagated root state
+    enum RestartPolicy {
+        RESTART_NONE = 0,
+        RESTART_LUBY = 1,           // restart_base * luby(n) conflicts: 1, 1, 2, 1, 1, 2, 4, ...
+        RESTART_GEOMETRIC = 2,      // restart_base * restart_growth^n conflicts
+        RESTART_FAILURE_COUNT = 3,  // every restart_base conflicts
+    };
+
 private:
     bool allow_backtracking_ = true;
     bool require_backtracking_ = false;
@@ -15,6 +24,14 @@ private:
     int sparse_history_start_ = 10;
     int sparse_history_interval_ = 10;
     bool force_ac3_ = true;
+    int restart_policy_ = RESTART_NONE;
+    int restart_base_ = 100;
+    double restart_growth_ = 1.5;
+    int max_restarts_ = -1;
+    bool restart_phase_hints_ = false;
+    bool backjumping_ = false;
+    int failure_recovery_radius_ = 0;
+    int failure_recovery_attempts_ = 3;
 
 protected:
     static void _bind_methods();
@@ -25,6 +42,9 @@ public:
 
     bool is_sparse_history_enabled() const;
 
+    // Number of conflicts allowed before the given (0-based) restart
+    int64_t get_restart_interval(int restart_index) const;
+
     // Property getters/setters
     bool get_allow_backtracking() const { return allow_backtracking_; }
     void set_allow_backtracking(bool val) { allow_backtracking_ = val; }
@@ -43,6 +63,37 @@ public:
 
     bool get_force_ac3() const { return force_ac3_; }
     void set_force_ac3(bool val) { force_ac3_ = val; }
+
+    int get_restart_policy() const { return restart_policy_; }
+    void set_restart_policy(int val) { restart_policy_ = val; }
+
+    int get_restart_base() const { return restart_base_; }
+    void set_restart_base(int val) { restart_base_ = val; }
+
+    double get_restart_growth() const { return restart_growth_; }
+    void set_restart_growth(double val) { restart_growth_ = val; }
+
+    // -1 = unlimited. Once reached, the solver keeps backtracking without restarts.
+    int get_max_restarts() const { return max_restarts_; }
+    void set_max_restarts(int val) { max_restarts_ = val; }
+
+    // Prefer tiles of the most complete state seen so far when diverging after a restart
+    bool get_restart_phase_hints() const { return restart_phase_hints_; }
+    void set_restart_phase_hints(bool val) { restart_phase_hints_ = val; }
+
+    // On contradiction, jump back to the latest decision the failed cell depends on
+    // instead of the latest decision overall
+    bool get_backjumping() const { return backjumping_; }
+    void set_backjumping(bool val) { backjumping_ = val; }
+
+    // Without backtracking: reset domains within this radius around a failed cell and solve
+    // the area again. 0 = failed cells are left as they are.
+    int get_failure_recovery_radius() const { return failure_recovery_radius_; }
+    void set_failure_recovery_radius(int val) { failure_recovery_radius_ = val; }
+
+    // Recoveries per area, the radius grows by one with each. Cells failing after that stay failed.
+    int get_failure_recovery_attempts() const { return failure_recovery_attempts_; }
+    void set_failure_recovery_attempts(int val) { failure_recovery_attempts_ = val; }
 };
 
 } // namespace godot
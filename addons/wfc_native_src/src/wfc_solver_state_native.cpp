@@ -15,6 +15,7 @@ void WFCSolverStateNative::_bind_methods() {
 
     ClassDB::bind_method(D_METHOD("get_cell_solution_or_entropy"), &WFCSolverStateNative::get_cell_solution_or_entropy);
     ClassDB::bind_method(D_METHOD("set_cell_solution_or_entropy", "val"), &WFCSolverStateNative::set_cell_solution_or_entropy);
+    ClassDB::bind_method(D_METHOD("get_cell_status_element_size"), &WFCSolverStateNative::get_cell_status_element_size);
 
     ClassDB::bind_method(D_METHOD("get_unsolved_cells"), &WFCSolverStateNative::get_unsolved_cells);
     ClassDB::bind_method(D_METHOD("set_unsolved_cells", "val"), &WFCSolverStateNative::set_unsolved_cells);
@@ -25,6 +26,9 @@ void WFCSolverStateNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_changed_cells"), &WFCSolverStateNative::get_changed_cells);
     ClassDB::bind_method(D_METHOD("set_changed_cells", "val"), &WFCSolverStateNative::set_changed_cells);
 
+    ClassDB::bind_method(D_METHOD("get_cell_reason_levels"), &WFCSolverStateNative::get_cell_reason_levels);
+    ClassDB::bind_method(D_METHOD("set_cell_reason_levels", "val"), &WFCSolverStateNative::set_cell_reason_levels);
+
     ClassDB::bind_method(D_METHOD("get_divergence_cell"), &WFCSolverStateNative::get_divergence_cell);
     ClassDB::bind_method(D_METHOD("set_divergence_cell", "val"), &WFCSolverStateNative::set_divergence_cell);
 
@@ -50,15 +54,19 @@ void WFCSolverStateNative::_bind_methods() {
     ClassDB::bind_method(D_METHOD("store_solution", "cell_id", "solution"), &WFCSolverStateNative::store_solution);
     ClassDB::bind_method(D_METHOD("set_solution", "cell_id", "solution"), &WFCSolverStateNative::set_solution);
     ClassDB::bind_method(D_METHOD("set_domain", "cell_id", "domain", "entropy"), &WFCSolverStateNative::set_domain, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("reset_cell_domain", "cell_id", "domain"), &WFCSolverStateNative::reset_cell_domain);
+    ClassDB::bind_method(D_METHOD("get_cell_reason_level", "cell_id"), &WFCSolverStateNative::get_cell_reason_level);
+    ClassDB::bind_method(D_METHOD("raise_cell_reason_level", "cell_id", "level"), &WFCSolverStateNative::raise_cell_reason_level);
     ClassDB::bind_method(D_METHOD("extract_changed_cells"), &WFCSolverStateNative::extract_changed_cells);
     ClassDB::bind_method(D_METHOD("backtrack", "problem"), &WFCSolverStateNative::backtrack);
     ClassDB::bind_method(D_METHOD("make_next"), &WFCSolverStateNative::make_next);
     ClassDB::bind_method(D_METHOD("make_snapshot"), &WFCSolverStateNative::make_snapshot);
+    ClassDB::bind_method(D_METHOD("make_copy"), &WFCSolverStateNative::make_copy);
     ClassDB::bind_method(D_METHOD("unlink_from_previous"), &WFCSolverStateNative::unlink_from_previous);
-    ClassDB::bind_method(D_METHOD("pick_divergence_cell"), &WFCSolverStateNative::pick_divergence_cell);
-    ClassDB::bind_method(D_METHOD("prepare_divergence"), &WFCSolverStateNative::prepare_divergence);
-    ClassDB::bind_method(D_METHOD("diverge", "problem"), &WFCSolverStateNative::diverge);
-    ClassDB::bind_method(D_METHOD("diverge_in_place", "problem"), &WFCSolverStateNative::diverge_in_place);
+    ClassDB::bind_method(D_METHOD("pick_divergence_cell", "problem"), &WFCSolverStateNative::pick_divergence_cell, DEFVAL(Variant()));
+    ClassDB::bind_method(D_METHOD("prepare_divergence", "problem"), &WFCSolverStateNative::prepare_divergence, DEFVAL(Variant()));
+    ClassDB::bind_method(D_METHOD("diverge", "problem", "hint"), &WFCSolverStateNative::diverge, DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("diverge_in_place", "problem", "hint"), &WFCSolverStateNative::diverge_in_place, DEFVAL(-1));
     ClassDB::bind_method(D_METHOD("get_ac4_counter_offset", "cell_id", "constraint_id", "tile_id"), &WFCSolverStateNative::get_ac4_counter_offset);
     ClassDB::bind_method(D_METHOD("decrement_ac4_counter", "cell_id", "constraint_id", "tile_id"), &WFCSolverStateNative::decrement_ac4_counter);
     ClassDB::bind_method(D_METHOD("ensure_ac4_state", "problem", "binary_constraints"), &WFCSolverStateNative::ensure_ac4_state);
@@ -70,6 +78,7 @@ void WFCSolverStateNative::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::INT, "unsolved_cells"), "set_unsolved_cells", "get_unsolved_cells");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "observations_count"), "set_observations_count", "get_observations_count");
     ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT64_ARRAY, "changed_cells"), "set_changed_cells", "get_changed_cells");
+    ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "cell_reason_levels"), "set_cell_reason_levels", "get_cell_reason_levels");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "divergence_cell"), "set_divergence_cell", "get_divergence_cell");
     ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "divergence_options"), "set_divergence_options", "get_divergence_options");
     ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "divergence_candidates"), "set_divergence_candidates", "get_divergence_candidates");
@@ -88,11 +97,11 @@ WFCSolverStateNative::~WFCSolverStateNative() {
 }
 
 bool WFCSolverStateNative::is_cell_solved(int cell_id) const {
-    return cell_solution_or_entropy_[cell_id] >= 0;
+    return cell_status_.get(cell_id) >= 0;
 }
 
 int64_t WFCSolverStateNative::get_cell_solution(int cell_id) const {
-    return cell_solution_or_entropy_[cell_id];
+    return cell_status_.get(cell_id);
 }
 
 bool WFCSolverStateNative::is_all_solved() const {
@@ -100,7 +109,7 @@ bool WFCSolverStateNative::is_all_solved() const {
 }
 
 void WFCSolverStateNative::store_solution(int cell_id, int64_t solution) {
-    cell_solution_or_entropy_[cell_id] = solution;
+    cell_status_.set(cell_id, solution);
     unsolved_cells_ -= 1;
     divergence_candidates_.erase(cell_id);
 }
@@ -139,7 +148,7 @@ bool WFCSolverStateNative::set_domain(int cell_id, const Ref<WFCBitSetNative>& d
             entropy = domain->count_set_bits() - 1;
         }
 
-        cell_solution_or_entropy_[cell_id] = -entropy;
+        cell_status_.set(cell_id, -entropy);
         divergence_candidates_[cell_id] = true;
     }
 
@@ -148,6 +157,47 @@ bool WFCSolverStateNative::set_domain(int cell_id, const Ref<WFCBitSetNative>& d
     return should_backtrack;
 }
 
+void WFCSolverStateNative::reset_cell_domain(int cell_id, const Ref<WFCBitSetNative>& domain) {
+    if (is_cell_solved(cell_id)) {
+        unsolved_cells_ += 1;
+    }
+
+    cell_domains_[cell_id] = domain;
+    changed_cells_.append(cell_id);
+
+    int only_bit = domain->get_only_set_bit();
+
+    if (only_bit == WFCBitSetNative::ONLY_BIT_MORE_BITS_SET) {
+        cell_status_.set(cell_id, -(domain->count_set_bits() - 1));
+        divergence_candidates_[cell_id] = true;
+    } else if (only_bit == WFCBitSetNative::ONLY_BIT_NO_BITS_SET) {
+        store_solution(cell_id, CELL_SOLUTION_FAILED);
+    } else {
+        store_solution(cell_id, only_bit);
+    }
+}
+
+int WFCSolverStateNative::get_cell_reason_level(int cell_id) const {
+    if (cell_id < 0 || cell_id >= cell_reason_levels_.size()) {
+        return 0;
+    }
+    return cell_reason_levels_[cell_id];
+}
+
+int WFCSolverStateNative::raise_cell_reason_level(int cell_id, int level) {
+    if (cell_reason_levels_.size() != cell_status_.size()) {
+        cell_reason_levels_.resize(cell_status_.size());
+        cell_reason_levels_.fill(0);
+    }
+
+    int32_t current = cell_reason_levels_[cell_id];
+    if (level > current) {
+        cell_reason_levels_.set(cell_id, level);
+        return level;
+    }
+    return current;
+}
+
 PackedInt64Array WFCSolverStateNative::extract_changed_cells() {
     PackedInt64Array res;
     res.resize(changed_cells_.size());
@@ -158,18 +208,27 @@ PackedInt64Array WFCSolverStateNative::extract_changed_cells() {
     return res;
 }
 
-Ref<WFCSolverStateNative> WFCSolverStateNative::backtrack(const Ref<WFCProblemNative>& problem) {
-    if (previous_.is_null()) {
-        return Ref<WFCSolverStateNative>();
+void WFCSolverStateNative::requeue_changed_cells(const PackedInt64Array& cells, int from) {
+    for (int i = from; i < cells.size(); i++) {
+        changed_cells_.append(cells[i]);
     }
+}
 
-    Ref<WFCSolverStateNative> state = previous_->diverge(problem);
+Ref<WFCSolverStateNative> WFCSolverStateNative::backtrack(const Ref<WFCProblemNative>& problem) {
+    // Iterative walk over the history, deep chains must not grow the native stack
+    Ref<WFCSolverStateNative> ancestor = previous_;
 
-    if (state.is_valid()) {
-        return state;
+    while (ancestor.is_valid()) {
+        Ref<WFCSolverStateNative> state = ancestor->diverge(problem);
+
+        if (state.is_valid()) {
+            return state;
+        }
+
+        ancestor = ancestor->previous_;
     }
 
-    return previous_->backtrack(problem);
+    return Ref<WFCSolverStateNative>();
 }
 
 Ref<WFCSolverStateNative> WFCSolverStateNative::make_next() {
@@ -184,16 +243,13 @@ Ref<WFCSolverStateNative> WFCSolverStateNative::make_next() {
     }
     new_state->cell_domains_ = domains_copy;
 
-    // Duplicate cell_solution_or_entropy
-    PackedInt64Array entropy_copy;
-    entropy_copy.resize(cell_solution_or_entropy_.size());
-    for (int i = 0; i < cell_solution_or_entropy_.size(); i++) {
-        entropy_copy[i] = cell_solution_or_entropy_[i];
-    }
-    new_state->cell_solution_or_entropy_ = entropy_copy;
+    new_state->cell_status_ = cell_status_;
 
     new_state->unsolved_cells_ = unsolved_cells_;
 
+    // Copy-on-write, only duplicated once a level is raised
+    new_state->cell_reason_levels_ = cell_reason_levels_;
+
     // Duplicate divergence_candidates
     new_state->divergence_candidates_ = divergence_candidates_.duplicate();
 
@@ -222,38 +278,50 @@ Ref<WFCSolverStateNative> WFCSolverStateNative::make_snapshot() const {
     }
     new_state->cell_domains_ = domains_copy;
 
-    // Duplicate cell_solution_or_entropy
-    PackedInt64Array entropy_copy;
-    entropy_copy.resize(cell_solution_or_entropy_.size());
-    for (int i = 0; i < cell_solution_or_entropy_.size(); i++) {
-        entropy_copy[i] = cell_solution_or_entropy_[i];
-    }
-    new_state->cell_solution_or_entropy_ = entropy_copy;
+    new_state->cell_status_ = cell_status_;
 
     new_state->unsolved_cells_ = unsolved_cells_;
 
     return new_state;
 }
 
+Ref<WFCSolverStateNative> WFCSolverStateNative::make_copy() const {
+    Ref<WFCSolverStateNative> new_state = make_snapshot();
+
+    new_state->observations_count_ = observations_count_;
+    new_state->changed_cells_ = changed_cells_;
+    new_state->cell_reason_levels_ = cell_reason_levels_;
+    new_state->divergence_cell_ = divergence_cell_;
+    new_state->divergence_options_ = divergence_options_.duplicate();
+    new_state->divergence_candidates_ = divergence_candidates_.duplicate();
+
+    // Packed arrays are copy-on-write, domains are replaced rather than modified
+    new_state->ac4_counters_ = ac4_counters_;
+    new_state->ac4_counter_index_coefficients_ = ac4_counter_index_coefficients_;
+    new_state->ac4_acknowledged_domains_ = ac4_acknowledged_domains_.duplicate();
+
+    return new_state;
+}
+
 void WFCSolverStateNative::unlink_from_previous() {
     previous_ = Ref<WFCSolverStateNative>();
 }
 
-int WFCSolverStateNative::pick_divergence_cell() {
+int WFCSolverStateNative::pick_divergence_cell(const Ref<WFCProblemNative>& problem) {
     TypedArray<int> options;
     int64_t target_entropy = MAX_INT_VAL;
 
     Array candidates = divergence_candidates_.keys();
 
     if (candidates.is_empty()) {
-        for (int i = 0; i < cell_solution_or_entropy_.size(); i++) {
+        for (int i = 0; i < cell_status_.size(); i++) {
             candidates.append(i);
         }
     }
 
     for (int i = 0; i < candidates.size(); i++) {
         int cell_id = candidates[i];
-        int64_t entropy = -cell_solution_or_entropy_[cell_id];
+        int64_t entropy = -cell_status_.get(cell_id);
 
         if (entropy <= 0) {
             continue;
@@ -268,13 +336,18 @@ int WFCSolverStateNative::pick_divergence_cell() {
         }
     }
 
+    if (!options.is_empty() && problem.is_valid() && problem->get_rng().is_valid()) {
+        Variant picked = options[problem->random_index(options.size())];
+        return static_cast<int>(static_cast<int64_t>(picked));
+    }
+
     // Use Array's pick_random() to match GDScript behavior exactly
     Variant picked = ((Array)options).pick_random();
     return static_cast<int>(static_cast<int64_t>(picked));
 }
 
-void WFCSolverStateNative::prepare_divergence() {
-    divergence_cell_ = pick_divergence_cell();
+void WFCSolverStateNative::prepare_divergence(const Ref<WFCProblemNative>& problem) {
+    divergence_cell_ = pick_divergence_cell(problem);
     divergence_candidates_.erase(divergence_cell_);
     divergence_options_.clear();
 
@@ -285,14 +358,26 @@ void WFCSolverStateNative::prepare_divergence() {
     }
 }
 
-Ref<WFCSolverStateNative> WFCSolverStateNative::diverge(const Ref<WFCProblemNative>& problem) {
+int WFCSolverStateNative::take_divergence_option(const Ref<WFCProblemNative>& problem, int64_t hint) {
+    if (hint >= 0) {
+        int index = divergence_options_.find(hint);
+        if (index >= 0) {
+            divergence_options_.remove_at(index);
+            return static_cast<int>(hint);
+        }
+    }
+
+    return problem->pick_divergence_option(divergence_options_);
+}
+
+Ref<WFCSolverStateNative> WFCSolverStateNative::diverge(const Ref<WFCProblemNative>& problem, int64_t hint) {
     if (divergence_options_.is_empty()) {
         return Ref<WFCSolverStateNative>();
     }
 
     Ref<WFCSolverStateNative> next_state = make_next();
 
-    int solution = problem->pick_divergence_option(divergence_options_);
+    int solution = take_divergence_option(problem, hint);
 
     next_state->set_solution(divergence_cell_, solution);
     next_state->observations_count_ += 1;
@@ -300,8 +385,8 @@ Ref<WFCSolverStateNative> WFCSolverStateNative::diverge(const Ref<WFCProblemNati
     return next_state;
 }
 
-void WFCSolverStateNative::diverge_in_place(const Ref<WFCProblemNative>& problem) {
-    int solution = problem->pick_divergence_option(divergence_options_);
+void WFCSolverStateNative::diverge_in_place(const Ref<WFCProblemNative>& problem, int64_t hint) {
+    int solution = take_divergence_option(problem, hint);
 
     set_solution(divergence_cell_, solution);
 
@@ -372,6 +457,11 @@ void WFCSolverStateNative::ensure_ac4_state(const Ref<WFCProblemNative>& problem
 
     changed_cells_.clear();
     for (int cell_id = 0; cell_id < cell_domains_.size(); cell_id++) {
+        // Failed cells do not constrain their neighbours, same as in AC3 propagation
+        if (cell_status_.get(cell_id) == CELL_SOLUTION_FAILED) {
+            continue;
+        }
+
         Ref<WFCBitSetNative> cell_domain = cell_domains_[cell_id];
         if (!default_domain->equals(cell_domain)) {
             for (int c = 0; c < binary_constraints.size(); c++) {
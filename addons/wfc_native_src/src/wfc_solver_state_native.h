@@ -8,6 +8,7 @@
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/vector3i.hpp>
 #include "wfc_bitset_native.h"
+#include "wfc_cell_status_native.h"
 
 namespace godot {
 
@@ -29,8 +30,8 @@ private:
     // Current domains of all cells
     TypedArray<WFCBitSetNative> cell_domains_;
 
-    // Solution or entropy for each cell
-    PackedInt64Array cell_solution_or_entropy_;
+    // Solution or entropy for each cell, compact; the int64 view is built on demand
+    WFCCellStatusArray cell_status_;
 
     // Number of unsolved cells
     int unsolved_cells_ = 0;
@@ -41,6 +42,10 @@ private:
     // Changed cells
     PackedInt64Array changed_cells_;
 
+    // Per cell, highest decision level (observations count) its domain depends on.
+    // Only maintained by solvers with backjumping; empty means all cells depend on no decision.
+    PackedInt32Array cell_reason_levels_;
+
     // Divergence state
     int divergence_cell_ = -1;
     TypedArray<int> divergence_options_;
@@ -53,6 +58,9 @@ private:
     Vector3i ac4_counter_index_coefficients_;
     TypedArray<WFCBitSetNative> ac4_acknowledged_domains_;
 
+    // Removes `hint` from divergence options when present, otherwise lets the problem pick
+    int take_divergence_option(const Ref<WFCProblemNative>& problem, int64_t hint);
+
 protected:
     static void _bind_methods();
 
@@ -67,8 +75,15 @@ public:
     TypedArray<WFCBitSetNative> get_cell_domains() const { return cell_domains_; }
     void set_cell_domains(const TypedArray<WFCBitSetNative>& val) { cell_domains_ = val; }
 
-    PackedInt64Array get_cell_solution_or_entropy() const { return cell_solution_or_entropy_; }
-    void set_cell_solution_or_entropy(const PackedInt64Array& val) { cell_solution_or_entropy_ = val; }
+    // Copies of the compact cell status, avoid calling per cell
+    PackedInt64Array get_cell_solution_or_entropy() const { return cell_status_.to_packed(); }
+    void set_cell_solution_or_entropy(const PackedInt64Array& val) { cell_status_.assign(val); }
+
+    // Sets every cell to the same solution or entropy
+    void fill_cell_solution_or_entropy(int cell_count, int64_t value) { cell_status_.fill(cell_count, value); }
+
+    // Bytes used per cell by the compact cell status
+    int get_cell_status_element_size() const { return cell_status_.get_element_size(); }
 
     int get_unsolved_cells() const { return unsolved_cells_; }
     void set_unsolved_cells(int val) { unsolved_cells_ = val; }
@@ -88,6 +103,9 @@ public:
     Dictionary get_divergence_candidates() const { return divergence_candidates_; }
     void set_divergence_candidates(const Dictionary& val) { divergence_candidates_ = val; }
 
+    PackedInt32Array get_cell_reason_levels() const { return cell_reason_levels_; }
+    void set_cell_reason_levels(const PackedInt32Array& val) { cell_reason_levels_ = val; }
+
     PackedInt32Array get_ac4_counters() const { return ac4_counters_; }
     void set_ac4_counters(const PackedInt32Array& val) { ac4_counters_ = val; }
 
@@ -106,17 +124,30 @@ public:
     void set_solution(int cell_id, int64_t solution);
     bool set_domain(int cell_id, const Ref<WFCBitSetNative>& domain, int entropy = -1);
 
+    // Replaces the domain of a cell, also when it was solved or failed, and queues it as changed
+    void reset_cell_domain(int cell_id, const Ref<WFCBitSetNative>& domain);
+
+    int get_cell_reason_level(int cell_id) const;
+    // Returns the resulting level
+    int raise_cell_reason_level(int cell_id, int level);
+
     PackedInt64Array extract_changed_cells();
+    // Re-queue cells from index `from` that were extracted but not processed (e.g. on cancellation)
+    void requeue_changed_cells(const PackedInt64Array& cells, int from = 0);
 
     Ref<WFCSolverStateNative> backtrack(const Ref<WFCProblemNative>& problem);
     Ref<WFCSolverStateNative> make_next();
     Ref<WFCSolverStateNative> make_snapshot() const;
+    // Independent copy including divergence and AC4 state, without history
+    Ref<WFCSolverStateNative> make_copy() const;
     void unlink_from_previous();
 
-    int pick_divergence_cell();
-    void prepare_divergence();
-    Ref<WFCSolverStateNative> diverge(const Ref<WFCProblemNative>& problem);
-    void diverge_in_place(const Ref<WFCProblemNative>& problem);
+    // Problem provides the random source; when null (or without own RNG) the global RNG is used
+    int pick_divergence_cell(const Ref<WFCProblemNative>& problem = Ref<WFCProblemNative>());
+    void prepare_divergence(const Ref<WFCProblemNative>& problem = Ref<WFCProblemNative>());
+    // A non-negative hint is tried first when it is one of the divergence options
+    Ref<WFCSolverStateNative> diverge(const Ref<WFCProblemNative>& problem, int64_t hint = -1);
+    void diverge_in_place(const Ref<WFCProblemNative>& problem, int64_t hint = -1);
 
     // AC4 methods
     int get_ac4_counter_offset(int cell_id, int constraint_id, int tile_id) const;
@@ -0,0 +1,374 @@
+#include "wfc_tile_store_native.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace godot {
+
+static const char TILE_STORE_MAGIC[4] = { 'W', 'F', 'C', 'T' };
+static const uint32_t TILE_STORE_VERSION = 1;
+
+void WFCTileStoreNative::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("create", "path", "rect", "tile_size"), &WFCTileStoreNative::create, DEFVAL(Vector2i(256, 256)));
+    ClassDB::bind_method(D_METHOD("open", "path", "writable"), &WFCTileStoreNative::open, DEFVAL(false));
+    ClassDB::bind_method(D_METHOD("close"), &WFCTileStoreNative::close);
+    ClassDB::bind_method(D_METHOD("flush"), &WFCTileStoreNative::flush);
+    ClassDB::bind_method(D_METHOD("is_open"), &WFCTileStoreNative::is_open);
+    ClassDB::bind_method(D_METHOD("write_region", "region", "solutions"), &WFCTileStoreNative::write_region);
+    ClassDB::bind_method(D_METHOD("write_problem_state", "problem", "state"), &WFCTileStoreNative::write_problem_state);
+    ClassDB::bind_method(D_METHOD("read_region", "region"), &WFCTileStoreNative::read_region);
+    ClassDB::bind_method(D_METHOD("is_tile_written", "tile_coord"), &WFCTileStoreNative::is_tile_written);
+    ClassDB::bind_method(D_METHOD("get_rect"), &WFCTileStoreNative::get_rect);
+    ClassDB::bind_method(D_METHOD("get_tile_size"), &WFCTileStoreNative::get_tile_size);
+    ClassDB::bind_method(D_METHOD("get_tile_count"), &WFCTileStoreNative::get_tile_count);
+
+    BIND_CONSTANT(MAX_SOLUTION);
+}
+
+WFCTileStoreNative::WFCTileStoreNative() {
+}
+
+WFCTileStoreNative::~WFCTileStoreNative() {
+    close();
+}
+
+bool WFCTileStoreNative::map_file(const String& path, uint64_t size, bool create) {
+    CharString native_path = ProjectSettings::get_singleton()->globalize_path(path).utf8();
+
+#ifdef _WIN32
+    DWORD access = writable_ ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+    HANDLE file = CreateFileA(native_path.get_data(), access, FILE_SHARE_READ, nullptr,
+                              create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    ERR_FAIL_COND_V_MSG(file == INVALID_HANDLE_VALUE, false, "Cannot open tile store file");
+
+    if (!create) {
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            ERR_FAIL_V_MSG(false, "Cannot read tile store file size");
+        }
+        size = static_cast<uint64_t>(file_size.QuadPart);
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY,
+                                        static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xffffffff), nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        ERR_FAIL_V_MSG(false, "Cannot map tile store file");
+    }
+
+    void* view = MapViewOfFile(mapping, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        ERR_FAIL_V_MSG(false, "Cannot map tile store file");
+    }
+
+    file_handle_ = file;
+    map_handle_ = mapping;
+    mapping_ = static_cast<uint8_t*>(view);
+#else
+    int flags = writable_ ? O_RDWR : O_RDONLY;
+    if (create) {
+        flags |= O_CREAT | O_TRUNC;
+    }
+
+    int fd = ::open(native_path.get_data(), flags, 0644);
+    ERR_FAIL_COND_V_MSG(fd < 0, false, "Cannot open tile store file");
+
+    if (create) {
+        // Sparse file, untouched tiles take no disk space
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            ERR_FAIL_V_MSG(false, "Cannot resize tile store file");
+        }
+    } else {
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            ERR_FAIL_V_MSG(false, "Cannot read tile store file size");
+        }
+        size = static_cast<uint64_t>(file_stat.st_size);
+    }
+
+    void* view = mmap(nullptr, size, writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        ERR_FAIL_V_MSG(false, "Cannot map tile store file");
+    }
+
+    fd_ = fd;
+    mapping_ = static_cast<uint8_t*>(view);
+#endif
+
+    mapping_size_ = size;
+    return true;
+}
+
+void WFCTileStoreNative::unmap_file() {
+    if (!mapping_) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping_);
+    CloseHandle(map_handle_);
+    CloseHandle(file_handle_);
+    map_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    munmap(mapping_, mapping_size_);
+    ::close(fd_);
+    fd_ = -1;
+#endif
+
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+}
+
+bool WFCTileStoreNative::create(const String& path, const Rect2i& rect, const Vector2i& tile_size) {
+    ERR_FAIL_COND_V(!rect.has_area() || tile_size.x <= 0 || tile_size.y <= 0, false);
+
+    close();
+
+    Vector2i tile_count = Vector2i(
+        (rect.size.x + tile_size.x - 1) / tile_size.x,
+        (rect.size.y + tile_size.y - 1) / tile_size.y);
+
+    uint64_t tiles = static_cast<uint64_t>(tile_count.x) * tile_count.y;
+    uint64_t data_offset = (sizeof(Header) + tiles + 7) & ~uint64_t(7);
+    uint64_t size = data_offset + tiles * tile_size.x * tile_size.y * sizeof(uint16_t);
+
+    writable_ = true;
+    if (!map_file(path, size, true)) {
+        return false;
+    }
+
+    Header* header = get_header();
+    memcpy(header->magic, TILE_STORE_MAGIC, sizeof(TILE_STORE_MAGIC));
+    header->version = TILE_STORE_VERSION;
+    header->rect_x = rect.position.x;
+    header->rect_y = rect.position.y;
+    header->rect_w = rect.size.x;
+    header->rect_h = rect.size.y;
+    header->tile_w = tile_size.x;
+    header->tile_h = tile_size.y;
+    header->tiles_x = tile_count.x;
+    header->tiles_y = tile_count.y;
+    header->data_offset = data_offset;
+
+    rect_ = rect;
+    tile_size_ = tile_size;
+    tile_count_ = tile_count;
+    return true;
+}
+
+bool WFCTileStoreNative::open(const String& path, bool writable) {
+    close();
+
+    writable_ = writable;
+    if (!map_file(path, 0, false)) {
+        return false;
+    }
+
+    Header* header = get_header();
+    bool valid = mapping_size_ >= sizeof(Header) &&
+                 memcmp(header->magic, TILE_STORE_MAGIC, sizeof(TILE_STORE_MAGIC)) == 0 &&
+                 header->version == TILE_STORE_VERSION;
+
+    // Every size below is used for addressing into the mapping, a corrupt header must not
+    // lead to a division by zero or an access past its end
+    if (valid) {
+        valid = header->rect_w > 0 && header->rect_h > 0 &&
+                header->tile_w > 0 && header->tile_w <= INT32_MAX && header->tile_h > 0 && header->tile_h <= INT32_MAX &&
+                static_cast<int64_t>(header->rect_x) + header->rect_w <= INT32_MAX &&
+                static_cast<int64_t>(header->rect_y) + header->rect_h <= INT32_MAX &&
+                header->tiles_x == (static_cast<uint64_t>(header->rect_w) + header->tile_w - 1) / header->tile_w &&
+                header->tiles_y == (static_cast<uint64_t>(header->rect_h) + header->tile_h - 1) / header->tile_h;
+    }
+
+    if (valid) {
+        // a * b, false on overflow
+        auto multiply = [](uint64_t a, uint64_t b, uint64_t& result) {
+            if (b != 0 && a > UINT64_MAX / b) {
+                return false;
+            }
+            result = a * b;
+            return true;
+        };
+
+        uint64_t tiles = 0;
+        uint64_t tile_cells = 0;
+        uint64_t cells = 0;
+        valid = multiply(header->tiles_x, header->tiles_y, tiles) &&
+                multiply(header->tile_w, header->tile_h, tile_cells) &&
+                multiply(tiles, tile_cells, cells) &&
+                cells <= (UINT64_MAX - header->data_offset) / sizeof(uint16_t) &&
+                header->data_offset >= sizeof(Header) + tiles &&
+                mapping_size_ >= header->data_offset + cells * sizeof(uint16_t);
+    }
+
+    if (!valid) {
+        unmap_file();
+        ERR_FAIL_V_MSG(false, "Not a tile store file or unsupported version");
+    }
+
+    rect_ = Rect2i(header->rect_x, header->rect_y, header->rect_w, header->rect_h);
+    tile_size_ = Vector2i(header->tile_w, header->tile_h);
+    tile_count_ = Vector2i(header->tiles_x, header->tiles_y);
+    return true;
+}
+
+void WFCTileStoreNative::close() {
+    flush();
+    unmap_file();
+    rect_ = Rect2i();
+    tile_size_ = Vector2i();
+    tile_count_ = Vector2i();
+}
+
+void WFCTileStoreNative::flush() {
+    if (!mapping_ || !writable_) {
+        return;
+    }
+
+#ifdef _WIN32
+    FlushViewOfFile(mapping_, 0);
+#else
+    msync(mapping_, mapping_size_, MS_SYNC);
+#endif
+}
+
+uint16_t* WFCTileStoreNative::get_cell(const Vector2i& pos) const {
+    Vector2i local = pos - rect_.position;
+    Vector2i tile = local / tile_size_;
+    Vector2i in_tile = local - tile * tile_size_;
+
+    uint64_t tile_index = static_cast<uint64_t>(tile.y) * tile_count_.x + tile.x;
+    uint64_t cell_index = tile_index * tile_size_.x * tile_size_.y + static_cast<uint64_t>(in_tile.y) * tile_size_.x + in_tile.x;
+
+    return reinterpret_cast<uint16_t*>(mapping_ + get_header()->data_offset) + cell_index;
+}
+
+void WFCTileStoreNative::write_region(const Rect2i& region, const PackedInt64Array& solutions) {
+    ERR_FAIL_COND_MSG(!mapping_ || !writable_, "Tile store is not open for writing");
+    ERR_FAIL_COND(solutions.size() < region.get_area());
+
+    Rect2i clipped = region.intersection(rect_);
+    if (!clipped.has_area()) {
+        return;
+    }
+
+    const int64_t* src = solutions.ptr();
+
+    // Checked before writing, a bad region is not written partly
+    for (int64_t i = 0; i < region.get_area(); i++) {
+        ERR_FAIL_COND_MSG(src[i] > MAX_SOLUTION && src[i] != WFCSolverStateNative::CELL_SOLUTION_FAILED,
+                          "Tile store cells hold solutions up to MAX_SOLUTION");
+    }
+
+    // Rows within one storage tile are contiguous in both layouts
+    for (int y = clipped.position.y; y < clipped.get_end().y; y++) {
+        const int64_t* src_row = src + (int64_t)(y - region.position.y) * region.size.x + (clipped.position.x - region.position.x);
+
+        int x = clipped.position.x;
+        while (x < clipped.get_end().x) {
+            int tile_end = rect_.position.x + ((x - rect_.position.x) / tile_size_.x + 1) * tile_size_.x;
+            int span_end = std::min(tile_end, clipped.get_end().x);
+
+            uint16_t* dst = get_cell(Vector2i(x, y));
+            for (int i = 0; i < span_end - x; i++) {
+                int64_t solution = src_row[x - clipped.position.x + i];
+                bool solved = solution >= 0 && solution <= MAX_SOLUTION;
+                dst[i] = solved ? static_cast<uint16_t>(solution + 1) : 0;
+            }
+
+            x = span_end;
+        }
+    }
+
+    Vector2i first_tile = (clipped.position - rect_.position) / tile_size_;
+    Vector2i last_tile = (clipped.get_end() - Vector2i(1, 1) - rect_.position) / tile_size_;
+
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    uint8_t* index = get_index();
+    for (int ty = first_tile.y; ty <= last_tile.y; ty++) {
+        for (int tx = first_tile.x; tx <= last_tile.x; tx++) {
+            index[static_cast<uint64_t>(ty) * tile_count_.x + tx] = 1;
+        }
+    }
+}
+
+void WFCTileStoreNative::write_problem_state(const Ref<WFC2DProblemNative>& problem, const Ref<WFCSolverStateNative>& state) {
+    ERR_FAIL_COND(problem.is_null() || state.is_null());
+
+    Rect2i problem_rect = problem->get_rect();
+    Rect2i renderable = problem->get_renderable_rect().intersection(problem_rect);
+    PackedInt64Array cells = problem->to_row_major(state->get_cell_solution_or_entropy());
+
+    if (renderable == problem_rect) {
+        write_region(problem_rect, cells);
+        return;
+    }
+
+    PackedInt64Array solutions;
+    solutions.resize(renderable.get_area());
+    int64_t* dst = solutions.ptrw();
+    for (int y = renderable.position.y; y < renderable.get_end().y; y++) {
+        const int64_t* row = cells.ptr() + (int64_t)(y - problem_rect.position.y) * problem_rect.size.x + (renderable.position.x - problem_rect.position.x);
+        memcpy(dst, row, renderable.size.x * sizeof(int64_t));
+        dst += renderable.size.x;
+    }
+
+    write_region(renderable, solutions);
+}
+
+PackedInt64Array WFCTileStoreNative::read_region(const Rect2i& region) const {
+    PackedInt64Array result;
+    ERR_FAIL_COND_V_MSG(!mapping_, result, "Tile store is not open");
+
+    result.resize(region.get_area());
+    result.fill(-1);
+
+    Rect2i clipped = region.intersection(rect_);
+    int64_t* dst = result.ptrw();
+
+    for (int y = clipped.position.y; y < clipped.get_end().y; y++) {
+        int64_t* dst_row = dst + (int64_t)(y - region.position.y) * region.size.x + (clipped.position.x - region.position.x);
+
+        int x = clipped.position.x;
+        while (x < clipped.get_end().x) {
+            int tile_end = rect_.position.x + ((x - rect_.position.x) / tile_size_.x + 1) * tile_size_.x;
+            int span_end = std::min(tile_end, clipped.get_end().x);
+
+            const uint16_t* src = get_cell(Vector2i(x, y));
+            for (int i = 0; i < span_end - x; i++) {
+                dst_row[x - clipped.position.x + i] = static_cast<int64_t>(src[i]) - 1;
+            }
+
+            x = span_end;
+        }
+    }
+
+    return result;
+}
+
+bool WFCTileStoreNative::is_tile_written(const Vector2i& tile_coord) const {
+    if (!mapping_ || tile_coord.x < 0 || tile_coord.y < 0 || tile_coord.x >= tile_count_.x || tile_coord.y >= tile_count_.y) {
+        return false;
+    }
+    return get_index()[static_cast<uint64_t>(tile_coord.y) * tile_count_.x + tile_coord.x] != 0;
+}
+
+} // namespace godot
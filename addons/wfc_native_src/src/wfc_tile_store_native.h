@@ -0,0 +1,104 @@
+#ifndef WFC_TILE_STORE_NATIVE_H
+#define WFC_TILE_STORE_NATIVE_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include "wfc_2d_problem_native.h"
+#include "wfc_solver_state_native.h"
+
+#include <cstdint>
+#include <mutex>
+
+namespace godot {
+
+// Memory-mapped file holding solved tiles of a 2D map, for maps too large for
+// PackedInt64Array and the GDScript mapper.
+//
+// Layout: fixed header, one "written" byte per storage tile (the chunk index), then
+// storage tiles of tile_size cells in row-major tile order. Cells are uint16 holding
+// solution + 1, so zero-filled (sparse) regions read back as unsolved. Writes to
+// different cells may happen concurrently, e.g. from runner workers.
+class WFCTileStoreNative : public RefCounted {
+    GDCLASS(WFCTileStoreNative, RefCounted)
+
+public:
+    static const int64_t MAX_SOLUTION = 0xFFFE;
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        int32_t rect_x;
+        int32_t rect_y;
+        int32_t rect_w;
+        int32_t rect_h;
+        uint32_t tile_w;
+        uint32_t tile_h;
+        uint32_t tiles_x;
+        uint32_t tiles_y;
+        uint64_t data_offset;
+    };
+
+    Rect2i rect_;
+    Vector2i tile_size_;
+    Vector2i tile_count_;
+    bool writable_ = false;
+
+    uint8_t* mapping_ = nullptr;
+    uint64_t mapping_size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* map_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+    // Guards the chunk index bytes, cell data of distinct cells needs no lock
+    std::mutex index_mutex_;
+
+    bool map_file(const String& path, uint64_t size, bool create);
+    void unmap_file();
+
+    Header* get_header() const { return reinterpret_cast<Header*>(mapping_); }
+    uint8_t* get_index() const { return mapping_ + sizeof(Header); }
+    uint16_t* get_cell(const Vector2i& pos) const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    WFCTileStoreNative();
+    ~WFCTileStoreNative();
+
+    // Creates (or truncates) the file at path for the given map rect, opened for writing
+    bool create(const String& path, const Rect2i& rect, const Vector2i& tile_size = Vector2i(256, 256));
+
+    // Opens an existing file
+    bool open(const String& path, bool writable = false);
+
+    void close();
+    void flush();
+    bool is_open() const { return mapping_ != nullptr; }
+
+    // Writes row-major solutions over region (absolute coordinates). Unsolved and failed
+    // cells are stored as empty. Parts outside the store rect are ignored. Nothing is
+    // written when a solution is above MAX_SOLUTION.
+    void write_region(const Rect2i& region, const PackedInt64Array& solutions);
+
+    // Writes the renderable rect of a solved (sub-)problem
+    void write_problem_state(const Ref<WFC2DProblemNative>& problem, const Ref<WFCSolverStateNative>& state);
+
+    // Reads row-major solutions over region, -1 for empty cells and cells outside the store
+    PackedInt64Array read_region(const Rect2i& region) const;
+
+    // Whether anything was written to the storage tile at tile_coord
+    bool is_tile_written(const Vector2i& tile_coord) const;
+
+    Rect2i get_rect() const { return rect_; }
+    Vector2i get_tile_size() const { return tile_size_; }
+    Vector2i get_tile_count() const { return tile_count_; }
+};
+
+} // namespace godot
+
+#endif // WFC_TILE_STORE_NATIVE_H
@@ -454,6 +454,7 @@ func _create_restrictive_native_problem(tile_count: int, grid_size: Vector2i):
 
 	var problem = WFC2DProblemNative.new()
 	problem.initialize(rules, rect)
+	problem.gdscript_parity = true
 	return problem
 
 
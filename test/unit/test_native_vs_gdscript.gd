@@ -109,6 +109,33 @@ func _create_native_problem(tile_count: int, grid_size: Vector2i):
 	return problem
 
 
+# Allows every pair of tiles on the first axis_count axes of initialized rules
+func _allow_all_rules(rules, tile_count: int, axis_count: int) -> void:
+	for a in range(axis_count):
+		for tile1 in range(tile_count):
+			for tile2 in range(tile_count):
+				rules.set_rule(a, tile1, tile2)
+
+
+# Neighbouring cells never share a tile. With three tiles, greedy choices run into
+# contradictions on close to half of the 20x20 maps.
+func _create_native_colouring_problem(tile_count: int, grid_size: Vector2i):
+	var axes: Array[Vector2i] = [Vector2i(0, 1), Vector2i(1, 0)]
+	var rect = Rect2i(Vector2i.ZERO, grid_size)
+
+	var rules = WFCRules2DNative.new()
+	rules.initialize(tile_count, axes)
+	for i in range(tile_count):
+		for j in range(tile_count):
+			if i != j:
+				rules.set_rule(0, i, j, true)
+				rules.set_rule(1, i, j, true)
+
+	var problem = WFC2DProblemNative.new()
+	problem.initialize(rules, rect)
+	return problem
+
+
 func _compare_solutions(gd_state: WFCSolverState, native_state) -> int:
 	var gd_solutions = gd_state.cell_solution_or_entropy
 	var native_solutions = native_state.get_cell_solution_or_entropy()
@@ -144,6 +171,7 @@ func test_deterministic_10x10():
 
 	var gd_problem = _create_gd_problem(tile_count, grid_size)
 	var native_problem = _create_native_problem(tile_count, grid_size)
+	native_problem.gdscript_parity = true
 
 	# Run GDScript solver
 	seed(test_seed)
@@ -177,6 +205,7 @@ func test_deterministic_20x20():
 
 	var gd_problem = _create_gd_problem(tile_count, grid_size)
 	var native_problem = _create_native_problem(tile_count, grid_size)
+	native_problem.gdscript_parity = true
 
 	seed(test_seed)
 	var gd_settings = WFCSolverSettings.new()
@@ -251,3 +280,1130 @@ func test_native_bitset_correctness():
 	assert_true(bs.get_bit(63))
 	assert_false(bs.get_bit(5))
 	assert_eq(bs.count_set_bits(), 3)
+
+
+func test_blit_precondition_solutions():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var tile_count = 4
+	var problem = _create_native_problem(tile_count, Vector2i(6, 6))
+
+	# Source is a 6x3 region overlapping the top two rows, solved with tile 2
+	var source_rect = Rect2i(Vector2i(0, -1), Vector2i(6, 3))
+	var source_solutions = PackedInt64Array()
+	source_solutions.resize(source_rect.get_area())
+	source_solutions.fill(2)
+
+	# Only the read rect is imported and rows outside the problem are dropped
+	problem.blit_precondition_solutions(source_rect, source_solutions, Rect2i(Vector2i(0, -1), Vector2i(6, 2)))
+
+	var native_settings = WFCSolverSettingsNative.new()
+	var native_solver = WFCSolverNative.new()
+	native_solver.initialize(problem, native_settings)
+	var solutions = native_solver.get_current_state().get_cell_solution_or_entropy()
+
+	for x in range(6):
+		assert_eq(solutions[x], 2, "Row 0 should be fixed by the blit")
+		assert_lt(solutions[6 + x], 0, "Row 1 should stay unsolved")
+
+
+func test_multithreaded_runner_completes_without_update():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var native_problem = _create_native_problem(4, Vector2i(64, 16))
+	var sub_problems = native_problem.split(2)
+
+	var runner = WFCMultithreadedRunnerNative.new()
+	watch_signals(runner)
+	runner.start(sub_problems, WFCSolverSettingsNative.new(), 2)
+
+	# Scheduling runs on worker threads, so update() is never called here
+	await wait_for_signal(runner.all_completed, 10)
+
+	assert_signal_emitted(runner, "all_completed")
+	assert_signal_emit_count(runner, "task_completed", runner.get_task_count())
+	assert_signal_not_emitted(runner, "task_failed")
+	assert_almost_eq(runner.get_progress(), 1.0, 0.001)
+
+
+func test_cancellation_token_stops_and_resumes_solver():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var native_problem = _create_native_problem(4, Vector2i(20, 20))
+	var token = WFCCancellationTokenNative.new()
+	var native_solver = WFCSolverNative.new()
+	native_solver.set_cancellation_token(token)
+	native_solver.initialize(native_problem, WFCSolverSettingsNative.new())
+
+	token.cancel()
+	var unsolved_before = native_solver.get_current_state().get_unsolved_cells()
+	assert_true(native_solver.solve_step(), "Cancelled solver should stop immediately")
+	assert_eq(native_solver.get_current_state().get_unsolved_cells(), unsolved_before)
+
+	# A reset token resumes the same search
+	token.reset()
+	var state = native_solver.solve()
+	assert_eq(state.get_unsolved_cells(), 0)
+
+
+func test_generation_scheduler_singleton():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	assert_true(Engine.has_singleton("WFCGenerationSchedulerNative"))
+	var scheduler = Engine.get_singleton("WFCGenerationSchedulerNative")
+	assert_eq(scheduler.max_workers, WFCGenerationSchedulerNative.get_default_max_workers())
+	assert_gt(scheduler.max_workers, 0)
+
+
+func test_generation_scheduler_abandons_jobs_on_shutdown():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var scheduler = Engine.get_singleton("WFCGenerationSchedulerNative")
+	var max_workers = scheduler.max_workers
+	scheduler.max_workers = 1
+
+	var abandoned = [0]
+	var mutex = Mutex.new()
+	var on_abandon = func():
+		mutex.lock()
+		abandoned[0] += 1
+		mutex.unlock()
+	var never_finish = func():
+		OS.delay_usec(100)
+		return false
+
+	# One job runs, the others wait in the queue
+	for i in range(3):
+		assert_true(scheduler.submit_callable(never_finish, on_abandon))
+
+	scheduler.shutdown()
+	assert_eq(abandoned[0], 3, "Running and queued jobs are abandoned")
+	assert_eq(scheduler.get_active_job_count(), 0)
+	assert_eq(scheduler.get_queued_job_count(), 0)
+
+	# Jobs submitted after shutdown start new workers
+	var ran = [false]
+	var finish = func():
+		ran[0] = true
+		return true
+	assert_true(scheduler.submit_callable(finish))
+	var start = Time.get_ticks_msec()
+	while not ran[0] and Time.get_ticks_msec() - start < 5000:
+		OS.delay_msec(1)
+	assert_true(ran[0])
+	assert_eq(abandoned[0], 3)
+	scheduler.max_workers = max_workers
+
+
+func test_generation_scheduler_preempts_at_slice_boundary():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# One worker: jobs only take turns at slice boundaries
+	var scheduler = Engine.get_singleton("WFCGenerationSchedulerNative")
+	var max_workers = scheduler.max_workers
+	scheduler.max_workers = 1
+
+	var order = []
+	var high_slices = [0]
+	var high = func():
+		order.append("high")
+		high_slices[0] += 1
+		return high_slices[0] == 3
+
+	var low_slices = [0]
+	var low = func():
+		order.append("low")
+		low_slices[0] += 1
+		if low_slices[0] == 2:
+			scheduler.submit_callable(high, Callable(), 10)
+		return low_slices[0] == 6
+
+	assert_true(scheduler.submit_callable(low))
+	var start = Time.get_ticks_msec()
+	while order.size() < 9 and Time.get_ticks_msec() - start < 5000:
+		OS.delay_msec(1)
+
+	# The higher priority job takes the worker from the next slice on and keeps it
+	assert_eq(order, ["low", "low", "high", "high", "high", "low", "low", "low", "low"])
+	scheduler.max_workers = max_workers
+
+
+func test_batch_solver_is_deterministic_per_seed():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var tile_count = 4
+	var rules = WFCRules2DNative.new()
+	rules.initialize(tile_count, [Vector2i(0, 1), Vector2i(1, 0)] as Array[Vector2i])
+	for i in range(tile_count):
+		rules.set_rule(0, i, i, true)
+		rules.set_rule(0, i, (i + 1) % tile_count, true)
+		rules.set_rule(1, i, i, true)
+		rules.set_rule(1, i, (i + 1) % tile_count, true)
+
+	var rects: Array[Rect2i] = []
+	var seeds = PackedInt64Array()
+	for i in range(32):
+		rects.append(Rect2i(Vector2i(i * 16, 0), Vector2i(16, 16)))
+		seeds.append(1000 + i)
+
+	var batch = WFCBatchSolverNative.new()
+	batch.initialize(rules)
+	var first = batch.solve_batch(rects, [], seeds)
+	var second = batch.solve_batch(rects, [], seeds)
+
+	assert_eq(first.size(), rects.size())
+	for i in range(rects.size()):
+		var solution = first[i]
+		assert_eq(solution.size(), 256, "Problem %d should be solved" % i)
+		assert_eq(solution, second[i], "Same seed should give same solution")
+
+		# Rows of 16 cells; the right and lower neighbour hold the same or the next tile
+		for cell in range(solution.size()):
+			var tile = solution[cell]
+			assert_true(tile >= 0 and tile != WFCSolverStateNative.CELL_SOLUTION_FAILED, "Cell %d of problem %d is solved" % [cell, i])
+			if cell % 16 < 15:
+				assert_true(solution[cell + 1] in [tile, (tile + 1) % tile_count])
+			if cell < 240:
+				assert_true(solution[cell + 16] in [tile, (tile + 1) % tile_count])
+
+
+func test_portfolio_solver_finds_solution():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(20, 20))
+
+	var portfolio_settings = WFCPortfolioSettingsNative.new()
+	portfolio_settings.racers = 3
+	portfolio_settings.base_seed = 42
+
+	var portfolio = WFCPortfolioSolverNative.new()
+	var state = portfolio.solve(problem, WFCSolverSettingsNative.new(), portfolio_settings)
+
+	assert_not_null(state)
+	assert_true(portfolio.is_solved())
+	assert_eq(portfolio.get_racer_count(), 3)
+	assert_eq(portfolio.get_racer_seed(portfolio.get_best_index()), 42 + portfolio.get_best_index())
+	assert_eq(state.get_unsolved_cells(), 0)
+
+
+func test_uniform_divergence_options_ignore_probabilities():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(4, 4))
+	problem.get_rules().set_probabilities(PackedFloat32Array([1.0, 0.0, 0.0, 0.0]))
+	problem.get_rules().set_probabilities_enabled(true)
+	problem.set_seed(7)
+
+	for i in range(20):
+		assert_eq(problem.pick_divergence_option([0, 1, 2, 3] as Array[int]), 0, "Weighted choice takes the only tile with weight")
+
+	problem.uniform_divergence_options = true
+	var picked = {}
+	for i in range(40):
+		picked[problem.pick_divergence_option([0, 1, 2, 3] as Array[int])] = true
+	assert_eq(picked.size(), 4, "Uniform choice takes every tile")
+
+
+func test_restart_intervals():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var settings = WFCSolverSettingsNative.new()
+	settings.restart_base = 2
+
+	settings.restart_policy = WFCSolverSettingsNative.RESTART_LUBY
+	var intervals = []
+	for i in range(7):
+		intervals.append(settings.get_restart_interval(i))
+	assert_eq(intervals, [2, 2, 4, 2, 2, 4, 8])
+
+	settings.restart_policy = WFCSolverSettingsNative.RESTART_GEOMETRIC
+	settings.restart_growth = 2.0
+	assert_eq(settings.get_restart_interval(3), 16)
+
+	settings.restart_policy = WFCSolverSettingsNative.RESTART_FAILURE_COUNT
+	assert_eq(settings.get_restart_interval(5), 2)
+
+
+func test_solver_with_restarts_solves_problem():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var settings = WFCSolverSettingsNative.new()
+	settings.require_backtracking = true
+	settings.restart_policy = WFCSolverSettingsNative.RESTART_LUBY
+	settings.restart_base = 1
+	settings.restart_phase_hints = true
+
+	# Close to half of the seeds run into a contradiction and restart
+	var restart_count = 0
+	for problem_seed in range(16):
+		var problem = _create_native_colouring_problem(3, Vector2i(20, 20))
+		problem.set_seed(problem_seed)
+
+		var solver = WFCSolverNative.new()
+		solver.initialize(problem, settings)
+		var state = solver.solve()
+
+		assert_not_null(state)
+		assert_eq(state.get_unsolved_cells(), 0)
+		assert_false(state.get_cell_solution_or_entropy().has(WFCSolverStateNative.CELL_SOLUTION_FAILED))
+		restart_count += solver.get_restart_count()
+
+	assert_gt(restart_count, 0, "Contradictions trigger restarts")
+
+
+func test_solver_with_backjumping_solves_problem():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	for force_ac3 in [true, false]:
+		var settings = WFCSolverSettingsNative.new()
+		settings.require_backtracking = true
+		settings.backjumping = true
+		settings.force_ac3 = force_ac3
+
+		var backjump_count = 0
+		for problem_seed in range(16):
+			var problem = _create_native_colouring_problem(3, Vector2i(20, 20))
+			problem.set_seed(problem_seed)
+
+			var solver = WFCSolverNative.new()
+			solver.initialize(problem, settings)
+			var state = solver.solve()
+
+			assert_not_null(state)
+			assert_eq(state.get_unsolved_cells(), 0)
+			assert_false(state.get_cell_solution_or_entropy().has(WFCSolverStateNative.CELL_SOLUTION_FAILED))
+			backjump_count += solver.get_backjump_count()
+
+		assert_gt(backjump_count, 0, "Contradictions skip unrelated decisions (force_ac3=%s)" % force_ac3)
+
+
+func test_failure_recovery_without_backtracking():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(20, 20))
+	assert_eq(problem.get_cells_in_radius(0, 1).size(), 4, "Corner area is clipped")
+	assert_eq(problem.get_cells_in_radius(problem.coord_to_id(Vector2i(5, 5)), 2).size(), 25)
+
+	var settings = WFCSolverSettingsNative.new()
+	settings.allow_backtracking = false
+	settings.failure_recovery_radius = 2
+	settings.failure_recovery_attempts = 8
+
+	# Cells fail on a good third of the seeds, recovery repairs them locally
+	var recovery_count = 0
+	for problem_seed in range(16):
+		var colouring = _create_native_colouring_problem(3, Vector2i(20, 20))
+		colouring.set_seed(problem_seed)
+
+		var solver = WFCSolverNative.new()
+		solver.initialize(colouring, settings)
+		var state = solver.solve()
+
+		assert_eq(state.get_unsolved_cells(), 0)
+		assert_false(state.get_cell_solution_or_entropy().has(WFCSolverStateNative.CELL_SOLUTION_FAILED))
+		recovery_count += solver.get_recovery_count()
+
+	assert_gt(recovery_count, 0, "Failed cells are recovered")
+
+
+func test_block_solver_solves_large_map():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var tile_count = 4
+	var rules = WFCRules2DNative.new()
+	rules.initialize(tile_count, [Vector2i(0, 1), Vector2i(1, 0)] as Array[Vector2i])
+	for i in range(tile_count):
+		rules.set_rule(0, i, i, true)
+		rules.set_rule(0, i, (i + 1) % tile_count, true)
+		rules.set_rule(1, i, i, true)
+		rules.set_rule(1, i, (i + 1) % tile_count, true)
+
+	var block_solver = WFCBlockSolverNative.new()
+	block_solver.initialize(rules)
+	block_solver.block_size = Vector2i(24, 24)
+	block_solver.seed = 5
+
+	var rect = Rect2i(Vector2i(-10, 0), Vector2i(80, 70))
+	var first = block_solver.solve(rect)
+	var second = block_solver.solve(rect)
+
+	assert_eq(first.size(), rect.get_area())
+	assert_eq(block_solver.get_discarded_block_count(), 0)
+	for solution in first:
+		assert_true(solution >= 0 and solution < tile_count)
+	assert_eq(first, second, "Same seed should give same map")
+
+
+func test_resolve_region_keeps_cells_outside():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(20, 20))
+	problem.set_seed(9)
+
+	var solver = WFCSolverNative.new()
+	solver.initialize(problem, WFCSolverSettingsNative.new())
+	var solution = solver.solve().get_cell_solution_or_entropy()
+
+	var edited_cell = problem.coord_to_id(Vector2i(10, 10))
+	var new_tile = (solution[edited_cell] + 2) % 4
+	var dirty = problem.get_cells_in_rect(Rect2i(Vector2i(9, 9), Vector2i(3, 3)))
+
+	var state = solver.resolve_region(solution, dirty, {edited_cell: new_tile})
+	assert_not_null(state)
+
+	var resolved = state.get_cell_solution_or_entropy()
+	assert_eq(state.get_unsolved_cells(), 0)
+	assert_eq(resolved[edited_cell], new_tile)
+	for id in problem.get_cells_in_rect(Rect2i(Vector2i(0, 0), Vector2i(20, 5))):
+		assert_eq(resolved[id], solution[id], "Cells far from the edit stay unchanged")
+
+
+func test_chunked_world_generates_and_spills_chunks():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(1, 1))
+
+	var world = WFC2DChunkedWorldNative.new()
+	world.initialize(problem.rules)
+	world.chunk_size = Vector2i(16, 16)
+	world.cache_capacity = 4
+	world.spill_directory = "user://test_chunked_world"
+
+	var first = world.generate_chunk(Vector2i(0, 0))
+	assert_eq(first.size(), 256)
+
+	world.request_chunks_around(Vector2i(0, 0), 1)
+	world.wait()
+
+	assert_eq(world.get_pending_count(), 0)
+	assert_eq(world.get_cached_chunk_count(), 4, "Cache is bounded")
+	for y in range(-1, 2):
+		for x in range(-1, 2):
+			assert_true(world.has_chunk(Vector2i(x, y)))
+
+	assert_eq(world.get_chunk(Vector2i(0, 0)), first, "Spilled chunk is read back unchanged")
+	world.clear()
+
+
+func test_tile_store_writes_and_reads_regions():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var store = WFCTileStoreNative.new()
+	assert_true(store.create("user://test_tile_store.wfct", Rect2i(-10, -10, 100, 70), Vector2i(16, 16)))
+	assert_eq(store.get_tile_count(), Vector2i(7, 5))
+
+	var region = Rect2i(5, 3, 30, 20)
+	var solutions = PackedInt64Array()
+	for i in range(region.get_area()):
+		solutions.append(i % 7)
+	solutions[0] = -1
+	store.write_region(region, solutions)
+	store.close()
+
+	assert_true(store.open("user://test_tile_store.wfct"))
+	assert_eq(store.read_region(region), solutions)
+	assert_true(store.is_tile_written(Vector2i(1, 0)))
+	assert_false(store.is_tile_written(Vector2i(6, 4)))
+
+	var outside = store.read_region(Rect2i(-20, -20, 4, 4))
+	for value in outside:
+		assert_eq(value, -1, "Cells outside the store read back as empty")
+	store.close()
+
+	# Header fields used for addressing are validated: tile_w at byte 24, tiles_x at byte 32
+	for corruption in [[24, 0], [32, 1000]]:
+		var file = FileAccess.open("user://test_tile_store.wfct", FileAccess.READ_WRITE)
+		file.seek(corruption[0])
+		var original = file.get_32()
+		file.seek(corruption[0])
+		file.store_32(corruption[1])
+		file.close()
+
+		assert_false(store.open("user://test_tile_store.wfct"))
+		assert_engine_error("Not a tile store file")
+
+		file = FileAccess.open("user://test_tile_store.wfct", FileAccess.READ_WRITE)
+		file.seek(corruption[0])
+		file.store_32(original)
+		file.close()
+	assert_true(store.open("user://test_tile_store.wfct"))
+	store.close()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path("user://test_tile_store.wfct"))
+
+
+func test_state_cell_status_is_compact():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var problem = _create_native_problem(4, Vector2i(8, 8))
+	var solver = WFCSolverNative.new()
+	solver.initialize(problem, WFCSolverSettingsNative.new())
+	var state = solver.solve()
+
+	assert_eq(state.get_cell_status_element_size(), 2)
+	var cells = state.get_cell_solution_or_entropy()
+	assert_eq(cells.size(), 64)
+	for cell in cells:
+		assert_between(cell, 0, 3)
+
+	# Values beyond int16 widen the storage without losing the failed marker
+	var values = PackedInt64Array([5, -3, 40000, WFCSolverStateNative.CELL_SOLUTION_FAILED])
+	state.set_cell_solution_or_entropy(values)
+	assert_eq(state.get_cell_status_element_size(), 4)
+	assert_eq(state.get_cell_solution_or_entropy(), values)
+
+
+func test_cell_layouts_map_ids_and_propagate():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var tile_count = 3
+	var rules = WFCRules2DNative.new()
+	rules.initialize(tile_count, [Vector2i(0, 1), Vector2i(1, 0)] as Array[Vector2i])
+	for i in range(tile_count):
+		rules.set_rule(0, i, i, true)
+		rules.set_rule(1, i, i, true)
+
+	var size = Vector2i(21, 13)
+	for layout in [WFC2DProblemNative.CELL_LAYOUT_ROW_MAJOR, WFC2DProblemNative.CELL_LAYOUT_TILED]:
+		var problem = WFC2DProblemNative.new()
+		problem.initialize(rules, Rect2i(Vector2i(5, -3), size))
+		problem.cell_layout = layout
+
+		var seen = {}
+		for y in range(size.y):
+			for x in range(size.x):
+				var id = problem.coord_to_id(Vector2i(x, y))
+				assert_between(id, 0, size.x * size.y - 1)
+				assert_eq(problem.id_to_coord(id), Vector2i(x, y))
+				seen[id] = true
+		assert_eq(seen.size(), size.x * size.y, "Ids are unique")
+
+		var row_major = PackedInt64Array(range(size.x * size.y))
+		assert_eq(problem.to_row_major(problem.from_row_major(row_major)), row_major)
+
+		# Equal-neighbour rules: one fixed cell decides the whole map
+		problem.set_precondition_solution(problem.coord_to_id(Vector2i(20, 12)), 2)
+		var solver = WFCSolverNative.new()
+		solver.initialize(problem, WFCSolverSettingsNative.new())
+		var state = solver.solve()
+
+		assert_eq(state.get_unsolved_cells(), 0)
+		for solution in problem.to_row_major(state.get_cell_solution_or_entropy()):
+			assert_eq(solution, 2)
+
+
+func test_native_edge_domain_constrains_border_cells():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# Tile 2 must not touch tile 0, the edge behaves as tile 0
+	var rules = WFCRules2DNative.new()
+	rules.initialize(3, [Vector2i(0, 1), Vector2i(1, 0)] as Array[Vector2i])
+	for axis in range(2):
+		for i in range(3):
+			for j in range(3):
+				if abs(i - j) <= 1:
+					rules.set_rule(axis, i, j, true)
+
+	var edge_domain = WFCBitSetNative.new()
+	edge_domain.initialize(3, false)
+	edge_domain.set_bit(0, true)
+	rules.edge_domain = edge_domain
+
+	var size = Vector2i(12, 9)
+	for parity in [true, false]:
+		var problem = WFC2DProblemNative.new()
+		problem.initialize(rules, Rect2i(Vector2i(3, 4), size))
+		problem.gdscript_parity = parity
+		problem.set_seed(11)
+
+		var solver = WFCSolverNative.new()
+		solver.initialize(problem, WFCSolverSettingsNative.new())
+		var cells = solver.solve().get_cell_solution_or_entropy()
+
+		for y in range(size.y):
+			for x in range(size.x):
+				if x == 0 or y == 0 or x == size.x - 1 or y == size.y - 1:
+					assert_ne(cells[problem.coord_to_id(Vector2i(x, y))], 2, "Border cell next to the edge")
+
+	# Existing tiles just right of the rect are preconditions, as in GDScript no edge
+	# conditions are applied next to them
+	var rect = Rect2i(Vector2i(3, 4), size)
+	var tiles = PackedInt32Array()
+	tiles.resize(size.y)
+	tiles.fill(2)
+	var existing = WFC2DPreconditionReadExistingNative.new()
+	existing.tile_count = 3
+	existing.set_cells(Rect2i(Vector2i(rect.end.x, rect.position.y), Vector2i(1, size.y)), tiles)
+
+	var bordered = WFC2DProblemNative.new()
+	bordered.initialize(rules, rect)
+	existing.evaluate(bordered.get_precondition_border_rect()).apply_to(bordered)
+	assert_eq(bordered.get_precondition_border_mask().count(1), size.y)
+
+	var bordered_solver = WFCSolverNative.new()
+	bordered_solver.initialize(bordered, WFCSolverSettingsNative.new())
+	var domains = bordered_solver.get_current_state().get_cell_domains()
+	assert_true(domains[bordered.coord_to_id(Vector2i(size.x - 1, 0))].get_bit(2), "Next to an existing tile")
+	assert_false(domains[bordered.coord_to_id(Vector2i(0, size.y - 1))].get_bit(2), "Next to the edge")
+
+
+func test_bulk_preconditions_match_per_cell_preconditions():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var size = Vector2i(10, 8)
+	var bulk = _create_native_problem(4, size)
+	var per_cell = _create_native_problem(4, size)
+
+	# Palette: class 0 = {1, 2}, class 1 = {3}
+	var palette = PackedInt64Array([0b0110, 0b1000])
+	var classes = PackedInt32Array()
+	var solutions = PackedInt32Array()
+	for y in range(size.y):
+		for x in range(size.x):
+			var domain_class = -1 if x < 3 else (x + y) % 2
+			var solution = 0 if x == 0 else -1
+			classes.append(domain_class)
+			solutions.append(solution)
+
+			var cell_id = per_cell.coord_to_id(Vector2i(x, y))
+			if solution >= 0:
+				per_cell.set_precondition_solution(cell_id, solution)
+			if domain_class >= 0:
+				var domain = WFCBitSetNative.new()
+				domain.initialize(4, false)
+				domain.set_elem(0, palette[domain_class])
+				per_cell.set_precondition_domain(cell_id, domain)
+
+	bulk.set_precondition_solutions(solutions)
+	bulk.set_precondition_domains(palette, classes, 2)
+
+	bulk.set_seed(3)
+	per_cell.set_seed(3)
+	var bulk_solver = WFCSolverNative.new()
+	bulk_solver.initialize(bulk, WFCSolverSettingsNative.new())
+	var per_cell_solver = WFCSolverNative.new()
+	per_cell_solver.initialize(per_cell, WFCSolverSettingsNative.new())
+
+	var bulk_cells = bulk_solver.solve().get_cell_solution_or_entropy()
+	assert_eq(bulk_cells, per_cell_solver.solve().get_cell_solution_or_entropy())
+	assert_eq(bulk_cells[bulk.coord_to_id(Vector2i(0, 5))], 0)
+	assert_eq(bulk_cells[bulk.coord_to_id(Vector2i(4, 1))], 3)
+
+
+func test_native_precondition_compose_intersects_parts():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var rect = Rect2i(0, 0, 4, 2)
+	var cells = PackedInt32Array([0, 1, -1, 2, 2, -1, 1, 0])
+
+	var read_existing = WFC2DPreconditionReadExistingNative.new()
+	read_existing.tile_count = 3
+	read_existing.set_cells(rect, cells)
+
+	# Every tile may become itself or tile 2, empty cells any tile
+	var remap = WFC2DPreconditionRemapNative.new()
+	remap.tile_count = 3
+	remap.set_cells(rect, cells)
+	var domains = []
+	for tile in range(3):
+		var domain = WFCBitSetNative.new()
+		domain.initialize(3, false)
+		domain.set_bit(tile, true)
+		domain.set_bit(2, true)
+		domains.append(domain)
+	remap.domains_map = domains
+	var any_tile = WFCBitSetNative.new()
+	any_tile.initialize(3, true)
+	remap.default_domain = any_tile
+
+	var compose = WFC2DPreconditionComposeNative.new()
+	compose.preconditions = [remap, read_existing]
+	var map = compose.evaluate(rect)
+
+	assert_eq(map.get_domain(Vector2i(1, 0)).to_array(), PackedInt64Array([1]))
+	assert_eq(map.get_domain(Vector2i(2, 0)).to_array(), PackedInt64Array([0, 1, 2]))
+	assert_null(map.get_domain(Vector2i(5, 0)))
+
+	# Equal cells share a palette class
+	var classes = map.get_domain_classes()
+	assert_eq(classes[0], classes[7])
+	assert_eq(classes[2], classes[5])
+	# 4 remap classes, then one intersection per distinct tile
+	assert_eq(map.get_palette().size(), 7)
+
+
+func test_native_dungeon_matches_gdscript_layout():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var rect = Rect2i(-4, 2, 48, 40)
+
+	var gd_dungeon = WFC2DPreconditionDungeon.new()
+	gd_dungeon.rect = rect
+	gd_dungeon.layout_seed = 7
+	gd_dungeon.use_native = false
+	gd_dungeon.prepare()
+
+	var native_dungeon = WFC2DPreconditionDungeonNative.new()
+	native_dungeon.seed = 7
+	var layout = native_dungeon.generate(rect)
+
+	assert_eq(layout, gd_dungeon.state)
+	assert_true(layout.has(WFC2DPreconditionDungeonNative.STATE_PASSAGE))
+	assert_eq(native_dungeon.generate(rect), layout, "Same seed gives the same layout")
+
+	# Walls and passages become palette classes 0 and 1
+	var walls = WFCBitSetNative.new()
+	walls.initialize(4, false)
+	walls.set_bit(0, true)
+	var passable = WFCBitSetNative.new()
+	passable.initialize(4, false)
+	passable.set_bit(1, true)
+	native_dungeon.walls_domain = walls
+	native_dungeon.passable_domain = passable
+
+	var classes = native_dungeon.evaluate(rect).get_domain_classes()
+	for i in range(layout.size()):
+		match layout[i]:
+			WFC2DPreconditionDungeonNative.STATE_WALL:
+				assert_eq(classes[i], 0)
+			WFC2DPreconditionDungeonNative.STATE_PASSAGE:
+				assert_eq(classes[i], 1)
+			_:
+				assert_eq(classes[i], -1)
+
+
+func test_native_learn_from_grid_matches_gdscript_rules():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var size = Vector2i(4, 3)
+	var tiles = PackedInt32Array([
+		0, 1, 2, -1,
+		1, 1, 0, 2,
+		2, -1, 0, 1,
+	])
+	var axes: Array[Vector2i] = [Vector2i(0, 1), Vector2i(1, 0)]
+
+	var native_rules = WFCRules2DNative.new()
+	native_rules.initialize(3, axes)
+	native_rules.learn_from_grid(tiles, size)
+
+	# Same pairs as WFCRules2D._learn_from: set_bit(cell, other_cell) for each axis
+	var gd_matrices = []
+	for a in range(axes.size()):
+		gd_matrices.append(WFCBitMatrix.new(3, 3))
+	for y in range(size.y):
+		for x in range(size.x):
+			var cell = tiles[y * size.x + x]
+			if cell < 0:
+				continue
+			for a in range(axes.size()):
+				var other = Vector2i(x, y) + axes[a]
+				if other.x >= size.x or other.y >= size.y:
+					continue
+				var other_cell = tiles[other.y * size.x + other.x]
+				if other_cell >= 0:
+					gd_matrices[a].set_bit(cell, other_cell)
+
+	for a in range(axes.size()):
+		for tile1 in range(3):
+			for tile2 in range(3):
+				assert_eq(native_rules.get_rule(a, tile1, tile2), gd_matrices[a].rows[tile2].get_bit(tile1))
+
+	assert_eq(native_rules.get_tile_frequencies(), PackedInt64Array([3, 4, 3]))
+	assert_eq(native_rules.duplicate().get_tile_frequencies(), PackedInt64Array([3, 4, 3]), "Frequencies are stored")
+
+	# Negative sample removes a learned pair
+	native_rules.learn_from_grid(PackedInt32Array([0, 1]), Vector2i(2, 1), false)
+	assert_false(native_rules.get_rule(1, 0, 1))
+
+	# Whole matrices round-trip through words
+	var copy = WFCRules2DNative.new()
+	copy.initialize(3, axes)
+	for a in range(axes.size()):
+		copy.set_axis_matrix_words(a, native_rules.get_axis_matrix_words(a))
+		assert_eq(copy.get_axis_matrix_words(a), native_rules.get_axis_matrix_words(a))
+
+
+func test_native_rules_binary_round_trip():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	var axes: Array[Vector2i] = [Vector2i(0, 1), Vector2i(1, 0)]
+	var rules = WFCRules2DNative.new()
+	rules.initialize(70, axes)
+	for tile in range(70):
+		rules.set_rule(0, tile, (tile + 1) % 70)
+		rules.set_rule(1, tile, (tile * 7) % 70)
+	var probabilities = PackedFloat32Array()
+	for tile in range(70):
+		probabilities.append(1.0 + tile)
+	rules.probabilities_enabled = true
+	rules.probabilities = probabilities
+	var edge_domain = WFCBitSetNative.new()
+	edge_domain.initialize(70, false)
+	edge_domain.set_bit(65, true)
+	rules.edge_domain = edge_domain
+
+	var bytes = rules.to_binary()
+	var loaded = WFCRules2DNative.new()
+	assert_true(loaded.from_binary(bytes))
+
+	for a in range(axes.size()):
+		assert_eq(loaded.get_axis_matrix_words(a), rules.get_axis_matrix_words(a))
+		assert_eq(loaded.get_transposed_matrix(a).get_words(), rules.get_transposed_matrix(a).get_words())
+		assert_eq(loaded.get_supports(loaded.get_axis_matrices()[a]), rules.get_supports(rules.get_axis_matrices()[a]))
+	assert_eq(loaded.get_influence_range(), rules.get_influence_range())
+	assert_eq(loaded.probabilities, probabilities)
+	assert_eq(loaded.edge_domain.to_array(), PackedInt64Array([65]))
+
+	# Any changed payload byte fails the content hash
+	var corrupt = bytes.duplicate()
+	corrupt[corrupt.size() - 1] ^= 1
+	assert_false(WFCRules2DNative.new().from_binary(corrupt))
+
+	# Files with unchanged content are loaded once
+	var path = "user://test_rules_binary.wfcr"
+	assert_true(rules.save_binary(path))
+	var first = WFCRules2DNative.load_binary(path)
+	assert_not_null(first)
+	assert_same(WFCRules2DNative.load_binary(path), first)
+	WFCRules2DNative.clear_binary_cache()
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
+
+func test_native_rules_compilation_merges_and_prunes_tiles():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# Tiles 0 and 1 are interchangeable, tile 2 can't be next to itself,
+	# tile 3 has no neighbour along the second axis
+	var axes: Array[Vector2i] = [Vector2i(0, 1), Vector2i(1, 0)]
+	var rules = WFCRules2DNative.new()
+	rules.initialize(4, axes)
+	for a in range(axes.size()):
+		for tile1 in range(3):
+			for tile2 in range(3):
+				if tile1 != 2 or tile2 != 2:
+					rules.set_rule(a, tile1, tile2)
+	rules.set_rule(0, 3, 0)
+	rules.set_rule(0, 0, 3)
+	rules.probabilities_enabled = true
+	rules.probabilities = PackedFloat32Array([1.0, 3.0, 2.0, 1.0])
+
+	var compilation = WFCRulesCompilation2DNative.new()
+	assert_true(compilation.compile(rules))
+	assert_eq(compilation.get_tile_classes(), PackedInt32Array([0, 0, 1, -1]))
+	assert_eq(compilation.get_class_count(), 2)
+	assert_eq(compilation.get_pruned_tile_count(), 1)
+
+	var compiled = compilation.get_rules()
+	assert_eq(compiled.get_tile_count(), 2)
+	assert_true(compiled.get_rule(0, 0, 1))
+	assert_false(compiled.get_rule(0, 1, 1))
+	assert_eq(compiled.probabilities, PackedFloat32Array([4.0, 2.0]))
+
+	var domain = WFCBitSetNative.new()
+	domain.initialize(4, false)
+	domain.set_bit(1, true)
+	domain.set_bit(3, true)
+	assert_eq(compilation.reduce_domain(domain).to_array(), PackedInt64Array([0]))
+
+	# Expansion draws class members, restricted to the cell's tile domain when given
+	var expanded = compilation.expand_solutions(PackedInt64Array([0, 1, 0, -1]), 5,
+		PackedInt64Array([0b0010]), PackedInt32Array([0, -1, -1, -1]))
+	assert_eq(expanded[0], 1)
+	assert_eq(expanded[1], 2)
+	assert_true(expanded[2] == 0 or expanded[2] == 1)
+	assert_eq(expanded[3], -1)
+
+	# Tiles fixed on the target map survive pruning
+	var keeping = WFCRulesCompilation2DNative.new()
+	assert_true(keeping.compile(rules, true, PackedInt32Array([3])))
+	assert_eq(keeping.get_pruned_tile_count(), 0)
+	assert_eq(keeping.reduce_solutions(PackedInt32Array([3, -1])), PackedInt32Array([keeping.get_tile_classes()[3], -1]))
+	assert_ne(keeping.get_tile_classes()[3], -1)
+
+
+func test_native_3d_problem_solves_learned_rules():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# Sample of alternating 0/1 layers, any tile next to itself within a layer
+	var sample_size = Vector3i(2, 2, 4)
+	var sample = PackedInt32Array()
+	for z in range(sample_size.z):
+		for i in range(sample_size.x * sample_size.y):
+			sample.append(z % 2)
+
+	var rules = WFCRules3DNative.new()
+	rules.initialize_3d(2, rules.axes_3d)
+	rules.learn_from_grid_3d(sample, sample_size)
+	assert_eq(rules.get_tile_frequencies(), PackedInt64Array([8, 8]))
+
+	var problem = WFC3DProblemNative.new()
+	problem.initialize(rules, Vector3i(0, 0, 0), Vector3i(4, 3, 6))
+	assert_eq(problem.get_cell_count(), 72)
+	assert_eq(problem.id_to_coord(problem.coord_to_id(Vector3i(3, 2, 5))), Vector3i(3, 2, 5))
+	assert_eq(problem.get_ac4_binary_constraints().size(), 6)
+
+	var native_solver = WFCSolverNative.new()
+	native_solver.initialize(problem, WFCSolverSettingsNative.new())
+	var solutions = native_solver.solve().get_cell_solution_or_entropy()
+
+	for z in range(6):
+		var layer_tile = solutions[problem.coord_to_id(Vector3i(0, 0, z))]
+		assert_true(layer_tile == 0 or layer_tile == 1)
+		for y in range(3):
+			for x in range(4):
+				assert_eq(solutions[problem.coord_to_id(Vector3i(x, y, z))], layer_tile)
+		if z > 0:
+			assert_ne(solutions[problem.coord_to_id(Vector3i(0, 0, z - 1))], layer_tile)
+
+	# With any tile allowed anywhere a decision affects one step, so the problem splits
+	# into slabs across the thinnest cross-section
+	var free_rules = WFCRules3DNative.new()
+	free_rules.initialize_3d(2, free_rules.axes_3d)
+	_allow_all_rules(free_rules, 2, 3)
+	assert_eq(free_rules.get_influence_range_3d(), Vector3i(1, 1, 1))
+
+	var big = WFC3DProblemNative.new()
+	big.initialize(free_rules, Vector3i(0, 0, 0), Vector3i(4, 4, 64))
+	var sub_problems = big.split(4)
+	assert_gt(sub_problems.size(), 2)
+	assert_eq(sub_problems[1].get_dependencies(), PackedInt64Array([0, 2]))
+	assert_eq(sub_problems[0].get_problem().get_size().x, 4)
+
+	var grid_map = GridMap.new()
+	var written = problem.write_to_grid_map(grid_map, solutions, PackedInt32Array([-1, 7]))
+	assert_eq(written, 36)
+	assert_eq(grid_map.get_used_cells().size(), 36)
+	grid_map.free()
+
+
+func test_native_hex_problem_uses_parity_aware_neighbours():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# Three-colouring of a hex map with odd rows shifted, learned in hex directions
+	var sample_rect = Rect2i(0, 0, 9, 6)
+	var sample = PackedInt32Array()
+	for y in range(sample_rect.size.y):
+		for x in range(sample_rect.size.x):
+			sample.append(posmod(x - (y - (y & 1)) / 2 - y, 3))
+
+	var axes: Array[Vector2i] = [Vector2i(1, 0), Vector2i(0, 1), Vector2i(-1, 1)]
+	var rules = WFCRules2DNative.new()
+	rules.initialize(3, axes)
+	rules.learn_from_hex_grid(sample, sample_rect, WFC2DHexProblemNative.OFFSET_AXIS_HORIZONTAL, 0)
+	for tile in range(3):
+		for a in range(3):
+			assert_false(rules.get_rule(a, tile, tile))
+
+	var rect = Rect2i(3, 1, 8, 7)
+	var problem = WFC2DHexProblemNative.new()
+	problem.initialize(rules, rect)
+	assert_eq(problem.get_dependencies_range(), Vector2i(1, 1))
+
+	var native_solver = WFCSolverNative.new()
+	native_solver.initialize(problem, WFCSolverSettingsNative.new())
+	var state = native_solver.solve()
+	assert_eq(state.get_unsolved_cells(), 0)
+	var solutions = state.get_cell_solution_or_entropy()
+
+	# SE and SW neighbours depend on whether the row is shifted
+	for y in range(rect.position.y, rect.end.y - 1):
+		var shift = y & 1
+		for x in range(rect.position.x + 1, rect.end.x - 1):
+			var tile = solutions[problem.coord_to_id(Vector2i(x, y) - rect.position)]
+			for offset in [Vector2i(1, 0), Vector2i(shift, 1), Vector2i(shift - 1, 1)]:
+				var other = Vector2i(x, y) + offset - rect.position
+				assert_ne(solutions[problem.coord_to_id(other)], tile)
+
+	# Sub-problems keep the hex layout
+	var free_rules = WFCRules2DNative.new()
+	free_rules.initialize(2, axes)
+	_allow_all_rules(free_rules, 2, 3)
+	var big = WFC2DHexProblemNative.new()
+	big.offset_parity = 1
+	big.initialize(free_rules, Rect2i(0, 0, 64, 8))
+	var sub_problems = big.split(4)
+	assert_gt(sub_problems.size(), 2)
+	assert_true(sub_problems[1].get_problem() is WFC2DHexProblemNative)
+	assert_eq(sub_problems[1].get_problem().offset_parity, 1)
+
+
+func test_native_graph_problem_solves_csr_adjacency():
+	if not _check_native_classes_available():
+		pending("Native classes not available")
+		return
+
+	# Ring of 12 nodes with a chord between 0 and 6, edges listed in both directions
+	var node_count = 12
+	var edges = []
+	for i in range(node_count):
+		edges.append([i, (i + 1) % node_count])
+	edges.append([0, 6])
+
+	var adjacency = []
+	for i in range(node_count):
+		adjacency.append([])
+	for edge in edges:
+		adjacency[edge[0]].append([edge[1], 0])
+		adjacency[edge[1]].append([edge[0], 1])
+
+	var offsets = PackedInt32Array([0])
+	var targets = PackedInt32Array()
+	var relations = PackedInt32Array()
+	for i in range(node_count):
+		for entry in adjacency[i]:
+			targets.append(entry[0])
+			relations.append(entry[1])
+		offsets.append(targets.size())
+
+	# Three-colouring: neighbours never share a tile
+	var axes: Array[Vector2i] = [Vector2i(1, 0)]
+	var rules = WFCRules2DNative.new()
+	rules.initialize(3, axes)
+	for tile1 in range(3):
+		for tile2 in range(3):
+			if tile1 != tile2:
+				rules.set_rule(0, tile1, tile2)
+
+	var problem = WFCGraphProblemNative.new()
+	assert_true(problem.initialize(rules, offsets, targets, relations))
+	assert_eq(problem.get_cell_count(), node_count)
+	assert_eq(problem.get_related_cells(0).size(), 3)
+	# Chord does not fit the ring's one-to-one constraints of either relation
+	assert_eq(problem.get_ac4_binary_constraints().size(), 4)
+
+	var settings = WFCSolverSettingsNative.new()
+	settings.allow_backtracking = true
+	var native_solver = WFCSolverNative.new()
+	native_solver.initialize(problem, settings)
+	assert_true(native_solver.ac4_enabled)
+	var state = native_solver.solve()
+	assert_eq(state.get_unsolved_cells(), 0)
+	var solutions = state.get_cell_solution_or_entropy()
+	for edge in edges:
+		assert_ne(solutions[edge[0]], solutions[edge[1]])
+
+	# An empty precondition domain fails its node instead of being ignored
+	var empty_domain = WFCBitSetNative.new()
+	empty_domain.initialize(3, false)
+	problem.set_precondition_domain(3, empty_domain)
+	var no_backtracking = WFCSolverSettingsNative.new()
+	no_backtracking.allow_backtracking = false
+	var failing_solver = WFCSolverNative.new()
+	failing_solver.initialize(problem, no_backtracking)
+	assert_engine_error("Precondition yielded an empty domain at node 3")
+	var failed_solutions = failing_solver.get_current_state().get_cell_solution_or_entropy()
+	assert_eq(failed_solutions[3], WFCSolverStateNative.CELL_SOLUTION_FAILED)
+	problem.clear_preconditions()
+
+	# A hub with 40 neighbours would need a constraint per neighbour, so AC3 is used
+	var star_offsets = PackedInt32Array([0])
+	var star_targets = PackedInt32Array()
+	var star_relations = PackedInt32Array()
+	for leaf in range(1, 41):
+		star_targets.append(leaf)
+		star_relations.append(0)
+	star_offsets.append(star_targets.size())
+	for leaf in range(1, 41):
+		star_targets.append(0)
+		star_relations.append(1)
+		star_offsets.append(star_targets.size())
+
+	var star = WFCGraphProblemNative.new()
+	assert_true(star.initialize(rules, star_offsets, star_targets, star_relations))
+	assert_false(star.supports_ac4())
+	var star_solver = WFCSolverNative.new()
+	star_solver.initialize(star, settings)
+	assert_false(star_solver.ac4_enabled)
+	var star_solutions = star_solver.solve().get_cell_solution_or_entropy()
+	for leaf in range(1, 41):
+		assert_ne(star_solutions[leaf], star_solutions[0])
+
+	# Bands of a long path cover every node once when merged
+	var free_rules = WFCRules2DNative.new()
+	free_rules.initialize(2, axes)
+	_allow_all_rules(free_rules, 2, 1)
+
+	var path_offsets = PackedInt32Array([0])
+	var path_targets = PackedInt32Array()
+	var path_relations = PackedInt32Array()
+	for i in range(200):
+		if i > 0:
+			path_targets.append(i - 1)
+			path_relations.append(1)
+		if i < 199:
+			path_targets.append(i + 1)
+			path_relations.append(0)
+		path_offsets.append(path_targets.size())
+
+	var big = WFCGraphProblemNative.new()
+	assert_true(big.initialize(free_rules, path_offsets, path_targets, path_relations))
+	var sub_problems = big.split(4)
+	assert_gt(sub_problems.size(), 2)
+	assert_eq(sub_problems[1].get_dependencies(), PackedInt64Array([0, 2]))
+
+	var merged = PackedInt64Array()
+	merged.resize(200)
+	merged.fill(-1)
+	for sub in sub_problems:
+		var sub_problem = sub.get_problem()
+		var ones = PackedInt64Array()
+		ones.resize(sub_problem.get_node_count())
+		ones.fill(1)
+		merged = sub_problem.write_solutions_to(merged, ones)
+	assert_false(merged.has(-1))